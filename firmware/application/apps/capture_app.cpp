@@ -42,6 +42,7 @@ CaptureAppView::CaptureAppView(NavigationView& nav) {
 		&field_lna,
 		&field_vga,
 		&option_bandwidth,
+		&option_format,
 		&record_view,
 		&waterfall,
 	});
@@ -82,6 +83,11 @@ CaptureAppView::CaptureAppView(NavigationView& nav) {
 	};
 	
 	option_bandwidth.set_selected_index(7);		// 500k
+
+	option_format.on_change = [this](size_t, OptionsField::value_t v) {
+		record_view.set_file_type(static_cast<RecordView::FileType>(v));
+	};
+	option_format.set_selected_index(0);		// C16
 	
 	receiver_model.set_modulation(ReceiverModel::Mode::Capture);
 	receiver_model.set_baseband_bandwidth(baseband_bandwidth);
@@ -54,6 +54,7 @@ private:
 
 	Labels labels {
 		{ { 0 * 8, 1 * 16 }, "Rate:", Color::light_grey() },
+		{ { 12 * 8, 1 * 16 }, "Format:", Color::light_grey() },
 	};
 	
 	RSSI rssi {
@@ -99,6 +100,16 @@ private:
 		}
 	};
 	
+	OptionsField option_format {
+		{ 20 * 8, 1 * 16 },
+		4,
+		{
+			{ "C16 ", RecordView::FileType::RawS16 },
+			{ "C8  ", RecordView::FileType::RawS8 },
+			{ "BFP4", RecordView::FileType::RawBFP4 }
+		}
+	};
+
 	RecordView record_view {
 		{ 0 * 8, 2 * 16, 30 * 8, 1 * 16 },
 		u"BBD_????", RecordView::FileType::RawS16, 16384, 3
@@ -61,6 +61,10 @@ struct ERTKey {
 	}
 };
 
+inline uint32_t recent_entries_hash(const ERTKey& key) {
+	return recent_entries_hash(key.id) ^ (key.commodity_type * 31);
+}
+
 struct ERTRecentEntry {
 	using Key = ERTKey;
 
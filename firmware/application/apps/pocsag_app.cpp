@@ -69,11 +69,11 @@ POCSAGAppView::POCSAGAppView(NavigationView& nav) {
 		&field_lna,
 		&field_vga,
 		&field_frequency,
-		&options_bitrate,
 		&options_phase,
 		&check_log,
 		&check_ignore,
 		&sym_ignore,
+		&text_stats,
 		&console
 	});
 	
@@ -100,14 +100,10 @@ POCSAGAppView::POCSAGAppView(NavigationView& nav) {
 		logging = v;
 	};
 	
-	options_bitrate.on_change = [this](size_t, OptionsField::value_t v) {
-		on_config_changed(v, options_phase.selected_index_value());
-	};
-	options_bitrate.set_selected_index(1);	// 1200bps
-
 	options_phase.on_change = [this](size_t, OptionsField::value_t v) {
-		on_config_changed(options_bitrate.selected_index_value(),v);
+		on_config_changed(v);
 	};
+	on_config_changed(options_phase.selected_index_value());
 
 	check_ignore.set_value(ignore);
 	check_ignore.on_select = [this](Checkbox&, bool v) {
@@ -144,6 +140,8 @@ void POCSAGAppView::set_parent_rect(const Rect new_parent_rect) {
 
 void POCSAGAppView::on_packet(const POCSAGPacketMessage * message) {
 	std::string alphanum_text = "";
+	const auto index = pocsag::bitrate_index(message->packet.bitrate());
+	auto& pocsag_state = pocsag_states[index];
 	
 	if (message->packet.flag() != NORMAL)
 		console.writeln("\n\x1B\x0CRC ERROR: " + pocsag::flag_str(message->packet.flag()));
@@ -178,14 +176,14 @@ void POCSAGAppView::on_packet(const POCSAGPacketMessage * message) {
 													" Address only");
 			}
 			
-			last_address = pocsag_state.address;
+			last_address[index] = pocsag_state.address;
 		} else if (pocsag_state.out_type == MESSAGE) {
-			if (pocsag_state.address != last_address) {
+			if (pocsag_state.address != last_address[index]) {
 				// New message
 				console.writeln(console_info);
 				console.write(pocsag_state.output);
 				
-				last_address = pocsag_state.address;
+				last_address[index] = pocsag_state.address;
 			} else {
 				// Message continues...
 				console.write(pocsag_state.output);
@@ -203,8 +201,20 @@ void POCSAGAppView::on_packet(const POCSAGPacketMessage * message) {
 		logger->log_raw_data(message->packet, target_frequency());
 }
 
-void POCSAGAppView::on_config_changed(const uint32_t new_bitrate, bool new_phase) {
-	baseband::set_pocsag(pocsag_bitrates[new_bitrate], new_phase);
+void POCSAGAppView::on_statistics(const pocsag::POCSAGStatistics& statistics) {
+	std::string stats = "ECC";
+	
+	for (size_t c = 0; c < 3; c++) {
+		stats += " " + to_string_dec_uint(pocsag_bitrates[c]) + ":" +
+				to_string_dec_uint(statistics.corrected[c]) + "/" +
+				to_string_dec_uint(statistics.uncorrectable[c]);
+	}
+	
+	text_stats.set(stats);
+}
+
+void POCSAGAppView::on_config_changed(bool new_phase) {
+	baseband::set_pocsag(new_phase);
 }
 
 void POCSAGAppView::set_target_frequency(const uint32_t new_value) {
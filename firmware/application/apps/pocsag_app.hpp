@@ -63,8 +63,9 @@ private:
 
 	bool logging { true };
 	bool ignore { false };
-	uint32_t last_address = 0xFFFFFFFF;
-	pocsag::POCSAGState pocsag_state { };
+	// Batches of each bit rate are decoded separately, as they may interleave
+	std::array<uint32_t, 3> last_address { { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF } };
+	std::array<pocsag::POCSAGState, 3> pocsag_states { };
 
 	RFAmpField field_rf_amp {
 		{ 13 * 8, 0 * 16 }
@@ -85,15 +86,6 @@ private:
 	FrequencyField field_frequency {
 		{ 0 * 8, 0 * 8 },
 	};
-	OptionsField options_bitrate {
-		{ 12 * 8, 21 },
-		7,
-		{
-			{ "512bps ", 0 },
-			{ "1200bps", 1 },
-			{ "2400bps", 2 }
-		}
-	};
 	OptionsField options_phase {
 		{ 6 * 8, 21 },
 		1,
@@ -121,8 +113,13 @@ private:
 		SymField::SYMFIELD_DEC
 	};
 
+	Text text_stats {
+		{ 0 * 8, 4 * 16, 30 * 8, 16 },
+		"ECC fixed/bad:"
+	};
+
 	Console console {
-		{ 0, 4 * 16, 240, 240 }
+		{ 0, 5 * 16, 240, 224 }
 	};
 
 	std::unique_ptr<POCSAGLogger> logger { };
@@ -133,7 +130,9 @@ private:
 
 	void on_packet(const POCSAGPacketMessage * message);
 
-	void on_config_changed(const uint32_t new_bitrate, const bool phase);
+	void on_statistics(const pocsag::POCSAGStatistics& statistics);
+
+	void on_config_changed(const bool phase);
 
 	uint32_t target_frequency() const;
 	void set_target_frequency(const uint32_t new_value);
@@ -145,6 +144,14 @@ private:
 			this->on_packet(message);
 		}
 	};
+
+	MessageHandlerRegistration message_handler_statistics {
+		Message::ID::POCSAGStatistics,
+		[this](Message* const p) {
+			const auto message = static_cast<const POCSAGStatisticsMessage*>(p);
+			this->on_statistics(message->statistics);
+		}
+	};
 };
 
 } /* namespace ui */
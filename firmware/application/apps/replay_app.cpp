@@ -30,6 +30,8 @@
 #include "portapack.hpp"
 #include "portapack_persistent_memory.hpp"
 
+#include <algorithm>
+
 using namespace portapack;
 
 namespace ui {
@@ -50,6 +52,16 @@ void ReplayAppView::on_file_changed(std::filesystem::path new_file_path) {
 	}
 	
 	file_path = new_file_path;
+
+	auto extension = file_path.extension().string();
+	for (auto &c: extension)
+		c = toupper(c);
+
+	format = IQFormat::C16;
+	for (const auto f : { IQFormat::C8, IQFormat::BFP4 }) {
+		if (extension == iq_format::extension(f))
+			format = f;
+	}
 	
 	// Get original record frequency if available
 	std::filesystem::path info_file_path = file_path;
@@ -79,7 +91,8 @@ void ReplayAppView::on_file_changed(std::filesystem::path new_file_path) {
 	text_sample_rate.set(unit_auto_scale(sample_rate, 3, 0) + "Hz");
 	
 	auto file_size = data_file.size();
-	auto duration = (file_size * 1000) / (2 * 2 * sample_rate);
+	auto samples = file_size / iq_format::block_bytes(format) * iq_format::block_samples(format);
+	auto duration = sample_rate ? (samples * 1000) / sample_rate : 0;
 	
 	progressbar.set_max(file_size);
 	text_filename.set(file_path.filename().string().substr(0, 12));
@@ -88,8 +101,16 @@ void ReplayAppView::on_file_changed(std::filesystem::path new_file_path) {
 	button_play.focus();
 }
 
-void ReplayAppView::on_tx_progress(const uint32_t progress) {
+void ReplayAppView::on_tx_progress(const uint32_t progress, const uint32_t underruns) {
 	progressbar.set_value(progress);
+	text_underruns.set(underruns ? ("U" + to_string_dec_uint(underruns)) : "");
+}
+
+uint32_t ReplayAppView::baseband_rate() const {
+	// Oversample by a whole factor so the interpolator needs few phases.
+	// Captures (500kHz and under) keep the usual 8x.
+	const uint32_t factor = std::max<uint32_t>(1, std::min<uint32_t>(8, baseband_rate_max / sample_rate));
+	return sample_rate * factor;
 }
 
 void ReplayAppView::focus() {
@@ -100,6 +121,11 @@ void ReplayAppView::file_error() {
 	nav_.display_modal("Error", "File read error.");
 }
 
+void ReplayAppView::sample_rate_error() {
+	stop(false);
+	nav_.display_modal("Error", "Unsupported sample rate.");
+}
+
 bool ReplayAppView::is_active() const {
 	return (bool)replay_thread;
 }
@@ -113,6 +139,12 @@ void ReplayAppView::toggle() {
 }
 
 void ReplayAppView::start() {
+	// baseband_rate() needs a rate, the .TXT may have given none
+	if (!sample_rate) {
+		sample_rate_error();
+		return;
+	}
+	
 	stop(false);
 
 	std::unique_ptr<stream::Reader> reader;
@@ -127,7 +159,7 @@ void ReplayAppView::start() {
 
 	if( reader ) {
 		button_play.set_bitmap(&bitmap_stop);
-		baseband::set_sample_rate(sample_rate * 8);
+		baseband::set_sample_rate(baseband_rate(), sample_rate);
 		
 		replay_thread = std::make_unique<ReplayThread>(
 			std::move(reader),
@@ -136,13 +168,14 @@ void ReplayAppView::start() {
 			[](uint32_t return_code) {
 				ReplayThreadDoneMessage message { return_code };
 				EventDispatcher::send_message(message);
-			}
+			},
+			format
 		);
 	}
 	
 	radio::enable({
 		receiver_model.tuning_frequency(),
-		sample_rate * 8 ,
+		baseband_rate(),
 		baseband_bandwidth,
 		rf::Direction::Transmit,
 		receiver_model.rf_amp(),
@@ -174,6 +207,7 @@ void ReplayAppView::handle_replay_thread_done(const uint32_t return_code) {
 	}
 	
 	progressbar.set_value(0);
+	text_underruns.set("");
 }
 
 ReplayAppView::ReplayAppView(
@@ -189,6 +223,7 @@ ReplayAppView::ReplayAppView(
 		&text_sample_rate,
 		&text_duration,
 		&progressbar,
+		&text_underruns,
 		&field_frequency,
 		&field_lna,
 		&field_rf_amp,
@@ -218,7 +253,7 @@ ReplayAppView::ReplayAppView(
 	};
 	
 	button_open.on_select = [this, &nav](Button&) {
-		auto open_view = nav.push<FileLoadView>(".C16");
+		auto open_view = nav.push<FileLoadView>(".C16|.C8|.CBF");
 		open_view->on_changed = [this](std::filesystem::path new_file_path) {
 			on_file_changed(new_file_path);
 		};
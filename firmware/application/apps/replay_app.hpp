@@ -51,16 +51,19 @@ private:
 	static constexpr ui::Dim header_height = 3 * 16;
 	
 	uint32_t sample_rate = 0;
+	static constexpr uint32_t baseband_rate_max = 4000000;
+	IQFormat format { IQFormat::C16 };
 	static constexpr uint32_t baseband_bandwidth = 2500000;
 	const size_t read_size { 16384 };
 	const size_t buffer_count { 3 };
 
 	void on_file_changed(std::filesystem::path new_file_path);
 	void on_target_frequency_changed(rf::Frequency f);
-	void on_tx_progress(const uint32_t progress);
+	void on_tx_progress(const uint32_t progress, const uint32_t underruns);
 	
 	void set_target_frequency(const rf::Frequency new_value);
 	rf::Frequency target_frequency() const;
+	uint32_t baseband_rate() const;
 
 	void toggle();
 	void start();
@@ -69,6 +72,7 @@ private:
 	void set_ready();
 	void handle_replay_thread_done(const uint32_t return_code);
 	void file_error();
+	void sample_rate_error();
 
 	std::filesystem::path file_path { };
 	std::unique_ptr<ReplayThread> replay_thread { };
@@ -97,7 +101,11 @@ private:
 		"-"
 	};
 	ProgressBar progressbar {
-		{ 18 * 8, 1 * 16, 12 * 8, 16 }
+		{ 18 * 8, 1 * 16, 7 * 8, 16 }
+	};
+	Text text_underruns {
+		{ 26 * 8, 1 * 16, 4 * 8, 16 },
+		""
 	};
 	
 	FrequencyField field_frequency {
@@ -146,7 +154,10 @@ private:
 		Message::ID::TXProgress,
 		[this](const Message* const p) {
 			const auto message = *reinterpret_cast<const TXProgressMessage*>(p);
-			this->on_tx_progress(message.progress);
+			if (message.error)
+				this->sample_rate_error();
+			else
+				this->on_tx_progress(message.progress, message.underruns);
 		}
 	};
 };
@@ -20,7 +20,8 @@
  * Boston, MA 02110-1301, USA.
  */
 
-// To prepare samples: for f in ./*.wav; do sox "$f" -r 48000 -c 1 -b8 --norm "conv/$f"; done
+// To prepare samples: for f in ./*.wav; do sox "$f" -r 48000 -c 1 -b16 --norm "conv/$f"; done
+// Mono 8 or 16-bit files at any rate below 192kHz play as is.
 
 #include "soundboard_app.hpp"
 #include "string_format.hpp"
@@ -76,10 +77,17 @@ void SoundBoardView::file_error() {
 	nav_.display_modal("Error", "File read error.");
 }
 
+void SoundBoardView::sample_rate_error() {
+	stop();
+	progressbar.set_value(0);
+	nav_.display_modal("Error", "Unsupported sample rate,\nmust be under 192kHz.");
+}
+
 void SoundBoardView::start_tx(const uint32_t id) {
 	auto reader = std::make_unique<WAVFileReader>();
 	uint32_t tone_key_index = options_tone_key.selected_index();
 	uint32_t sample_rate;
+	uint32_t bits_per_sample;
 	
 	stop();
 
@@ -95,6 +103,7 @@ void SoundBoardView::start_tx(const uint32_t id) {
 	//button_play.set_bitmap(&bitmap_stop);
 	
 	sample_rate = reader->sample_rate();
+	bits_per_sample = reader->bits_per_sample();
 	
 	replay_thread = std::make_unique<ReplayThread>(
 		std::move(reader),
@@ -110,7 +119,9 @@ void SoundBoardView::start_tx(const uint32_t id) {
 		1536000 / 20,		// Update vu-meter at 20Hz
 		transmitter_model.channel_bandwidth(),
 		0,	// Gain is unused
-		TONES_F2D(tone_key_frequency(tone_key_index), 1536000)
+		TONES_F2D(tone_key_frequency(tone_key_index), 1536000),
+		bits_per_sample,
+		options_emphasis.selected_index_value()
 	);
 	baseband::set_sample_rate(sample_rate);
 	
@@ -155,7 +166,7 @@ void SoundBoardView::refresh_list() {
 				if (entry_extension == ".WAV") {
 					
 					if (reader->open(u"/WAV/" + entry.path().native())) {
-						if ((reader->channels() == 1) && (reader->bits_per_sample() == 8)) {
+						if ((reader->channels() == 1) && ((reader->bits_per_sample() == 8) || (reader->bits_per_sample() == 16))) {
 							//sounds[c].ms_duration = reader->ms_duration();
 							//sounds[c].path = u"WAV/" + entry.path().native();
 							file_list.push_back(entry.path());
@@ -207,6 +218,7 @@ SoundBoardView::SoundBoardView(
 		&menu_view,
 		&text_empty,
 		&options_tone_key,
+		&options_emphasis,
 		//&text_title,
 		//&text_duration,
 		&progressbar,
@@ -221,6 +233,7 @@ SoundBoardView::SoundBoardView(
 	
 	tone_keys_populate(options_tone_key);
 	options_tone_key.set_selected_index(0);
+	options_emphasis.set_selected_index(0);
 	
 	check_loop.set_value(false);
 	check_random.set_value(false);
@@ -75,13 +75,15 @@ private:
 	void set_ready();
 	void handle_replay_thread_done(const uint32_t return_code);
 	void file_error();
+	void sample_rate_error();
 	void on_tx_progress(const uint32_t progress);
 	void refresh_list();
 	void on_select_entry();
 	
 	Labels labels {
 		//{ { 0, 20 * 8 + 4 }, "Title:", Color::light_grey() },
-		{ { 0, 23 * 8 }, "Key:", Color::light_grey() }
+		{ { 0, 23 * 8 }, "Key:", Color::light_grey() },
+		{ { 20 * 8, 25 * 8 + 4 }, "Emph:", Color::light_grey() }
 	};
 	
 	MenuView menu_view {
@@ -119,6 +121,16 @@ private:
 		"Random"
 	};
 	
+	OptionsField options_emphasis {
+		{ 26 * 8, 25 * 8 + 4 },
+		4,
+		{
+			{ "off", 0 },
+			{ "50u", 50 },
+			{ "75u", 75 }
+		}
+	};
+	
 	ProgressBar progressbar {
 		{ 0 * 8, 30 * 8 - 4, 30 * 8, 16 }
 	};
@@ -151,7 +163,10 @@ private:
 		Message::ID::TXProgress,
 		[this](const Message* const p) {
 			const auto message = *reinterpret_cast<const TXProgressMessage*>(p);
-			this->on_tx_progress(message.progress);
+			if (message.error)
+				this->sample_rate_error();
+			else
+				this->on_tx_progress(message.progress);
 		}
 	};
 };
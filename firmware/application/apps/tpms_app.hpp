@@ -44,6 +44,14 @@ constexpr bool operator==(const tpms::TransponderID& lhs, const tpms::Transponde
 
 } /* namespace std */
 
+namespace tpms {
+
+inline uint32_t recent_entries_hash(const TransponderID& id) {
+	return ::recent_entries_hash(id.value());
+}
+
+} /* namespace tpms */
+
 struct TPMSRecentEntry {
 	using Key = std::pair<tpms::Reading::Type, tpms::TransponderID>;
 
@@ -115,10 +115,7 @@ ADSBRxDetailsView::ADSBRxDetailsView(
 ) : entry_copy(entry),
 	on_close_(on_close)
 {
-	char file_buffer[32] { 0 };
-	bool found = false;
-	std::string airline_code;
-	size_t c;
+	uint8_t record[Database::record_max] { 0 };
 	
 	add_children({
 		&labels,
@@ -126,6 +123,8 @@ ADSBRxDetailsView::ADSBRxDetailsView(
 		&text_last_seen,
 		&text_airline,
 		&text_country,
+		&text_registration,
+		&text_type,
 		&text_infos,
 		&text_info2,
 		&text_frame_pos_even,
@@ -137,28 +136,15 @@ ADSBRxDetailsView::ADSBRxDetailsView(
 	update(entry_copy);
 
 	// The following won't (shouldn't !) change for a given airborne aircraft
-	// Try getting the airline's name from airlines.db
-	auto result = db_file.open("ADSB/airlines.db");
-	if (!result.is_valid()) {
-		// Search for 3-letter code in 0x0000~0x2000
-		airline_code = entry_copy.callsign.substr(0, 3);
-		c = 0;
-		do {
-			db_file.read(file_buffer, 4);
-			if (!file_buffer[0])
-				break;
-			if (!airline_code.compare(0, 4, file_buffer))
-				found = true;
-			else
-				c++;
-		} while (!found);
+	// Try getting the airline's name from airlines.db (code, name, country)
+	auto db = std::make_unique<Database>();
+	if (!db->open("ADSB/airlines.db").is_valid()) {
+		char airline_code[4] { 0 };
+		entry_copy.callsign.copy(airline_code, 3);
 		
-		if (found) {
-			db_file.seek(0x2000 + (c << 6));
-			db_file.read(file_buffer, 32);
-			text_airline.set(file_buffer);
-			db_file.read(file_buffer, 32);
-			text_country.set(file_buffer);
+		if (db->find(airline_code, record)) {
+			text_airline.set((const char*)&record[4]);
+			text_country.set((const char*)&record[44]);
 		} else {
 			text_airline.set("Unknown");
 			text_country.set("Unknown");
@@ -168,6 +154,18 @@ ADSBRxDetailsView::ADSBRxDetailsView(
 		text_country.set("No airlines.db file");
 	}
 	
+	// Registration and type from icao24.db (big-endian address, registration, type)
+	db = std::make_unique<Database>();
+	if (!db->open("ADSB/icao24.db").is_valid()) {
+		const uint32_t address = entry_copy.ICAO_address;
+		const uint8_t key[4] { 0, (uint8_t)(address >> 16), (uint8_t)(address >> 8), (uint8_t)address };
+		
+		if (db->find(key, record)) {
+			text_registration.set((const char*)&record[4]);
+			text_type.set((const char*)&record[16]);
+		}
+	}
+	
 	text_callsign.set(entry_copy.callsign);
 	
 	button_see_map.on_select = [this, &nav](Button&) {
@@ -203,9 +201,18 @@ void ADSBRxView::on_frame(const ADSBFrameMessage * message) {
 	std::string logentry;
 
 	auto frame = message->frame;
+	bool crc_ok;
+	
+	// Extended squitters have plain parity, so marginal ones can be repaired
+	const auto df = frame.get_DF();
+	if ((df == DF_ADSB) || (df == DF_ADSB_NON_TRANSPONDER))
+		crc_ok = (frame.repair_CRC(ADSB_CRC_REPAIR_BITS) >= 0);
+	else
+		crc_ok = frame.check_CRC();
+	
 	uint32_t ICAO_address = frame.get_ICAO_address();
 
-	if (frame.check_CRC() && frame.get_ICAO_address()) {
+	if (crc_ok && ICAO_address) {
 		rtcGetTime(&RTCD1, &datetime);
 		auto& entry = ::on_packet(recent, ICAO_address);
 		frame.set_rx_timestamp(datetime.minute() * 60 + datetime.second());
@@ -250,13 +257,11 @@ void ADSBRxView::on_frame(const ADSBFrameMessage * message) {
 		}
 		recent_entries_view.set_dirty(); 
 		
-		logger = std::make_unique<ADSBLogger>();
-        if (logger) {
-                logger->append(u"adsb.txt");
-                // will log each frame in format:
-                // 20171103100227 8DADBEEFDEADBEEFDEADBEEFDEADBEEF ICAO:nnnnnn callsign Alt:nnnnnn Latnnn.nn Lonnnn.nn
-				logger->log_str(logentry);
-        }
+		if (logger) {
+			// will log each frame in format:
+			// 20171103100227 8DADBEEFDEADBEEFDEADBEEFDEADBEEF ICAO:nnnnnn callsign Alt:nnnnnn Latnnn.nn Lonnnn.nn
+			logger->log_str(logentry);
+		}
 	}
 }
 
@@ -275,6 +280,13 @@ void ADSBRxView::on_tick_second() {
 	}
 }
 
+void ADSBRxView::on_statistics(const ADSBStatisticsMessage * message) {
+	text_stats.set(
+		"Preambles:" + to_string_dec_uint(message->preambles) +
+		"/s Frames:" + to_string_dec_uint(message->frames) + "/s"
+	);
+}
+
 ADSBRxView::ADSBRxView(NavigationView& nav) {
 	baseband::run_image(portapack::spi_flash::image_tag_adsb_rx);
 	add_children({
@@ -283,7 +295,8 @@ ADSBRxView::ADSBRxView(NavigationView& nav) {
 		&field_vga,
 		&field_rf_amp,
 		&rssi,
-		&recent_entries_view
+		&recent_entries_view,
+		&text_stats
 	});
 	
 	recent_entries_view.set_parent_rect({ 0, 16, 240, 272 });
@@ -301,6 +314,10 @@ ADSBRxView::ADSBRxView(NavigationView& nav) {
 		on_tick_second();
 	};
 	
+	logger = std::make_unique<ADSBLogger>();
+	if (logger)
+		logger->append(u"adsb.txt");
+	
 	baseband::set_adsb();
 	
 	receiver_model.set_tuning_frequency(1090000000);
@@ -27,6 +27,7 @@
 #include "ui_font_fixed_8x16.hpp"
 
 #include "file.hpp"
+#include "database.hpp"
 #include "recent_entries.hpp"
 #include "log_file.hpp"
 #include "adsb.hpp"
@@ -40,6 +41,8 @@ namespace ui {
 #define ADSB_DECAY_B 30
 #define ADSB_DECAY_C 60		// Can be used for removing old entries, RecentEntries already caps to 64
 
+#define ADSB_CRC_REPAIR_BITS 2	// Bit errors fixed in DF17/DF18 frames, 0 to only accept clean frames
+
 struct AircraftRecentEntry {
 	using Key = uint32_t;
 	
@@ -143,13 +146,14 @@ private:
 	std::function<void(void)> on_close_ { };
 	GeoMapView* geomap_view { nullptr };
 	bool send_updates { false };
-	File db_file { };
 	
 	Labels labels {
 		{ { 0 * 8, 1 * 16 }, "Callsign:", Color::light_grey() },
 		{ { 0 * 8, 2 * 16 }, "Last seen:", Color::light_grey() },
 		{ { 0 * 8, 3 * 16 }, "Airline:", Color::light_grey() },
 		{ { 0 * 8, 5 * 16 }, "Country:", Color::light_grey() },
+		{ { 0 * 8, 11 * 16 }, "Reg:", Color::light_grey() },
+		{ { 15 * 8, 11 * 16 }, "Type:", Color::light_grey() },
 		{ { 0 * 8, 12 * 16 }, "Even position frame:", Color::light_grey() },
 		{ { 0 * 8, 14 * 16 }, "Odd position frame:", Color::light_grey() }
 	};
@@ -174,6 +178,16 @@ private:
 		"-"
 	};
 	
+	Text text_registration {
+		{ 4 * 8, 11 * 16, 10 * 8, 16 },
+		"-"
+	};
+	
+	Text text_type {
+		{ 20 * 8, 11 * 16, 10 * 8, 16 },
+		"-"
+	};
+	
 	Text text_infos {
 		{ 0 * 8, 6 * 16, 30 * 8, 16 },
 		"-"
@@ -216,6 +230,7 @@ public:
 private:
 	std::unique_ptr<ADSBLogger> logger { };
 	void on_frame(const ADSBFrameMessage * message);
+	void on_statistics(const ADSBStatisticsMessage * message);
 	void on_tick_second();
 	
 	const RecentEntriesColumns columns { {
@@ -252,6 +267,11 @@ private:
 		{ 20 * 8, 4, 10 * 8, 8 },
 	};
 	
+	Text text_stats {
+		{ 0 * 8, 18 * 16, 30 * 8, 16 },
+		"Preambles:-/s Frames:-/s"
+	};
+	
 	MessageHandlerRegistration message_handler_frame {
 		Message::ID::ADSBFrame,
 		[this](Message* const p) {
@@ -259,6 +279,14 @@ private:
 			this->on_frame(message);
 		}
 	};
+	
+	MessageHandlerRegistration message_handler_stats {
+		Message::ID::ADSBStatistics,
+		[this](Message* const p) {
+			const auto message = static_cast<const ADSBStatisticsMessage*>(p);
+			this->on_statistics(message);
+		}
+	};
 };
 
 } /* namespace ui */
@@ -28,6 +28,9 @@
 #include "string_format.hpp"
 
 #include "audio.hpp"
+#include "baseband_api.hpp"
+
+#include "hackrf_hal.hpp"
 
 #include "ui_sd_card_debug.hpp"
 
@@ -38,6 +41,18 @@ using namespace portapack;
 
 namespace ui {
 
+/* FramePixelsWidget *****************************************************/
+
+void FramePixelsWidget::paint(Painter& painter) {
+	const auto rect = screen_rect();
+	const auto s = style();
+
+	// Read before painting: this pass isn't counted until it finishes
+	const auto pixels = painter.frame_pixels();
+	painter.fill_rectangle(rect, s.background);
+	painter.draw_string(rect.location(), s, to_string_dec_uint(pixels, 6));
+}
+
 /* DebugMemoryView *******************************************************/
 
 DebugMemoryView::DebugMemoryView(NavigationView& nav) {
@@ -49,6 +64,8 @@ DebugMemoryView::DebugMemoryView(NavigationView& nav) {
 		&text_label_m0_heap_fragmented_free_value,
 		&text_label_m0_heap_fragments,
 		&text_label_m0_heap_fragments_value,
+		&text_label_frame_pixels,
+		&frame_pixels,
 		&button_done
 	});
 
@@ -67,6 +84,80 @@ void DebugMemoryView::focus() {
 	button_done.focus();
 }
 
+/* DebugProfileView ******************************************************/
+
+DebugProfileView::DebugProfileView(NavigationView& nav) {
+	add_children({
+		&labels,
+		&options_mode,
+		&text_execute,
+		&text_spectrum,
+		&text_events,
+		&text_budget,
+		&text_overruns,
+		&text_skipped,
+		&button_done
+	});
+
+	options_mode.on_change = [this](size_t, OptionsField::value_t v) {
+		this->set_mode(static_cast<ReceiverModel::Mode>(v));
+	};
+	options_mode.set_by_value(toUType(ReceiverModel::Mode::WidebandFMAudio));
+
+	button_done.on_select = [&nav](Button&){ nav.pop(); };
+}
+
+DebugProfileView::~DebugProfileView() {
+	receiver_model.disable();
+	baseband::shutdown();
+}
+
+void DebugProfileView::focus() {
+	options_mode.focus();
+}
+
+void DebugProfileView::set_mode(const ReceiverModel::Mode mode) {
+	baseband::shutdown();
+
+	portapack::spi_flash::image_tag_t image_tag;
+	switch(mode) {
+	case ReceiverModel::Mode::AMAudio:				image_tag = portapack::spi_flash::image_tag_am_audio;	break;
+	case ReceiverModel::Mode::NarrowbandFMAudio:	image_tag = portapack::spi_flash::image_tag_nfm_audio;	break;
+	case ReceiverModel::Mode::WidebandFMAudio:		image_tag = portapack::spi_flash::image_tag_wfm_audio;	break;
+	default:
+		return;
+	}
+
+	// Run the mode the way the audio app does, spectrum included, so the
+	// figures reflect a realistic load.
+	baseband::run_image(image_tag);
+	receiver_model.set_modulation(mode);
+	receiver_model.set_sampling_rate(3072000);
+	receiver_model.set_baseband_bandwidth(1750000);
+	receiver_model.enable();
+	baseband::spectrum_streaming_start();
+}
+
+static std::string cycles_to_us_string(const uint32_t cycles) {
+	constexpr uint32_t cycles_per_us = hackrf::one::base_m4_clk_f / 1000000;
+	return to_string_dec_uint(cycles / cycles_per_us, 5);
+}
+
+static std::string cycle_statistics_string(const CycleStatistics& statistics) {
+	return cycles_to_us_string(statistics.cycles_min)
+		+ " " + cycles_to_us_string(statistics.cycles_avg)
+		+ " " + cycles_to_us_string(statistics.cycles_max);
+}
+
+void DebugProfileView::on_profile(const BasebandProfile& profile) {
+	text_execute.set(cycle_statistics_string(profile.execute));
+	text_spectrum.set(cycle_statistics_string(profile.spectrum));
+	text_events.set(cycle_statistics_string(profile.events));
+	text_budget.set(cycles_to_us_string(profile.cycles_budget));
+	text_overruns.set(to_string_dec_uint(profile.overruns, 6));
+	text_skipped.set(to_string_dec_uint(profile.buffers_skipped, 6));
+}
+
 /* TemperatureWidget *****************************************************/
 
 void TemperatureWidget::paint(Painter& painter) {
@@ -354,6 +445,7 @@ DebugMenuView::DebugMenuView(NavigationView& nav) {
 	add_items({
 		//{ "..",				ui::Color::light_grey(),&bitmap_icon_previous,	[&nav](){ nav.pop(); } },
 		{ "Memory", 		ui::Color::white(),	&bitmap_icon_soundboard,	[&nav](){ nav.push<DebugMemoryView>(); } },
+		{ "M4 Profile",		ui::Color::white(),	&bitmap_icon_temperature,	[&nav](){ nav.push<DebugProfileView>(); } },
 		//{ "Radio State",	ui::Color::white(),	nullptr,	[&nav](){ nav.push<NotImplementedView>(); } },
 		{ "SD Card",		ui::Color::white(),	&bitmap_icon_file,	[&nav](){ nav.push<SDCardDebugView>(); } },
 		{ "Peripherals",	ui::Color::white(),	&bitmap_icon_debug,	[&nav](){ nav.push<DebugPeripheralsMenuView>(); } },
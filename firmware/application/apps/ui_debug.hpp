@@ -28,6 +28,8 @@
 #include "ui_menu.hpp"
 #include "ui_navigation.hpp"
 
+#include "receiver_model.hpp"
+
 #include "rffc507x.hpp"
 #include "max2837.hpp"
 #include "portapack.hpp"
@@ -37,6 +39,28 @@
 
 namespace ui {
 
+/* Pixels the last paint pass sent to the LCD (Painter::frame_pixels()).
+ * Redraws every frame, so its own 48x16 box is part of the figure.
+ */
+class FramePixelsWidget : public Widget {
+public:
+	explicit FramePixelsWidget(
+		Rect parent_rect
+	) : Widget { parent_rect }
+	{
+	}
+
+	void paint(Painter& painter) override;
+
+private:
+	MessageHandlerRegistration message_handler_frame_sync {
+		Message::ID::DisplayFrameSync,
+		[this](const Message* const) {
+			this->set_dirty();
+		}
+	};
+};
+
 class DebugMemoryView : public View {
 public:
 	DebugMemoryView(NavigationView& nav);
@@ -76,12 +100,94 @@ private:
 		{ 200, 160, 40, 16 },
 	};
 
+	Text text_label_frame_pixels {
+		{ 0, 176, 168, 16 },
+		"LCD Pixels Last Frame",
+	};
+
+	FramePixelsWidget frame_pixels {
+		{ 192, 176, 48, 16 },
+	};
+
 	Button button_done {
 		{ 72, 192, 96, 24 },
 		"Done"
 	};
 };
 
+class DebugProfileView : public View {
+public:
+	DebugProfileView(NavigationView& nav);
+	~DebugProfileView();
+
+	void focus() override;
+
+	std::string title() const override { return "M4 Profile"; };
+
+private:
+	Labels labels {
+		{ { 0 * 8, 1 * 16 }, "Mode:", Color::light_grey() },
+		{ { 9 * 8, 3 * 16 }, "  min   avg   max", Color::light_grey() },
+		{ { 0 * 8, 4 * 16 }, "Execute", Color::light_grey() },
+		{ { 0 * 8, 5 * 16 }, "Spectrum", Color::light_grey() },
+		{ { 0 * 8, 6 * 16 }, "Events", Color::light_grey() },
+		{ { 27 * 8, 3 * 16 }, "us", Color::dark_grey() },
+		{ { 0 * 8, 8 * 16 }, "Block budget:", Color::light_grey() },
+		{ { 20 * 8, 8 * 16 }, "us", Color::dark_grey() },
+		{ { 0 * 8, 9 * 16 }, "Overruns/s:", Color::light_grey() },
+		{ { 0 * 8, 10 * 16 }, "DMA skipped/s:", Color::light_grey() },
+	};
+
+	OptionsField options_mode {
+		{ 6 * 8, 1 * 16 },
+		4,
+		{
+			{ "AM", toUType(ReceiverModel::Mode::AMAudio) },
+			{ "NFM", toUType(ReceiverModel::Mode::NarrowbandFMAudio) },
+			{ "WFM", toUType(ReceiverModel::Mode::WidebandFMAudio) },
+		}
+	};
+
+	Text text_execute {
+		{ 9 * 8, 4 * 16, 18 * 8, 16 },
+	};
+
+	Text text_spectrum {
+		{ 9 * 8, 5 * 16, 18 * 8, 16 },
+	};
+
+	Text text_events {
+		{ 9 * 8, 6 * 16, 18 * 8, 16 },
+	};
+
+	Text text_budget {
+		{ 14 * 8, 8 * 16, 5 * 8, 16 },
+	};
+
+	Text text_overruns {
+		{ 15 * 8, 9 * 16, 6 * 8, 16 },
+	};
+
+	Text text_skipped {
+		{ 15 * 8, 10 * 16, 6 * 8, 16 },
+	};
+
+	Button button_done {
+		{ 72, 264, 96, 24 },
+		"Done"
+	};
+
+	void set_mode(const ReceiverModel::Mode mode);
+	void on_profile(const BasebandProfile& profile);
+
+	MessageHandlerRegistration message_handler_profile {
+		Message::ID::BasebandProfile,
+		[this](const Message* const p) {
+			this->on_profile(static_cast<const BasebandProfileMessage*>(p)->profile);
+		}
+	};
+};
+
 class TemperatureWidget : public Widget {
 public:
 	explicit TemperatureWidget(
@@ -65,23 +65,60 @@ void ScannerThread::set_freq_del(const uint32_t v) {
 	_freq_del = v;
 }
 
+void ScannerThread::set_squelch(const int32_t v) {
+	_squelch = v;
+}
+
 void ScannerThread::change_scanning_direction() {
 	_fwd = !_fwd;
 	chThdSleepMilliseconds(300);	//Give some pause after reversing scanning direction
 
 }
 
+void ScannerThread::on_statistics(const ChannelStatistics& statistics) {
+	_max_db = statistics.max_db;
+	if( thread ) {
+		chEvtSignal(thread, EVT_MASK_STATISTICS);
+	}
+}
+
+uint32_t ScannerThread::channels_per_second() const {
+	return _channels_per_second;
+}
+
 msg_t ScannerThread::static_fn(void* arg) {
 	auto obj = static_cast<ScannerThread*>(arg);
 	obj->run();
 	return 0;
 }
 
+void ScannerThread::wait_tuning_lock() {
+	for(size_t i=0; i<SCAN_LOCK_TIMEOUT_MS; i++) {
+		if( radio::is_tuning_locked() )
+			return;
+		chThdSleepMilliseconds(1);
+	}
+}
+
+bool ScannerThread::wait_statistics() {
+	// The window in flight straddles the retune, so throw it away and use the next one
+	chEvtGetAndClearEvents(EVT_MASK_STATISTICS);
+	for(size_t i=0; i<2; i++) {
+		if( chEvtWaitAnyTimeout(EVT_MASK_STATISTICS, MS2ST(SCAN_STATS_INTERVAL_MS * 10)) == 0 )
+			return false;		//Baseband not (yet) sending stats
+	}
+	return true;
+}
+
 void ScannerThread::run() {
 	if (frequency_list_.size())	{					//IF THERE IS A FREQUENCY LIST ...	
 		RetuneMessage message { };
 		uint32_t frequency_index = frequency_list_.size();
 		bool restart_scan = false;					//Flag whenever scanning is restarting after a pause
+		uint32_t channels = 0;						//Retunes since last rate update
+		systime_t rate_time = chTimeNow();
+		systime_t message_time = rate_time;
+		uint32_t message_freq_lock = 0;
 		while( !chThdShouldTerminate() ) {
 			if (_scanning) {						//Scanning
 				if (_freq_lock == 0) {				//normal scanning (not performing freq_lock)
@@ -97,12 +134,35 @@ void ScannerThread::run() {
 							frequency_index--;
 						}
 						receiver_model.set_tuning_frequency(frequency_list_[frequency_index]);	// Retune
+						wait_tuning_lock();			//Only as long as the synthesizer needs
+						channels++;
 					}
 					else
 						restart_scan=false;			//Effectively skipping first retuning, giving system time
 				} 
-				message.range = frequency_index;	//Inform freq (for coloring purposes also!)
-				EventDispatcher::send_message(message);
+
+				if (wait_statistics()) {			//Minimal dwell: one stats window after the retune
+					if (_max_db > _squelch) {		//Something on the air: extend dwell, verify it is not spureous
+						if (_freq_lock < MAX_FREQ_LOCK)
+							_freq_lock++;
+					} else
+						_freq_lock = 0;
+				}
+
+				const auto now = chTimeNow();
+				if ((now - rate_time) >= MS2ST(1000)) {
+					_channels_per_second = channels * MS2ST(1000) / (now - rate_time);
+					channels = 0;
+					rate_time = now;
+				}
+
+				// No need to redraw the UI for every channel, only when the lock state changes
+				if ((_freq_lock != message_freq_lock) || ((now - message_time) >= MS2ST(50))) {
+					message.range = frequency_index;	//Inform freq (for coloring purposes also!)
+					EventDispatcher::send_message(message);
+					message_freq_lock = _freq_lock;
+					message_time = now;
+				}
 			} 
 			else {									//NOT scanning 									
 				if (_freq_del != 0) {				//There is a frequency to delete
@@ -122,8 +182,10 @@ void ScannerThread::run() {
 				else {
 					restart_scan=true;					//Flag the need for skipping a cycle when restarting scan
 				}
+				channels = 0;
+				rate_time = chTimeNow();
+				chThdSleepMilliseconds(50);
 			}
-			chThdSleepMilliseconds(50);				//Needed to (eventually) stabilize the receiver into new freq
 		}
 	}
 }
@@ -132,19 +194,24 @@ void ScannerView::handle_retune(uint32_t i) {
 	switch (scan_thread->is_freq_lock())
 	{
 	case 0:										//NO FREQ LOCK, ONGOING STANDARD SCANNING
-		text_cycle.set( to_string_dec_uint(i + 1,3) );
-		current_index = i;		//since it is an ongoing scan, this is a new index
-		if (description_list[current_index].size() > 0) desc_cycle.set( description_list[current_index] );	//Show new description	
+		big_display.set_style(&style_grey);		//Back to grey color, in case a lock was just dropped
+		text_rate.set( to_string_dec_uint(scan_thread->channels_per_second(), 3) + "ch/s" );
 		break;
 	case 1:										//STARTING LOCK FREQ
 		big_display.set_style(&style_yellow);
 		break;
-	case MAX_FREQ_LOCK:							//FREQ IS STRONG: GREEN and scanner will pause when on_statistics_update()
+	case MAX_FREQ_LOCK:							//FREQ IS STRONG: GREEN and scanner pauses
 		big_display.set_style(&style_green);
+		scan_pause();
 		break;
 	default:	//freq lock is checking the signal, do not update display
 		return;
 	}
+	// The thread only reports lock changes and every 50ms, so the lock may be on
+	// a channel this view never saw: take the index whatever the lock state
+	current_index = i;
+	text_cycle.set( to_string_dec_uint(i + 1,3) );
+	if (description_list[current_index].size() > 0) desc_cycle.set( description_list[current_index] );	//Show new description	
 	big_display.set(frequency_list[current_index]);	//UPDATE the big Freq after 0, 1 or MAX_FREQ_LOCK (at least, for color synching)
 }
 
@@ -185,6 +252,7 @@ ScannerView::ScannerView(
 		&rssi,
 		&text_cycle,
 		&text_max,
+		&text_rate,
 		&desc_cycle,
 		&big_display,
 		&button_manual_start,
@@ -251,8 +319,10 @@ ScannerView::ScannerView(
 
 	button_remove.on_select = [this](Button&) {
 		if (frequency_list.size() > current_index) {
-			if (scan_thread->is_scanning())			//STOP Scanning if necessary
+			if (scan_thread->is_scanning()) {		//STOP Scanning if necessary
 				scan_thread->set_scanning(false);
+				pause_time = chTimeNow();
+			}
 			scan_thread->set_freq_del(frequency_list[current_index]);
 			description_list.erase(description_list.begin() + current_index);
 			frequency_list.erase(frequency_list.begin() + current_index);
@@ -354,14 +424,21 @@ ScannerView::ScannerView(
 
 	//PRE-CONFIGURATION:
 	field_wait.on_change = [this](int32_t v) {	wait = v;	}; 	field_wait.set_value(5);
-	field_squelch.on_change = [this](int32_t v) {	squelch = v;	}; 	field_squelch.set_value(-10);
+	field_squelch.on_change = [this](int32_t v) {
+		squelch = v;
+		if (scan_thread)
+			scan_thread->set_squelch(v);
+	};
+	field_squelch.set_value(-10);
 	field_volume.set_value((receiver_model.headphone_volume() - audio::headphone::volume_range().max).decibel() + 99);
 	field_volume.on_change = [this](int32_t v) { this->on_headphone_volume_changed(v);	};
 	// LEARN FREQUENCIES
 	std::string scanner_txt = "Scanner";
-	if ( load_freqman_file(scanner_txt, database)  ) {
-		for(auto& entry : database) {									// READ LINE PER LINE
+	if ( load_freqman_index(scanner_txt, database, MAX_DB_ENTRY)  ) {
+		for(auto& entry : database.entries) {							// Sorted by frequency
 			if (frequency_list.size() < MAX_DB_ENTRY) {					//We got space!
+				auto frequency_a = entry.frequency_a();
+				const auto frequency_b = entry.frequency_b();
 				if (entry.type == RANGE)  {								//RANGE	
 					switch (entry.step) {
 					case AM_US:	def_step = 10000;  	break ;
@@ -374,18 +451,18 @@ ScannerView::ScannerView(
 					case N_2:	def_step = 250000; 	break ;
 					case AIRBAND:def_step= 8330;  	break ;
 					}
-					frequency_list.push_back(entry.frequency_a);		//Store starting freq and description
-					description_list.push_back("R:" + to_string_short_freq(entry.frequency_a)
-						+ " >" + to_string_short_freq(entry.frequency_b)
+					frequency_list.push_back(frequency_a);				//Store starting freq and description
+					description_list.push_back("R:" + to_string_short_freq(frequency_a)
+						+ " >" + to_string_short_freq(frequency_b)
 						+ " S:" + to_string_short_freq(def_step));
-					while (frequency_list.size() < MAX_DB_ENTRY && entry.frequency_a <= entry.frequency_b) { //add the rest of the range
-						entry.frequency_a+=def_step;
-						frequency_list.push_back(entry.frequency_a);
+					while (frequency_list.size() < MAX_DB_ENTRY && frequency_a <= frequency_b) { //add the rest of the range
+						frequency_a+=def_step;
+						frequency_list.push_back(frequency_a);
 						description_list.push_back("");				//Token (keep showing the last description)
 					}
 				} else if ( entry.type == SINGLE)  {
-					frequency_list.push_back(entry.frequency_a);
-					description_list.push_back("S: " + entry.description);
+					frequency_list.push_back(frequency_a);
+					description_list.push_back(std::string("S: ") + database.description(entry));
 				}
 				show_max();
 			}
@@ -399,39 +476,20 @@ ScannerView::ScannerView(
 	{
 		desc_cycle.set(" NO SCANNER.TXT FILE ..." );
 	}
+	database = { };		// Everything needed was copied to the lists
 	audio::output::stop();
 	step_mode.set_by_value(def_step); //Impose the default step into the manual step selector
 	start_scan_thread();
 }
 
 void ScannerView::on_statistics_update(const ChannelStatistics& statistics) {
-	if ( !userpause ) 									//Scanning not user-paused
+	if (scan_thread->is_scanning()) {					//The scanner thread decides on dwell and freq lock
+		scan_thread->on_statistics(statistics);
+	} 
+	else if ( !userpause ) 								//Paused on a signal, resume after the wait time
 	{
-		if (timer >= (wait * 10) ) 
-		{
-			timer = 0;
+		if ((chTimeNow() - pause_time) >= S2ST(wait))
 			scan_resume();
-		} 
-		else if (!timer) 
-		{
-			if (statistics.max_db > squelch ) {  		//There is something on the air...(statistics.max_db > -squelch) 
-				if (scan_thread->is_freq_lock() >= MAX_FREQ_LOCK) { //checking time reached
-					scan_pause();
-					timer++;	
-				} else {
-					scan_thread->set_freq_lock( scan_thread->is_freq_lock() + 1 ); //in lock period, still analyzing the signal
-				}
-			} else {									//There is NOTHING on the air
-				if (scan_thread->is_freq_lock() > 0) {	//But are we already in freq_lock ?
-					big_display.set_style(&style_grey);	//Back to grey color
-					scan_thread->set_freq_lock(0); 		//Reset the scanner lock, since there is no signal
-				}				
-			}
-		} 
-		else 	//Ongoing wait time
-		{
-				timer++;
-		}
 	}
 }
 
@@ -439,6 +497,7 @@ void ScannerView::scan_pause() {
 	if (scan_thread->is_scanning()) {
 		scan_thread->set_freq_lock(0); 		//Reset the scanner lock (because user paused, or MAX_FREQ_LOCK reached) for next freq scan	
 		scan_thread->set_scanning(false); // WE STOP SCANNING
+		pause_time = chTimeNow();
 		audio::output::start();
 	}
 }
@@ -451,7 +510,7 @@ void ScannerView::scan_resume() {
 }
 
 void ScannerView::user_resume() {
-	timer = wait * 10;					//Will trigger a scan_resume() on_statistics_update, also advancing to next freq.
+	pause_time = chTimeNow() - S2ST(wait);	//Will trigger a scan_resume() on_statistics_update, also advancing to next freq.
 	button_pause.set_text("PAUSE");		//Show button for pause
 	userpause=false;					//Resume scanning
 }
@@ -475,6 +534,7 @@ size_t ScannerView::change_mode(uint8_t new_mod) { //Before this, do a scan_thre
 		field_bw.set_options(bw);
 
 		baseband::run_image(portapack::spi_flash::image_tag_nfm_audio);
+		baseband::set_channel_stats_interval(SCAN_STATS_INTERVAL_MS);
 		receiver_model.set_modulation(ReceiverModel::Mode::NarrowbandFMAudio);
 		field_bw.set_selected_index(2);
 		receiver_model.set_nbfm_configuration(field_bw.selected_index());
@@ -488,6 +548,7 @@ size_t ScannerView::change_mode(uint8_t new_mod) { //Before this, do a scan_thre
 		field_bw.set_options(bw);
 
 		baseband::run_image(portapack::spi_flash::image_tag_am_audio);
+		baseband::set_channel_stats_interval(SCAN_STATS_INTERVAL_MS);
 		receiver_model.set_modulation(ReceiverModel::Mode::AMAudio);
 		field_bw.set_selected_index(0);
 		receiver_model.set_am_configuration(field_bw.selected_index());
@@ -499,6 +560,7 @@ size_t ScannerView::change_mode(uint8_t new_mod) { //Before this, do a scan_thre
 		field_bw.set_options(bw);
 
 		baseband::run_image(portapack::spi_flash::image_tag_wfm_audio);
+		baseband::set_channel_stats_interval(SCAN_STATS_INTERVAL_MS);
 		receiver_model.set_modulation(ReceiverModel::Mode::WidebandFMAudio);
 		field_bw.set_selected_index(0);
 		receiver_model.set_wfm_configuration(field_bw.selected_index());
@@ -514,6 +576,7 @@ void ScannerView::start_scan_thread() {
 	receiver_model.enable(); 
 	receiver_model.set_squelch_level(0);
 	scan_thread = std::make_unique<ScannerThread>(frequency_list);
+	scan_thread->set_squelch(squelch);
 }
 
 } /* namespace ui */
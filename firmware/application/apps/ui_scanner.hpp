@@ -32,10 +32,13 @@
 #include "baseband_api.hpp"
 #include "string_format.hpp"
 #include "file.hpp"
+#include "radio.hpp"
 
 
 #define MAX_DB_ENTRY 500
-#define MAX_FREQ_LOCK 10 		//50ms cycles scanner locks into freq when signal detected, to verify signal is not spureous
+#define MAX_FREQ_LOCK 20 		//stats windows scanner locks into freq when signal detected, to verify signal is not spureous
+#define SCAN_STATS_INTERVAL_MS 5	//channel stats window while scanning (minimal dwell per frequency)
+#define SCAN_LOCK_TIMEOUT_MS 10		//give up waiting for the synthesizer lock after this
 
 namespace ui {
 
@@ -57,8 +60,13 @@ public:
 
 	void set_freq_del(const uint32_t v);
 
+	void set_squelch(const int32_t v);
+
 	void change_scanning_direction();
 
+	void on_statistics(const ChannelStatistics& statistics);
+	uint32_t channels_per_second() const;
+
 	void stop();
 
 	ScannerThread(const ScannerThread&) = delete;
@@ -67,6 +75,8 @@ public:
 	ScannerThread& operator=(ScannerThread&&) = delete;
 
 private:
+	static constexpr eventmask_t EVT_MASK_STATISTICS = EVENT_MASK(0);
+
 	std::vector<rf::Frequency> frequency_list_ { };
 	Thread* thread { nullptr };
 	
@@ -74,8 +84,13 @@ private:
 	bool _fwd { true };
 	uint32_t _freq_lock { 0 };
 	uint32_t _freq_del { 0 };
+	int32_t _squelch { 0 };
+	int32_t _max_db { -120 };
+	uint32_t _channels_per_second { 0 };
 	static msg_t static_fn(void* arg);
 	void run();
+	void wait_tuning_lock();
+	bool wait_statistics();
 };
 
 class ScannerView : public View {
@@ -133,10 +148,10 @@ private:
 
 	jammer::jammer_range_t frequency_range { false, 0, 0 };  //perfect for manual scan task too...
 	int32_t squelch { 0 };
-	uint32_t timer { 0 };
+	systime_t pause_time { 0 };
 	uint32_t wait { 0 };
 	size_t	def_step { 0 };
-	freqman_db database { };
+	freqman_index database { };
 	uint32_t current_index { 0 };
 	bool userpause { false };
 	
@@ -201,6 +216,10 @@ private:
 	Text text_max {
 		{ 4 * 8, 3 * 16, 18 * 8, 16 },  
 	};
+
+	Text text_rate {
+		{ 23 * 8, 3 * 16, 7 * 8, 16 },  
+	};
 	
 	Text desc_cycle {
 		{0, 4 * 16, 240, 16 },	   
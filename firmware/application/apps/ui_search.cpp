@@ -24,6 +24,7 @@
 
 #include "baseband_api.hpp"
 #include "string_format.hpp"
+#include "radio.hpp"
 
 using namespace portapack;
 
@@ -74,7 +75,7 @@ void SearchView::do_detection() {
 		spectrum_row
 	);
 	
-	mean_power = mean_acc / (SEARCH_BIN_NB_NO_DC * slices_nb);
+	mean_power = mean_acc / (slice_bins * slices_nb);
 	mean_acc = 0;
 	
 	overall_power_max = 0;
@@ -100,7 +101,9 @@ void SearchView::do_detection() {
 			if ((bin_max != locked_bin) || (!locked)) {
 				
 				if (!locked) {
-					resolved_frequency = slices[slice_max].center_frequency + (SEARCH_BIN_WIDTH * (bin_max - 128));
+					// Center of the bin, slices start at center_frequency - SEARCH_SLICE_WIDTH / 2
+					resolved_frequency = slices[slice_max].center_frequency - (SEARCH_SLICE_WIDTH / 2) +
+						(((2 * bin_max + 1) * SEARCH_SLICE_WIDTH) / (2 * slice_bins));
 					
 					if (check_snap.value()) {
 						snap_value = options_snap.selected_index_value();
@@ -169,7 +172,7 @@ void SearchView::do_detection() {
 	// Refresh red tick
 	portapack::display.fill_rectangle({last_tick_pos, 90, 1, 6}, Color::black());
 	if (bin_max > -1) {
-		last_tick_pos = (Coord)(bin_max / slices_nb);
+		last_tick_pos = (Coord)(((slice_max * slice_bins) + bin_max) * 240 / (slice_bins * slices_nb));
 		portapack::display.fill_rectangle({last_tick_pos, 90, 1, 6}, Color::red());
 	}
 }
@@ -177,72 +180,79 @@ void SearchView::do_detection() {
 void SearchView::add_spectrum_pixel(Color color) {
 	// Is avoiding floats really necessary ?
 	bin_skip_acc += bin_skip_frac;
-	if (bin_skip_acc < 0x10000) 
-		return;
+	while (bin_skip_acc >= 0x10000) {
+		bin_skip_acc -= 0x10000;
+		
+		if (pixel_index < 240)
+			spectrum_row[pixel_index++] = color;
+	}
+}
+
+void SearchView::on_sweep_retune(const size_t span) {
+	if (span >= slices_nb)
+		return;		// Range just changed, a new sweep is on its way
+	
+	const auto frequency = slices[span].center_frequency;
+	if (receiver_model.tuning_frequency() != frequency)
+		receiver_model.set_tuning_frequency(frequency);
 	
-	bin_skip_acc -= 0x10000;
+	// Sleep between polls rather than spin, the UI thread is waiting here
+	for (size_t i = 0; (i < SEARCH_LOCK_TIMEOUT_MS) && !radio::is_tuning_locked(); i++)
+		chThdSleepMilliseconds(1);
 	
-	if (pixel_index < 240)
-		spectrum_row[pixel_index++] = color;
+	baseband::sweep_tuned(span);
 }
 
-void SearchView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
-	uint8_t max_power = 0;
-	int16_t max_bin = 0;
+void SearchView::on_sweep_spectrum(const SweepSpectrumMessage& message) {
 	uint8_t power;
-	size_t bin;
 	
-	baseband::spectrum_streaming_stop();
+	if (message.spans != slices_nb)
+		return;
 	
-	// Add pixels to spectrum display and find max power for this slice
-	// Center 12 bins are ignored (DC spike is blanked)
-	// Leftmost and rightmost 2 bins are ignored
-	for (bin = 0; bin < 256; bin++) {
-
-		if ((bin < 2) || (bin > 253) || ((bin >= 122) && (bin < 134))) {
-			power = 0;
-		} else {
-			if (bin < 128)
-				power = spectrum.db[128 + bin];
-			else
-				power = spectrum.db[bin - 128];
-		}
+	if (message.bins_per_span != slice_bins) {
+		slice_bins = message.bins_per_span;
+		bin_skip_frac = (240 << 16) / (slice_bins * slices_nb);
 		
-		add_spectrum_pixel(spectrum_rgb3_lut[power]);
-		
-		mean_acc += power;
-		if (power > max_power) {
-			max_power = power;
-			max_bin = bin;
-		}
+		const uint32_t accuracy = SEARCH_SLICE_WIDTH / slice_bins / 2;
+		text_accuracy.set(to_string_dec_uint(accuracy / 1000) + "." + to_string_dec_uint((accuracy / 100) % 10) + "kHz");
 	}
 	
-	slices[slice_counter].max_power = max_power;
-	slices[slice_counter].max_index = max_bin;
-	
-	if (slices_nb > 1) {
-		// Slice sequence
-		if (slice_counter >= slices_nb) {
-			do_detection();
-			slice_counter = 0;
-		} else
-			slice_counter++;
-		receiver_model.set_tuning_frequency(slices[slice_counter].center_frequency);
-		baseband::set_spectrum(SEARCH_SLICE_WIDTH, 31);	// Clear
-	} else {
-		// Unique slice
-		do_detection();
+	// Add pixels to spectrum display and find max power for each slice
+	// DC spike and band edges are already taken care of by the baseband
+	for (size_t slice = 0; slice < slices_nb; slice++) {
+		const uint8_t* const db = &message.db[slice * slice_bins];
+		uint8_t max_power = 0;
+		int16_t max_bin = 0;
+		
+		for (size_t bin = 0; bin < slice_bins; bin++) {
+			power = db[bin];
+			
+			add_spectrum_pixel(spectrum_rgb3_lut[power]);
+			
+			mean_acc += power;
+			if (power > max_power) {
+				max_power = power;
+				max_bin = bin;
+			}
+		}
+		
+		slices[slice].max_power = max_power;
+		slices[slice].max_index = max_bin;
 	}
 	
-	baseband::spectrum_streaming_start();
+	do_detection();
+}
+
+void SearchView::sweep_start() {
+	baseband::sweep_start(slices_nb, SEARCH_SAMPLE_RATE, SEARCH_SETTLE_BUFFERS, SEARCH_AVERAGES);
 }
 
 void SearchView::on_show() {
-	baseband::spectrum_streaming_start();
+	sweep_start();
 }
 
 void SearchView::on_hide() {
-	baseband::spectrum_streaming_stop();
+	baseband::sweep_stop();
 }
 
 void SearchView::on_range_changed() {
@@ -258,9 +268,9 @@ void SearchView::on_range_changed() {
 		// ex: 100M~115M (15M span):
 		// slices_nb = (115M-100M)/2.5M = 6
 		slices_nb = (search_span + SEARCH_SLICE_WIDTH - 1) / SEARCH_SLICE_WIDTH;
-		if (slices_nb > 32) {
+		if (slices_nb > SEARCH_SLICES_MAX) {
 			text_slices.set("!!");
-			slices_nb = 32;
+			slices_nb = SEARCH_SLICES_MAX;
 		} else {
 			text_slices.set(to_string_dec_uint(slices_nb, 2, ' '));
 		}
@@ -277,15 +287,15 @@ void SearchView::on_range_changed() {
 		}
 	} else {
 		slices[0].center_frequency = (f_max + f_min) / 2;
-		receiver_model.set_tuning_frequency(slices[0].center_frequency);
 
 		slices_nb = 1;
 		text_slices.set(" 1");
 	}
 	
-	bin_skip_frac = 0xF000 / slices_nb;
-
-	slice_counter = 0;
+	slice_bins = 0;		// Set by the first sweep
+	mean_acc = 0;
+	
+	sweep_start();
 }
 
 void SearchView::on_lna_changed(int32_t v_db) {
@@ -356,6 +366,7 @@ SearchView::SearchView(
 		&text_mean,
 		&text_slices,
 		&text_rate,
+		&text_accuracy,
 		&text_infos,
 		&vu_max,
 		&progress_timers,
@@ -365,8 +376,6 @@ SearchView::SearchView(
 		&recent_entries_view
 	});
 	
-	baseband::set_spectrum(SEARCH_SLICE_WIDTH, 31);
-	
 	recent_entries_view.set_parent_rect({ 0, 28 * 8, 240, 12 * 8 });
 	recent_entries_view.on_select = [this, &nav](const SearchRecentEntry& entry) {
 		nav.push<FrequencyKeypadView>(entry.frequency);
@@ -375,6 +384,7 @@ SearchView::SearchView(
 	text_mean.set_style(&style_grey);
 	text_slices.set_style(&style_grey);
 	text_rate.set_style(&style_grey);
+	text_accuracy.set_style(&style_grey);
 	progress_timers.set_style(&style_grey);
 	big_display.set_style(&style_grey);
 	
@@ -425,7 +435,7 @@ SearchView::SearchView(
 	on_range_changed();
 
 	receiver_model.set_modulation(ReceiverModel::Mode::SpectrumAnalysis);
-	receiver_model.set_sampling_rate(SEARCH_SLICE_WIDTH);
+	receiver_model.set_sampling_rate(SEARCH_SAMPLE_RATE);
 	receiver_model.set_baseband_bandwidth(2500000);
 	receiver_model.enable();
 }
@@ -30,10 +30,12 @@
 
 namespace ui {
 
-#define SEARCH_SLICE_WIDTH	2500000					// Search slice bandwidth
-#define SEARCH_BIN_NB			256					// FFT power bins
-#define SEARCH_BIN_NB_NO_DC	(SEARCH_BIN_NB - 16)	// Bins after trimming
-#define SEARCH_BIN_WIDTH		(SEARCH_SLICE_WIDTH / SEARCH_BIN_NB)
+#define SEARCH_SAMPLE_RATE	2500000
+#define SEARCH_SLICE_WIDTH	(SEARCH_SAMPLE_RATE * 3 / 4)	// Usable part of each sweep span
+#define SEARCH_SLICES_MAX		64
+#define SEARCH_SETTLE_BUFFERS	1					// Baseband buffers discarded after each retune
+#define SEARCH_AVERAGES		4					// FFTs averaged per slice
+#define SEARCH_LOCK_TIMEOUT_MS	5					// Give up waiting for PLL lock after this
 
 #define DETECT_DELAY		5	// In 100ms units
 #define RELEASE_DELAY		6
@@ -110,21 +112,19 @@ private:
 		int16_t max_index;
 		uint8_t power;
 		int16_t index;
-	} slices[32];
+	} slices[SEARCH_SLICES_MAX];
 	
 	uint32_t bin_skip_acc { 0 }, bin_skip_frac { };
 	uint32_t pixel_index { 0 };
 	std::array<Color, 240> spectrum_row = { 0 };
-	ChannelSpectrumFIFO* fifo { nullptr };
+	size_t slice_bins { 0 };
 	rf::Frequency f_min { 0 }, f_max { 0 };
 	uint8_t detect_timer { 0 }, release_timer { 0 }, timing_div { 0 };
 	uint8_t overall_power_max { 0 };
 	uint32_t mean_power { 0 }, mean_acc { 0 };
 	uint32_t duration { 0 };
 	uint32_t power_threshold { 80 };	// Todo: Put this in persistent / settings
-	rf::Frequency slice_start { 0 };
 	uint8_t slices_nb { 0 };
-	uint8_t slice_counter { 0 };
 	int16_t last_bin { 0 };
 	uint32_t last_slice { 0 };
 	Coord last_tick_pos { 0 };
@@ -133,8 +133,10 @@ private:
 	uint8_t search_counter { 0 };
 	bool locked { false };
 	
-	void on_channel_spectrum(const ChannelSpectrum& spectrum);
+	void on_sweep_retune(const size_t span);
+	void on_sweep_spectrum(const SweepSpectrumMessage& message);
 	void on_range_changed();
+	void sweep_start();
 	void do_detection();
 	void on_lna_changed(int32_t v_db);
 	void on_vga_changed(int32_t v_db);
@@ -152,9 +154,9 @@ private:
 	Labels labels {
 		{ { 1 * 8, 0 }, "Min:      Max:       LNA VGA", Color::light_grey() },
 		{ { 1 * 8, 4 * 8 }, "Trig:   /255    Mean:   /255", Color::light_grey() },
-		{ { 1 * 8, 6 * 8 }, "Slices:  /32      Rate:   Hz", Color::light_grey() },
+		{ { 1 * 8, 6 * 8 }, "Slices:  /64      Rate:   Hz", Color::light_grey() },
 		{ { 6 * 8, 10 * 8 }, "Timer  Status", Color::light_grey() },
-		{ { 1 * 8, 25 * 8 }, "Accuracy +/-4.9kHz", Color::light_grey() },
+		{ { 1 * 8, 25 * 8 }, "Accuracy +/-", Color::light_grey() },
 		{ { 26 * 8, 25 * 8 }, "MHz", Color::light_grey() }
 	};
 	 
@@ -190,6 +192,10 @@ private:
 		{ 24 * 8, 3 * 16, 3 * 8, 16 },
 		"---"
 	};
+	Text text_accuracy {
+		{ 13 * 8, 25 * 8, 8 * 8, 16 },
+		"---"
+	};
 	
 	VuMeter vu_max {
 		{ 1 * 8, 11 * 8 - 4, 3 * 8, 48 },
@@ -226,22 +232,21 @@ private:
 		0
 	};
 	
-	MessageHandlerRegistration message_handler_spectrum_config {
-		Message::ID::ChannelSpectrumConfig,
+	MessageHandlerRegistration message_handler_sweep_retune {
+		Message::ID::SweepRetune,
+		[this](const Message* const p) {
+			this->on_sweep_retune(static_cast<const SweepRetuneMessage*>(p)->span);
+		}
+	};
+	MessageHandlerRegistration message_handler_sweep_spectrum {
+		Message::ID::SweepSpectrum,
 		[this](const Message* const p) {
-			const auto message = *reinterpret_cast<const ChannelSpectrumConfigMessage*>(p);
-			this->fifo = message.fifo;
+			this->on_sweep_spectrum(*static_cast<const SweepSpectrumMessage*>(p));
 		}
 	};
 	MessageHandlerRegistration message_handler_frame_sync {
 		Message::ID::DisplayFrameSync,
 		[this](const Message* const) {
-			if( this->fifo ) {
-				ChannelSpectrum channel_spectrum;
-				while( fifo->out(channel_spectrum) ) {
-					this->on_channel_spectrum(channel_spectrum);
-				}
-			}
 			this->do_timers();
 		}
 	};
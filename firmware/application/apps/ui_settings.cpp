@@ -309,6 +309,40 @@ void SetAudioView::focus() {
 	field_tone_mix.focus();
 }
 
+SetSpectrumView::SetSpectrumView(NavigationView& nav) {
+	add_children({
+		&labels,
+		&options_window,
+		&options_trace,
+		&options_averages,
+		&checkbox_overlap,
+		&checkbox_level,
+		&button_ok
+	});
+	
+	const auto config = persistent_memory::spectrum_config();
+	options_window.set_by_value(toUType(config.window));
+	options_trace.set_by_value(toUType(config.trace));
+	options_averages.set_by_value(config.averages);
+	checkbox_overlap.set_value(config.overlap);
+	checkbox_level.set_value(persistent_memory::spectrum_level_to_floor());
+	
+	button_ok.on_select = [&nav, this](Button&) {
+		SpectrumConfig config;
+		config.window = static_cast<SpectrumConfig::Window>(options_window.selected_index_value());
+		config.trace = static_cast<SpectrumConfig::Trace>(options_trace.selected_index_value());
+		config.averages = options_averages.selected_index_value();
+		config.overlap = checkbox_overlap.value();
+		persistent_memory::set_spectrum_config(config);
+		persistent_memory::set_spectrum_level_to_floor(checkbox_level.value());
+		nav.pop();
+	};
+}
+
+void SetSpectrumView::focus() {
+	options_window.focus();
+}
+
 /*void ModInfoView::on_show() {
 	if (modules_nb) update_infos(0);
 }
@@ -494,6 +528,7 @@ SettingsMenuView::SettingsMenuView(NavigationView& nav) {
 	add_items({
 		//{ "..", 			  ui::Color::light_grey(), &bitmap_icon_previous,		  [&nav](){ nav.pop(); } },
 		{ "Audio", 			ui::Color::dark_cyan(), &bitmap_icon_speaker,			[&nav](){ nav.push<SetAudioView>(); } },
+		{ "Spectrum",		ui::Color::dark_cyan(), &bitmap_icon_search,			[&nav](){ nav.push<SetSpectrumView>(); } },
 		{ "Radio",			ui::Color::dark_cyan(), &bitmap_icon_options_radio,		[&nav](){ nav.push<SetRadioView>(); } },
 		{ "Interface", 		ui::Color::dark_cyan(), &bitmap_icon_options_ui,		[&nav](){ nav.push<SetUIView>(); } },
 		//{ "SD card modules", ui::Color::dark_cyan(), 								  [&nav](){ nav.push<ModInfoView>(); } },
@@ -27,6 +27,8 @@
 #include "ui_menu.hpp"
 #include "ui_navigation.hpp"
 #include "ff.h"
+#include "message.hpp"
+#include "utility.hpp"
 
 #include <cstdint>
 
@@ -272,6 +274,71 @@ private:
 	};
 };
 
+class SetSpectrumView : public View {
+public:
+	SetSpectrumView(NavigationView& nav);
+	
+	void focus() override;
+	
+	std::string title() const override { return "Spectrum Options"; };
+	
+private:
+	Labels labels {
+		{ { 2 * 8, 3 * 16 }, "Window:", Color::light_grey() },
+		{ { 2 * 8, 5 * 16 }, "Trace:", Color::light_grey() },
+		{ { 2 * 8, 7 * 16 }, "Averages:", Color::light_grey() },
+	};
+	
+	OptionsField options_window {
+		{ 12 * 8, 3 * 16 },
+		15,
+		{
+			{ "None", toUType(SpectrumConfig::Window::None) },
+			{ "Hann", toUType(SpectrumConfig::Window::Hann) },
+			{ "Blackman-Harris", toUType(SpectrumConfig::Window::BlackmanHarris) },
+		}
+	};
+	
+	OptionsField options_trace {
+		{ 12 * 8, 5 * 16 },
+		8,
+		{
+			{ "Average", toUType(SpectrumConfig::Trace::Average) },
+			{ "Max hold", toUType(SpectrumConfig::Trace::MaxHold) },
+			{ "Min hold", toUType(SpectrumConfig::Trace::MinHold) },
+		}
+	};
+	
+	OptionsField options_averages {
+		{ 12 * 8, 7 * 16 },
+		2,
+		{
+			{ " 1", 1 },
+			{ " 2", 2 },
+			{ " 4", 4 },
+			{ " 8", 8 },
+			{ "16", 16 },
+		}
+	};
+	
+	Checkbox checkbox_overlap {
+		{ 2 * 8, 9 * 16 },
+		11,
+		"50% overlap"
+	};
+	
+	Checkbox checkbox_level {
+		{ 2 * 8, 11 * 16 },
+		20,
+		"Follow noise floor"
+	};
+	
+	Button button_ok {
+		{ 2 * 8, 16 * 16, 12 * 8, 32 },
+		"Save"
+	};
+};
+
 /*
 class SetPlayDeadView : public View {
 public:
@@ -177,13 +177,15 @@ void kill_afsk() {
 }
 
 void set_audiotx_config(const uint32_t divider, const float deviation_hz, const float audio_gain,
-					const uint32_t tone_key_delta) {
+					const uint32_t tone_key_delta, const uint32_t bits_per_sample, const uint32_t pre_emphasis_us) {
 	const AudioTXConfigMessage message {
 		divider,
 		deviation_hz,
 		audio_gain,
 		tone_key_delta,
-		(float)persistent_memory::tone_mix() / 100.0f
+		(float)persistent_memory::tone_mix() / 100.0f,
+		bits_per_sample,
+		pre_emphasis_us
 	};
 	send_message(&message);
 }
@@ -225,9 +227,8 @@ void set_fsk_data(const uint32_t stream_length, const uint32_t samples_per_bit,
 	send_message(&message);
 }
 
-void set_pocsag(const pocsag::BitRate bitrate, bool phase) {
+void set_pocsag(bool phase) {
 	const POCSAGConfigureMessage message {
-		bitrate,
 		phase
 	};
 	send_message(&message);
@@ -263,6 +264,23 @@ void set_spectrum(const size_t sampling_rate, const size_t trigger) {
 	send_message(&message);
 }
 
+void sweep_start(const size_t spans, const size_t sampling_rate, const size_t settle_buffers, const size_t averages) {
+	const SweepConfigMessage message {
+		spans, sampling_rate, settle_buffers, averages
+	};
+	send_message(&message);
+}
+
+void sweep_stop() {
+	const SweepConfigMessage message { 0, 0, 0, 0 };
+	send_message(&message);
+}
+
+void sweep_tuned(const size_t span) {
+	const SweepTunedMessage message { span };
+	send_message(&message);
+}
+
 void set_siggen_tone(const uint32_t tone) {
 	const SigGenToneMessage message {
 		TONES_F2D(tone, TONES_SAMPLERATE)
@@ -321,8 +339,18 @@ void spectrum_streaming_stop() {
 	send_message(&message);
 }
 
-void set_sample_rate(const uint32_t sample_rate) {
-	SamplerateConfigMessage message { sample_rate };
+void set_spectrum_config(const SpectrumConfig& config) {
+	const SpectrumConfigMessage message { config };
+	send_message(&message);
+}
+
+void set_sample_rate(const uint32_t sample_rate, const uint32_t source_sample_rate) {
+	SamplerateConfigMessage message { sample_rate, source_sample_rate };
+	send_message(&message);
+}
+
+void set_channel_stats_interval(const uint32_t update_interval_ms) {
+	ChannelStatsConfigMessage message { update_interval_ms };
 	send_message(&message);
 }
 
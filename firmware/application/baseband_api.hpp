@@ -61,7 +61,7 @@ void set_tones_config(const uint32_t bw, const uint32_t pre_silence, const uint1
 void kill_tone();
 void set_sstv_data(const uint8_t vis_code, const uint32_t pixel_duration);
 void set_audiotx_config(const uint32_t divider, const float deviation_hz, const float audio_gain,
-					const uint32_t tone_key_delta);
+					const uint32_t tone_key_delta, const uint32_t bits_per_sample = 8, const uint32_t pre_emphasis_us = 0);
 void set_fifo_data(const int8_t * data);
 void set_pitch_rssi(int32_t avg, bool enabled);
 void set_afsk_data(const uint32_t afsk_samples_per_bit, const uint32_t afsk_phase_inc_mark, const uint32_t afsk_phase_inc_space,
@@ -77,11 +77,14 @@ void set_ook_data(const uint32_t stream_length, const uint32_t samples_per_bit,
 					const uint32_t pause_symbols);
 void set_fsk_data(const uint32_t stream_length, const uint32_t samples_per_bit, const uint32_t shift,
 					const uint32_t progress_notice);
-void set_pocsag(const pocsag::BitRate bitrate, bool phase);
+void set_pocsag(bool phase);
 void set_adsb();
 void set_jammer(const bool run, const jammer::JammerType type, const uint32_t speed);
 void set_rds_data(const uint16_t message_length);
 void set_spectrum(const size_t sampling_rate, const size_t trigger);
+void sweep_start(const size_t spans, const size_t sampling_rate, const size_t settle_buffers, const size_t averages);
+void sweep_stop();
+void sweep_tuned(const size_t span);
 void set_siggen_tone(const uint32_t tone);
 void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t duration);
 void request_beep();
@@ -91,8 +94,10 @@ void shutdown();
 
 void spectrum_streaming_start();
 void spectrum_streaming_stop();
+void set_spectrum_config(const SpectrumConfig& config);
 
-void set_sample_rate(const uint32_t sample_rate);
+void set_sample_rate(const uint32_t sample_rate, const uint32_t source_sample_rate = 0);
+void set_channel_stats_interval(const uint32_t update_interval_ms);
 void capture_start(CaptureConfig* const config);
 void capture_stop();
 void replay_start(ReplayConfig* const config);
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __BUFFER_RUN_H__
+#define __BUFFER_RUN_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+
+/* The baseband's capture buffers are carved consecutively out of one
+ * allocation, and are filled and handed over in order. When the SD card
+ * falls behind and several full buffers are waiting, the ones that sit next
+ * to each other in memory can go out in a single large write, straight from
+ * the shared buffers. This catches up faster than one write per buffer, and
+ * costs nothing when the card keeps up.
+ *
+ * BufferRun collects such a run of up to N buffers from an exchange (get(),
+ * get_prefill(), put(), as BufferExchange provides). A buffer that is ready
+ * but doesn't continue the run is held for the next one.
+ */
+template<typename Buffer, size_t N>
+class BufferRun {
+public:
+	static_assert(N > 0, "BufferRun needs room for at least one buffer");
+
+	/* Waits for a full buffer, then adds any that are ready and follow it. */
+	template<typename Exchange>
+	void take(Exchange& exchange) {
+		run[0] = next ? next : exchange.get();
+		next = nullptr;
+		count_ = 1;
+
+		auto end = this->end();
+		while( count_ < N ) {
+			next = exchange.get_prefill();
+			if( (next == nullptr) || (next->data() != end) ) {
+				break;
+			}
+			end += next->size();
+			run[count_++] = next;
+			next = nullptr;
+		}
+	}
+
+	/* Empties the run's buffers and returns them to the exchange. */
+	template<typename Exchange>
+	void put(Exchange& exchange) {
+		for(size_t i=0; i<count_; i++) {
+			run[i]->empty();
+			exchange.put(run[i]);
+		}
+		count_ = 0;
+	}
+
+	/* Returns the buffer held for the next run, if any, unwritten. */
+	template<typename Exchange>
+	void release(Exchange& exchange) {
+		if( next ) {
+			next->empty();
+			exchange.put(next);
+			next = nullptr;
+		}
+	}
+
+	const uint8_t* data() const {
+		return static_cast<const uint8_t*>(run[0]->data());
+	}
+
+	size_t size() const {
+		return end() - data();
+	}
+
+	size_t count() const {
+		return count_;
+	}
+
+	/* Buffers taken from the exchange and not yet put back. */
+	size_t held() const {
+		return count_ + (next ? 1 : 0);
+	}
+
+private:
+	std::array<Buffer*, N> run { };
+	size_t count_ { 0 };
+	Buffer* next { nullptr };
+
+	uint8_t* end() const {
+		const auto last = run[count_ - 1];
+		return static_cast<uint8_t*>(last->data()) + last->size();
+	}
+};
+
+#endif/*__BUFFER_RUN_H__*/
@@ -23,6 +23,9 @@
 
 #include "baseband_api.hpp"
 #include "buffer_exchange.hpp"
+#include "buffer_run.hpp"
+
+#include <algorithm>
 
 struct BasebandCapture {
 	BasebandCapture(CaptureConfig* const config) {
@@ -41,11 +44,14 @@ CaptureThread::CaptureThread(
 	size_t write_size,
 	size_t buffer_count,
 	std::function<void()> success_callback,
-	std::function<void(File::Error)> error_callback
-) : config { write_size, buffer_count },
+	std::function<void(File::Error)> error_callback,
+	const IQFormat format,
+	const uint64_t reserve_size
+) : config { write_size, buffer_count, format },
 	writer { std::move(writer) },
 	success_callback { std::move(success_callback) },
-	error_callback { std::move(error_callback) }
+	error_callback { std::move(error_callback) },
+	reserve_size { reserve_size }
 {
 	// Need significant stack for FATFS
 	thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO + 10, CaptureThread::static_fn, this);
@@ -62,6 +68,8 @@ CaptureThread::~CaptureThread() {
 msg_t CaptureThread::static_fn(void* arg) {
 	auto obj = static_cast<CaptureThread*>(arg);
 	const auto error = obj->run();
+	// Close here rather than on the UI thread; closing may free reserved space.
+	obj->writer.reset();
 	if( error.is_valid() && obj->error_callback ) {
 		obj->error_callback(error.value());
 	} else {
@@ -73,18 +81,37 @@ msg_t CaptureThread::static_fn(void* arg) {
 }
 
 Optional<File::Error> CaptureThread::run() {
+	/* Reserve before starting the capture: it can take a while on a large
+	 * card, and the baseband would drop buffers meanwhile.
+	 */
+	if( reserve_size ) {
+		const auto space_info = std::filesystem::space(u"");
+		const auto reserve_error = writer->reserve(std::min<uint64_t>(space_info.free, reserve_size));
+		if( reserve_error.is_valid() ) {
+			return reserve_error;
+		}
+	}
+
 	BasebandCapture capture { &config };
 	BufferExchange buffers { &config };
 
+	/* Write adjacent full buffers together when the card falls behind. */
+	BufferRun<StreamBuffer, write_buffers_max> run;
+
 	while( !chThdShouldTerminate() ) {
-		auto buffer = buffers.get();
-		auto write_result = writer->write(buffer->data(), buffer->size());
+		run.take(buffers);
+
+		config.buffers_queued_max = std::max(config.buffers_queued_max, buffers.queued() + run.held());
+
+		auto write_result = writer->write(run.data(), run.size());
 		if( write_result.is_error() ) {
 			return write_result.error();
 		}
-		buffer->empty();
-		buffers.put(buffer);
+
+		run.put(buffers);
 	}
 
+	run.release(buffers);
+
 	return { };
 }
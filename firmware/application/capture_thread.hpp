@@ -32,6 +32,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <utility>
+#include <array>
 
 class CaptureThread {
 public:
@@ -40,7 +41,9 @@ public:
 		size_t write_size,
 		size_t buffer_count,
 		std::function<void()> success_callback,
-		std::function<void(File::Error)> error_callback
+		std::function<void(File::Error)> error_callback,
+		const IQFormat format = IQFormat::C16,
+		const uint64_t reserve_size = 0
 	);
 	~CaptureThread();
 
@@ -54,10 +57,13 @@ public:
 	}
 
 private:
+	static constexpr size_t write_buffers_max = 4;
+
 	CaptureConfig config;
 	std::unique_ptr<stream::Writer> writer;
 	std::function<void()> success_callback;
 	std::function<void(File::Error)> error_callback;
+	const uint64_t reserve_size;
 	Thread* thread { nullptr };
 
 	static msg_t static_fn(void* arg);
@@ -28,9 +28,92 @@ using namespace lpc43xx;
 
 #include "message.hpp"
 #include "baseband_api.hpp"
+#include "lz4_block.hpp"
 
+#include <array>
 #include <cstring>
 
+namespace {
+
+using portapack::spi_flash::chunk_t;
+using portapack::spi_flash::image_tag_t;
+
+/* Tag-to-chunk index, built on the first image load so that switching
+ * images doesn't walk the SPI flash chunk list every time. Images beyond
+ * the index capacity are still found by walking on from the last entry.
+ */
+struct image_index_entry_t {
+	image_tag_t tag { };
+	const chunk_t* chunk { nullptr };
+};
+
+std::array<image_index_entry_t, 48> image_index;
+size_t image_index_count = 0;
+const chunk_t* image_index_rest = nullptr;
+
+/* Image currently held in M4 code RAM. The M4 never writes to its code
+ * region (.data and .bss live in local SRAM 0), so a reload of the same
+ * image into the same region can skip the copy entirely.
+ */
+image_tag_t loaded_tag { };
+uint32_t loaded_base = 0;
+
+void build_image_index() {
+	const chunk_t* chunk = reinterpret_cast<const chunk_t*>(portapack::spi_flash::images.base());
+	while( chunk->tag && (image_index_count < image_index.size()) ) {
+		image_index[image_index_count++] = { chunk->tag, chunk };
+		chunk = chunk->next();
+	}
+	image_index_rest = chunk;
+}
+
+const chunk_t* find_image(const image_tag_t image_tag) {
+	if( !image_index_rest ) {
+		build_image_index();
+	}
+
+	for(size_t i=0; i<image_index_count; i++) {
+		if( image_index[i].tag == image_tag ) {
+			return image_index[i].chunk;
+		}
+	}
+
+	for(const chunk_t* chunk = image_index_rest; chunk->tag; chunk = chunk->next()) {
+		if( chunk->tag == image_tag ) {
+			return chunk;
+		}
+	}
+
+	return nullptr;
+}
+
+bool load_image(const chunk_t* const chunk, const portapack::memory::region_t to) {
+	uint8_t* const dst = reinterpret_cast<uint8_t*>(to.base());
+
+	if( !chunk->compressed() ) {
+		if( chunk->stored_length() > to.size() ) {
+			return false;
+		}
+		std::memcpy(dst, &chunk->data[0], chunk->stored_length());
+		return true;
+	}
+
+	chunk_t::compressed_header_t header;
+	std::memcpy(&header, &chunk->data[0], sizeof(header));
+	if( (header.original_length > to.size()) ||
+		(header.compressed_length > (chunk->stored_length() - sizeof(header))) ) {
+		return false;
+	}
+
+	const auto length = lz4::decompress_block(
+		&chunk->data[sizeof(header)], header.compressed_length,
+		dst, header.original_length
+	);
+	return length == header.original_length;
+}
+
+} /* namespace */
+
 /* TODO: OK, this is cool, but how do I put the M4 to sleep so I can switch to
  * a different image? Other than asking the old image to sleep while the M0
  * makes changes?
@@ -39,26 +122,33 @@ using namespace lpc43xx;
  * cause an exception and effectively halt the M4. But that feels gross.
  */
 void m4_init(const portapack::spi_flash::image_tag_t image_tag, const portapack::memory::region_t to) {
-	const portapack::spi_flash::chunk_t* chunk = reinterpret_cast<const portapack::spi_flash::chunk_t*>(portapack::spi_flash::images.base());
-	while(chunk->tag) {
-		if( chunk->tag == image_tag ) {
-			/* Initialize M4 code RAM */
-			std::memcpy(reinterpret_cast<void*>(to.base()), &chunk->data[0], chunk->length);
-
-			/* M4 core is assumed to be sleeping with interrupts off, so we can mess
-			 * with its address space and RAM without concern.
-			 */
-			LPC_CREG->M4MEMMAP = to.base();
-
-			/* Reset M4 core */
-			LPC_RGU->RESET_CTRL[0] = (1 << 13);
+	const auto chunk = find_image(image_tag);
+	if( !chunk ) {
+		chDbgPanic("NoImg");
+	}
 
-			return;
+	/* Initialize M4 code RAM, unless it already holds this image */
+	if( !(image_tag == loaded_tag) || (to.base() != loaded_base) ) {
+		m4_image_invalidate();
+		if( !load_image(chunk, to) ) {
+			chDbgPanic("BadImg");
 		}
-		chunk = chunk->next();
+		loaded_tag = image_tag;
+		loaded_base = to.base();
 	}
 
-	chDbgPanic("NoImg");
+	/* M4 core is assumed to be sleeping with interrupts off, so we can mess
+	 * with its address space and RAM without concern.
+	 */
+	LPC_CREG->M4MEMMAP = to.base();
+
+	/* Reset M4 core */
+	LPC_RGU->RESET_CTRL[0] = (1 << 13);
+}
+
+void m4_image_invalidate() {
+	loaded_tag = { };
+	loaded_base = 0;
 }
 
 void m4_request_shutdown() {
@@ -30,6 +30,9 @@
 void m4_init(const portapack::spi_flash::image_tag_t image_tag, const portapack::memory::region_t to);
 void m4_request_shutdown();
 
+/* Forget which image is in M4 code RAM; call before writing it directly. */
+void m4_image_invalidate();
+
 void m0_halt();
 
 #endif/*__CORE_CONTROL_H__*/
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2017 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "database.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+Optional<File::Error> Database::open(const std::filesystem::path& path) {
+	sector_number = no_sector;
+	header.record_count = 0;
+	
+	const auto error = file.open(path);
+	if( error.is_valid() ) {
+		return error;
+	}
+	
+	auto result = file.read(&header, sizeof(header));
+	if( result.is_error() ) {
+		return { result.error() };
+	}
+	
+	const auto rs = header.record_size;
+	if( (result.value() != sizeof(header)) || memcmp(header.magic, "PPDB", 4) || (header.version != 1) ||
+		!rs || (rs > record_max) || (rs & (rs - 1)) ||
+		!header.key_size || (header.key_size > key_max) || (header.key_size > rs) ||
+		(header.index_count > index_max) || (header.records_offset % sector_size) ) {
+		header.record_count = 0;
+		return { static_cast<File::Error>(FR_INVALID_OBJECT) };
+	}
+	
+	result = file.read(index.data(), header.index_count * header.key_size);
+	if( result.is_error() ) {
+		header.record_count = 0;
+		return { result.error() };
+	}
+	
+	return { };
+}
+
+const uint8_t* Database::read_record(const uint32_t n) {
+	const uint32_t position = header.records_offset + (n * header.record_size);
+	const uint32_t wanted = position / sector_size;
+	
+	if( wanted != sector_number ) {
+		sector_number = no_sector;
+		if( file.seek(wanted * sector_size).is_error() ) {
+			return nullptr;
+		}
+		// The last sector can be short
+		const auto result = file.read(sector.data(), sector_size);
+		if( result.is_error() || (result.value() < (position % sector_size) + header.record_size) ) {
+			return nullptr;
+		}
+		sector_number = wanted;
+	}
+	
+	return &sector[position % sector_size];
+}
+
+bool Database::find(const void* const key, void* const record) {
+	const size_t key_size = header.key_size;
+	
+	if( !header.record_count || !header.index_count ) {
+		return false;
+	}
+	
+	// Last block whose first key is <= key
+	size_t low = 0;
+	size_t high = header.index_count;
+	while( high - low > 1 ) {
+		const size_t mid = (low + high) / 2;
+		if( memcmp(&index[mid * key_size], key, key_size) <= 0 ) {
+			low = mid;
+		} else {
+			high = mid;
+		}
+	}
+	
+	uint32_t first = low * header.records_per_block;
+	uint32_t last = std::min(first + header.records_per_block, header.record_count);	// Exclusive
+	
+	// Binary search by sectors (records_offset is sector aligned): check the
+	// first and last records of the sector the middle record is in, and only
+	// go record by record in there.
+	const uint32_t per_sector = sector_size / header.record_size;
+	while( first < last ) {
+		const uint32_t mid = (first + last) / 2;
+		const uint32_t sector_start = mid - (mid % per_sector);
+		const uint32_t sector_first = std::max(first, sector_start);
+		const uint32_t sector_last = std::min(last, sector_start + per_sector);	// Exclusive
+		
+		// Both in the same sector, so both pointers stay valid		
+		const auto low_record = read_record(sector_first);
+		const auto high_record = read_record(sector_last - 1);
+		if( !low_record || !high_record ) {
+			return false;
+		}
+		
+		if( memcmp(key, low_record, key_size) < 0 ) {
+			last = sector_first;
+		} else if( memcmp(key, high_record, key_size) > 0 ) {
+			first = sector_last;
+		} else {
+			for(uint32_t n = sector_first; n < sector_last; n++) {
+				const auto p = read_record(n);
+				if( p && !memcmp(key, p, key_size) ) {
+					memcpy(record, p, header.record_size);
+					return true;
+				}
+			}
+			return false;
+		}
+	}
+	
+	return false;
+}
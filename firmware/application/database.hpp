@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2017 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DATABASE_H__
+#define __DATABASE_H__
+
+#include "file.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Sorted, fixed-stride lookup tables (ADSB/airlines.db, ADSB/icao24.db).
+ * Made by tools/generate_airlines.db.py.
+ *
+ * 0x0000	Header
+ * 0x0020	Index: first key of each block of records_per_block records
+ * records_offset (sector aligned)
+ *			Records sorted by key (memcmp order), key first. The record size
+ *			is a power of two so that no record straddles a sector.
+ *
+ * The index is kept in RAM: a lookup finds its block there, then binary
+ * searches the block one sector at a time.
+ */
+class Database {
+public:
+	static constexpr size_t key_max = 8;
+	static constexpr size_t record_max = 128;
+	static constexpr size_t index_max = 256;
+	
+	// Once per Database, File can't be reopened
+	Optional<File::Error> open(const std::filesystem::path& path);
+	
+	// Copies the record (key included) to record, which must hold record_size() bytes
+	bool find(const void* const key, void* const record);
+	
+	size_t record_size() const {
+		return header.record_size;
+	}
+	
+	uint32_t record_count() const {
+		return header.record_count;
+	}
+
+private:
+	static constexpr size_t sector_size = 512;
+	static constexpr uint32_t no_sector = 0xffffffff;
+	
+	struct Header {
+		char magic[4];
+		uint16_t version;
+		uint16_t record_size;
+		uint16_t key_size;
+		uint16_t index_count;
+		uint32_t record_count;
+		uint32_t records_per_block;
+		uint32_t records_offset;
+		uint32_t reserved[2];
+	};
+	
+	static_assert(sizeof(Header) == 32, "Database header layout");
+	
+	File file { };
+	Header header { };
+	std::array<uint8_t, index_max * key_max> index { };
+	std::array<uint8_t, sector_size> sector { };
+	uint32_t sector_number { no_sector };
+	
+	const uint8_t* read_record(const uint32_t n);
+};
+
+#endif/*__DATABASE_H__*/
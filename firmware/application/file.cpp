@@ -115,6 +115,24 @@ Optional<File::Error> File::write_line(const std::string& s) {
 	return { };
 }
 
+Optional<File::Error> File::reserve(const uint64_t size) {
+	const auto result = f_expand(&f, size, 1);
+	if( result == FR_OK ) {
+		return { };
+	} else {
+		return { result };
+	}
+}
+
+Optional<File::Error> File::truncate() {
+	const auto result = f_truncate(&f);
+	if( result == FR_OK ) {
+		return { };
+	} else {
+		return { result };
+	}
+}
+
 Optional<File::Error> File::sync() {
 	const auto result = f_sync(&f);
 	if( result == FR_OK ) {
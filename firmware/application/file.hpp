@@ -340,6 +340,17 @@ public:
 
 	Optional<Error> write_line(const std::string& s);
 
+	/* Allocate a contiguous block of the given size to the file, so long
+	 * captures don't fragment or walk the FAT looking for free clusters.
+	 * File must be empty, and its size becomes the reserved size: truncate()
+	 * it when done. Returns FR_DENIED if there's no contiguous area that big.
+	 * Walks the FAT, so keep it off the UI thread.
+	 */
+	Optional<Error> reserve(const uint64_t size);
+
+	/* Cut the file off at the current read/write position. */
+	Optional<Error> truncate();
+
 	// TODO: Return Result<>.
 	Optional<Error> sync();
 
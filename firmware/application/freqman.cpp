@@ -22,6 +22,7 @@
 //  AD V 1.0 7/6/2020
 #include "freqman.hpp"
 #include <algorithm>
+#include <functional>
 
 std::vector<std::string> get_freqman_files() {
 	std::vector<std::string> file_list;
@@ -35,258 +36,408 @@ std::vector<std::string> get_freqman_files() {
 	return file_list;
 };
 
-bool load_freqman_file(std::string& file_stem, freqman_db &db) {
-	File freqman_file;
-	size_t length, n = 0, file_position = 0;
-	char * pos = nullptr;			
-	char * line_start = nullptr;
-	char * line_end = nullptr;
-	size_t cas  = 20;
-	char test_car = 'X';
-	char hex_car[2];
+#define FREQMAN_LINE_MAX 256
+
+static const char* freqman_field(const char* line, const char* key) {
+	// Fields are comma separated key=value pairs, a key only matches at the
+	// start of the line or right after a comma.
+	const size_t key_length = strlen(key);
+	const char* p = line;
+	while (true) {
+		if (!strncmp(p, key, key_length) && (p[key_length] == '='))
+			return p + key_length + 1;
+		p = strchr(p, ',');
+		if (!p)
+			return nullptr;
+		p++;
+	}
+}
+
+static bool freqman_frequency_valid(const rf::Frequency f) {
+	return (f > 0) && (f <= 7500000000);
+}
+
+/* Parses one line (without its line ending). Errors and comments become
+ * entries too, so the editor can show what is wrong with a file.
+ */
+static freqman_entry parse_freqman_line(const char* const line, const size_t line_number) {
+	freqman_entry entry { 0, 0, "", ERROR, STEP_DEF };
+	const auto prefix = "[" + to_string_dec_uint(line_number) + "]:";
 	
-	std::string description;
-	rf::Frequency frequency_a, frequency_b;
-	char file_data[257];
-	freqman_entry_type type;
-	freqman_entry_step step;
-//	 DEBUG (3,"IN LOAD FREQMAN ");
+	if (!line[0]) {
+		entry.description = prefix + "Empty Line";
+		return entry;
+	}
 	
-	db.clear();
+	for (size_t i = 0; line[i]; i++) {
+		const uint8_t c = line[i];
+		if ((c < 32) || (c > 126)) {
+			const char hex[3] = { "0123456789ABCDEF"[c >> 4], "0123456789ABCDEF"[c & 15], 0 };
+			entry.description = prefix + "CAR:P:" + to_string_dec_uint(i + 1) + "<" + (char)c + "><" + hex + ">";
+			return entry;
+		}
+	}
+	
+	if (strstr(line, "//") || (line[0] == '#')) {
+		entry.type = COMMENT;
+		entry.description = line;
+		return entry;
+	}
+	
+	const char* f = freqman_field(line, "f");
+	const char* a = freqman_field(line, "a");
+	const char* b = freqman_field(line, "b");
+	const char* d = freqman_field(line, "d");
+	const char* s = freqman_field(line, "s");
+	
+	if (!f && !a && !b && !d) {
+		entry.description = prefix + "No Useful Info";
+		return entry;
+	}
+	
+	if (f) {
+		entry.frequency_a = strtoll(f, nullptr, 10);
+		if (!freqman_frequency_valid(entry.frequency_a)) {
+			entry.frequency_a = 0;
+			entry.description = prefix + "F: out of limit";
+			return entry;
+		}
+		entry.type = SINGLE;
+	} else {
+		if (a) {
+			entry.frequency_a = strtoll(a, nullptr, 10);
+			if (!freqman_frequency_valid(entry.frequency_a)) {
+				entry.frequency_a = 0;
+				entry.description = prefix + "A: out of limit";
+				return entry;
+			}
+		}
+		if (b) {
+			entry.frequency_b = strtoll(b, nullptr, 10);
+			if (!freqman_frequency_valid(entry.frequency_b)) {
+				entry.frequency_b = 0;
+				entry.description = prefix + "B: out of limit";
+				return entry;
+			}
+		}
+		if (!a && !b) {
+			entry.description = prefix + "No Freq A: & B:";
+			return entry;
+		} else if (!a) {
+			entry.description = prefix + "No A: but B:";
+			return entry;
+		} else if (!b) {
+			entry.description = prefix + "No B: but A:";
+			return entry;
+		} else if (entry.frequency_a >= entry.frequency_b) {
+			entry.frequency_a = 0;
+			entry.frequency_b = 0;
+			entry.description = prefix + "Freq A: > B:";
+			return entry;
+		}
+		entry.type = RANGE;
+	}
+	
+	// Description runs until the next field
+	if (d) {
+		const size_t length = strcspn(d, ",");
+		if (length == 0) {
+			entry.type = ERROR;
+			entry.description = prefix + "R w/o Description";
+			return entry;
+		} else if (length >= FREQMAN_DESC_MAX_LEN) {
+			entry.type = ERROR;
+			entry.description = prefix + "D too long";
+			return entry;
+		}
+		entry.description = std::string(d, length);
+	} else if (entry.type == RANGE) {
+		entry.type = ERROR;
+		entry.description = prefix + "R w/o Description";
+		return entry;
+	} else {
+		entry.description = "---";
+	}
+	
+	// Step only applies to ranges
+	if ((entry.type == RANGE) && s) {
+		const auto step = strtoll(s, nullptr, 10);
+		if ((step < STEP_DEF) || (step >= ERROR_STEP)) {
+			entry.type = ERROR;
+			entry.step = ERROR_STEP;
+			entry.description = prefix + "Step Err";
+			return entry;
+		}
+		entry.step = (freqman_entry_step)step;
+	}
+	
+	return entry;
+}
+
+/* Reads a frequency file in one pass, calling on_line for each line with the
+ * line ending stripped. Lines longer than FREQMAN_LINE_MAX are truncated.
+ * on_line returns false to stop early.
+ */
+static bool read_freqman_lines(const std::string& file_stem, const std::function<bool(const char*)> on_line) {
+	File freqman_file;
+	char file_data[256];
+	char line[FREQMAN_LINE_MAX + 1];
+	size_t line_length = 0;
 	
 	auto result = freqman_file.open("FREQMAN/" + file_stem + ".TXT");
-	if (result.is_valid()) {	return false; }
+	if (result.is_valid())
+		return false;
 	
-	while (1) {
-		
-		freqman_file.seek(file_position);					// Read a 256 bytes block from file
-		
-		memset(file_data, 0, 257);
-		auto read_size = freqman_file.read(file_data, 256);
+	while (true) {
+		auto read_size = freqman_file.read(file_data, sizeof(file_data));
 		if (read_size.is_error())
 			return false;	// Read error
 		
-		// To get rid of NULL caracter
-		for  (int i = 0; i < read_size.value(); i++) {
-			 if (file_data[i] == 0 ) 
-			 { file_data[i] = 219 ; 
-			//DEBUG (3,"CARACTERE NULL !!!" );
-			 }
+		for (size_t i = 0; i < read_size.value(); i++) {
+			const char c = file_data[i];
+			if (c == '\n') {
+				if (line_length && (line[line_length - 1] == '\r'))
+					line_length--;
+				line[line_length] = 0;
+				line_length = 0;
+				if (!on_line(line))
+					return true;
+			} else if (line_length < FREQMAN_LINE_MAX) {
+				// To get rid of NULL characters
+				line[line_length++] = c ? c : (char)219;
+			}
 		}
 		
-		file_position += 256;
+		if (read_size.value() != sizeof(file_data))
+			break;	// End of file
+	}
+	
+	// Last line without line ending
+	if (line_length) {
+		if (line[line_length - 1] == '\r')
+			line_length--;
+		line[line_length] = 0;
+		on_line(line);
+	}
+	
+	return true;
+}
+
+bool load_freqman_file(std::string& file_stem, freqman_db &db, const size_t max_entries) {
+	size_t n = 0;
+	
+	db.clear();
+	
+	return read_freqman_lines(file_stem, [&db, &n, max_entries](const char* line) {
+		auto entry = parse_freqman_line(line, n + 1);
+		if ((entry.type == RANGE) && (entry.step != STEP_DEF))
+			entry.description += "-" + to_string_dec_uint(entry.step);
+		db.push_back(entry);
+		n++;
 		
-		// Reset line_start to beginning of buffer
-		line_start = file_data;
-		 
-		// Look for complete lines in buffer
-		while ((line_end = strstr(line_start, "\n"))) {  
-//	DEBUG (3,"deb: "  + file_stem + " L: " + to_string_dec_uint(n+1) );	
+		if (n >= max_entries) {
+			db.push_back({ 0, 0, "[" + to_string_dec_uint(n) + "]:" + "Lines >" + to_string_dec_uint(max_entries), ERROR, STEP_DEF });
+			return false;
+		}
+		return true;
+	});
+}
 
-			// Read frequency  / frequencies  		
-			//Init
-			frequency_a = 0;
-			frequency_b = 0;
-			type = ERROR;										// by default   third type
-			cas = 20;   // UNKNOWN (by default)
-			pos = 0 ;
-			step = STEP_DEF;
+// Index //////////////////////////////////////////////////////////////////
 
-			line_start[line_end - line_start] = 0 ;															// Analyze per LINE, not per Buffer 
+#define FREQMAN_INDEX_MAGIC 0x58495146		// "FQIX"
+#define FREQMAN_INDEX_VERSION 2
 
-			// first test
-			if (line_end != line_start )  {    																														// test empty line
-		
-			// second test
-			if ( strstr(line_start, "f=") || strstr(line_start, "a=") || strstr(line_start, "b=") || strstr(line_start, "d=") || strstr(line_start, "//") || strstr(line_start, "#") )  {    	// no useful information 
+struct freqman_index_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t source_size;
+	uint16_t source_date;
+	uint16_t source_time;
+	uint32_t entry_count;
+	uint32_t descriptions_size;
+	uint32_t complete;			// 0 if building stopped at entry_count
+};
 
-			// Test if special caracters      ( ok is > 31 and < 127 or 13) 
+rf::Frequency freqman_index_entry::frequency_a() const {
+	return ((rf::Frequency)(frequency_hi & 15) << 32) | frequency_a_lo;
+}
 
-		// DEBUG (3,"deb while F: "  + file_stem + " L: " + to_string_dec_uint(n+1) + " LINE-start :" + line_start  );
-			
-			int i=0;
-			while( line_start[i] != 0 )
-			 {
-				 test_car = line_start[i];		
-				//description = "Caract:" + to_string_dec_uint(i+1) + "<" + test_car + ">" ;
-				//DEBUG (3, description  );
-				if	(   ((test_car > 31 && test_car < 127) ) || (test_car == 13)     )  		{ i++; continue; }
-				else {
-					cas = 22 ;
-				
-			uint32_t d = test_car & 0xf; 	hex_car[1] = (d > 9) ? (d + 55) : (d + 48);				// CONVERT ASCII/HEW
-					d = (test_car>> 4) & 0xf; 	hex_car[0] = (d > 9) ? (d + 55) : (d + 48);
-					hex_car[2] = 0 ;
-	
-					description = "P:" + to_string_dec_uint(i+1) + "<" + test_car + "><" + hex_car + ">";
-					// DEBUG (3,"DESC= " +description ) ;
-					type = ERROR ;
-					break;
-					}
-			 }
-   
-			// third test     (special caracters)
-			if (cas == 20) {																																				
-				   
-			// fourth test Read comment  // OR #
-			if (	(!strstr(line_start, "//")) &&  (!strstr(line_start, "#")))	{ 	  																	// Comment line
-						
-			// Read Frequency  f=, a= or b=
-				pos = strstr(line_start, "f=");		//by default
-					if (pos) 	{	
-								// test one freq   f= 
-								pos += 2; 
-								frequency_a = strtoll(pos, nullptr, 10);
-								cas = 2;
-								type = SINGLE;
-								if (( frequency_a <= 0) || (frequency_a > 7500000000)) {cas = 12; type = ERROR;} 
-								// freq f:    ok
-								} 
-								else 	{																	// test freq a:  and/or b:
-															
-										pos = strstr(line_start, "a=");
-										if (pos) 	{														// test one freq   a=
-													pos += 2;
-													frequency_a = strtoll(pos, nullptr, 10);
-													cas = 3 ;
-													type = RANGE;											// freq a: ok
-													if (( frequency_a <= 0) || (frequency_a > 7500000000)) {cas = 13 ; type = ERROR ;}
-													}
-													else 	
-													{
-													cas = 7; 												// no freq a:
-													}										
-									pos = strstr(line_start, "b=");
-										if (pos) 	{				// two frequ  a= +  b=
-													pos += 2;
-													frequency_b = strtoll(pos, nullptr, 10);
-													type = RANGE;
-													if (( frequency_b <= 0) || (frequency_b > 7500000000)) {cas = 14 ;type = ERROR ;}
-														else
-														{
-													if ( frequency_a >= frequency_b) {cas = 15 ; type = ERROR ;}	
+rf::Frequency freqman_index_entry::frequency_b() const {
+	return ((rf::Frequency)(frequency_hi >> 4) << 32) | frequency_b_lo;
+}
 
-														}													
-														
-														if (cas == 3) 	{	cas = 4; } 												// freq a: and b:   	
-															else {
-															if ((cas != 13) && (cas != 14 ) && (cas != 15)) { 	cas = 6; type = ERROR ;	}	}				// freq b: but not a:
-																															
-													} 
-													else  											// no freq b:	
-													{	
-													if (cas == 3) 	{
-																	cas = 7;type = ERROR ;						// freq a: but not b:
-																	}			
-																	else 	
-																	{
-																		if (cas != 13) 	{ cas = 10 ;type = ERROR ; }						// not freq a:, not freq b:
-																	} 						
-													}						
-										}
-																				
-			if ((cas == 2 ) || (cas == 4 ) )  {														// if Freq ok
-				// Read description until , or LF
-				pos = strstr(line_start, "d=");
-					if (pos) 	{
-								pos += 2;		
-								length = strcspn(pos, ",\x0A");
-								if (length <  (size_t)FREQMAN_DESC_MAX_LEN ) 	{										//desc ok
-																				description = string(pos, length);
-																				}
-																				else 	
-																				{ 		
-																				cas = 9;type = ERROR ;			// descrip too long			
-																				}
-								if (length == 0 ) 	{		cas = 8;type = ERROR ;		} 							//desc empty
-																				
-								} 	
-								else 	{
-										if (cas == 4)	{
-														cas = 8;type = ERROR ;						// RANGE without DESCRIPTION
-														}    									
-														else	{
-																description = "---";			// no description pour freq a:
-																}							
-										}
-											}	
-// debug
-								else 
-								{
-								description = to_string_dec_uint(cas) + "/" +description ;
-								type = ERROR ;								
-								}
-// Analyze STEP  only for RANGE
-			if  (cas == 4 )  {
-				pos = strstr(line_start, "s=");
-						if (pos) {
-							switch (strtoll(pos + 2, nullptr, 10)) 	{
-							case 0:		step = STEP_DEF  	;  	break ;
-							case 1: 	step = AM_US 		;  	description+= "-" + to_string_dec_uint(step); 	break ;
-							case 2:    	step = AM_EUR		;	description+= "-" + to_string_dec_uint(step); 	break ;																	
-							case 3: 	step = NFM_1 		;  	description+= "-" + to_string_dec_uint(step); 	break ;
-							case 4:  	step = NFM_2		; 	description+= "-" + to_string_dec_uint(step);  	break ;    																
-							case 5: 	step = FM_1 		;  	description+= "-" + to_string_dec_uint(step); 	break ;
-							case 6: 	step = FM_2   		;  	description+= "-" + to_string_dec_uint(step); 	break ;		
-							case 7: 	step = N_1 			;  	description+= "-" + to_string_dec_uint(step); 	break ;
-							case 8: 	step = N_2   		;  	description+= "-" + to_string_dec_uint(step); 	break ;	
-							case 9: 	step = AIRBAND   	;  	description+= "-" + to_string_dec_uint(step); 	break ;							
-							default:	step= ERROR_STEP 	; cas = 16 ;				
-																}
-								}
-							}			
-								
-						} 	else {cas = 21;			type = COMMENT ; }				  //COMMENT		
-					}	else {cas = 22 ;}
-				}	else {cas = 0;}
-			}	else {cas = 11;type = ERROR;}
-// TEST ERRORS
-			switch (cas) {
-				case 0:		description = "[" + to_string_dec_uint(n + 1) + "]:" + "No Useful Info"  ;  break ;
-	//			case 1: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "No Unix EOL (0x0D)"  ;  break ;
-				case 2:    	break ;																	// 	freq f
-				case 3: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "No Freq B:"  ;  break ;
-				case 4:    	break ;    																//     freq a and b
-				case 5: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "No F + D"  ;  break ;
-				case 6: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "No A: but B:"   ;  break ;								//ok
-				case 7: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "No B: but A:"   ;  break ;
-				case 8: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "R w/o Description"   ;  break ;
-				case 9: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "D too long"   ;  break ;
-				case 10: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "No Freq A: & B:"   ;  break ;
-				case 11: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "Empty Line"   ;  break ;
-				case 12: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "F: out of limit"   ;  frequency_a = 0 ; break ;
-				case 13: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "A: out of limit"   ; frequency_a = 0 ; break ;
-				case 14: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "B: out of limit"   ;  frequency_b = 0 ;break ;
-				case 15: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "Freq A: > B:"   ;   frequency_a = 0  ;  frequency_b = 0 ; break ;
-				case 16: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "Step Err"   ;  break ;
-				case 20: 	description = "[" + to_string_dec_uint(n + 1) + "]:" + "UNKNOWN"   ;  break ;
-				case 21:	description = line_start; break ;		 // comment
-				case 22:	description = "[" + to_string_dec_uint(n + 1) + "]:" + "CAR:" + description  ;  break ;				
-				default:	description = "[" + to_string_dec_uint(n + 1) + "]:" + "ERROR" ;
-						}
+static freqman_index_entry make_freqman_index_entry(const freqman_entry& entry, const uint16_t description) {
+	return {
+		(uint32_t)entry.frequency_a,
+		(uint32_t)entry.frequency_b,
+		description,
+		(uint8_t)(((entry.frequency_a >> 32) & 15) | (((entry.frequency_b >> 32) & 15) << 4)),
+		(uint8_t)entry.type,
+		(uint8_t)entry.step
+	};
+}
 
-		  db.push_back({ frequency_a, frequency_b, description, type, step }); 
+static void sort_freqman_index(freqman_index& index) {
+	std::sort(index.entries.begin(), index.entries.end(),
+		[](const freqman_index_entry& l, const freqman_index_entry& r) {
+			return l.frequency_a() < r.frequency_a();
+		});
+}
 
-			n++;  // next line  in the buffer
+// Builds in file order, stopping after max_entries. Descriptions are interned
+// in order of first use, so any first n entries only reference a prefix of them.
+static bool build_freqman_index(std::string& file_stem, freqman_index& index, const size_t max_entries, bool& complete) {
+	// Open addressing table of description offsets, for interning
+	constexpr size_t slots_count = 512;
+	std::vector<uint16_t> slots(slots_count, 0xffff);
+	size_t slots_used = 0;
+	size_t n = 0;
+	
+	index.entries.clear();
+	index.descriptions.clear();
+	
+	const auto intern = [&index, &slots, &slots_used](const std::string& s) -> int32_t {
+		uint32_t hash = 2166136261;		// FNV-1a
+		for (const auto c : s)
+			hash = (hash ^ (uint8_t)c) * 16777619;
 		
-			if ( n >= FREQMAN_MAX_PER_FILE )  
-					{
-						description = "[" + to_string_dec_uint(n ) + "]:" +  "Lines >" +  to_string_dec_uint(FREQMAN_MAX_PER_FILE) ;
-						type = ERROR ;
-						db.push_back({ 0, 0, description, type , step});  			
-					//		DEBUG (3,"OUT load freqman too many LINES");			
-						return true;
-					} 
-											
-			line_start = line_end + 1; 	 // next line  in the same line_start buffer
-			
-		if (line_start - file_data >= 256)  { 	break;	  } // end of buffer  
+		size_t slot = hash & (slots_count - 1);
+		while (slots[slot] != 0xffff) {
+			if (!strcmp(&index.descriptions[slots[slot]], s.c_str()))
+				return slots[slot];
+			slot = (slot + 1) & (slots_count - 1);
 		}
-		if (read_size.value() != 256) {break;	}																				// End of file
+		
+		const size_t offset = index.descriptions.size();
+		if (offset + s.size() + 1 > 0xffff)
+			return -1;
+		index.descriptions.insert(index.descriptions.end(), s.c_str(), s.c_str() + s.size() + 1);
+		
+		// Past 3/4 full, stop sharing rather than probing forever
+		if (slots_used < slots_count * 3 / 4) {
+			slots[slot] = offset;
+			slots_used++;
+		}
+		return offset;
+	};
+	
+	complete = true;
+	const bool ok = read_freqman_lines(file_stem, [&index, &n, &intern, max_entries, &complete](const char* line) {
+		const auto entry = parse_freqman_line(line, ++n);
+		if ((entry.type != SINGLE) && (entry.type != RANGE))
+			return true;
+		
+		if (index.entries.size() >= max_entries) {
+			complete = false;
+			return false;
+		}
+		
+		const auto description = intern(entry.description);
+		if (description < 0) {
+			complete = false;
+			return false;
+		}
+		
+		index.entries.push_back(make_freqman_index_entry(entry, description));
+		return true;
+	});
+	
+	return ok;
+}
+
+// Reads the first entry_count entries of a cached index, and the part of the
+// descriptions they use.
+static bool read_freqman_index(File& index_file, const freqman_index_header& cached, const size_t entry_count, freqman_index& index) {
+	index.entries.resize(entry_count);
+	const auto entries_size = entry_count * sizeof(freqman_index_entry);
+	auto entries_read = index_file.read(index.entries.data(), entries_size);
+	if (entries_read.is_error() || (entries_read.value() != entries_size))
+		return false;
+	
+	size_t last_description = 0;
+	for (const auto& entry : index.entries)
+		last_description = std::max<size_t>(last_description, entry.description);
+	const size_t descriptions_size = std::min<size_t>(cached.descriptions_size, last_description + FREQMAN_DESC_MAX_LEN + 1);
+	if (entry_count && (last_description >= descriptions_size))
+		return false;
+	
+	auto seek_result = index_file.seek(sizeof(cached) + cached.entry_count * sizeof(freqman_index_entry));
+	if (seek_result.is_error())
+		return false;
+	
+	index.descriptions.resize(descriptions_size);
+	auto descriptions_read = index_file.read(index.descriptions.data(), descriptions_size);
+	if (descriptions_read.is_error() || (descriptions_read.value() != descriptions_size))
+		return false;
+	
+	// The last description used must end inside what was read
+	if (entry_count) {
+		const auto end = std::find(index.descriptions.begin() + last_description, index.descriptions.end(), 0);
+		if (end == index.descriptions.end())
+			return false;
+		index.descriptions.resize(end - index.descriptions.begin() + 1);
+	}
+	
+	return true;
+}
+
+bool load_freqman_index(std::string& file_stem, freqman_index& index, const size_t max_entries) {
+	const std::filesystem::path source_path { "FREQMAN/" + file_stem + ".TXT" };
+	const std::filesystem::path index_path { "FREQMAN/" + file_stem + ".IDX" };
+	
+	File source_file;
+	if (source_file.open(source_path).is_valid())
+		return false;
+	
+	const auto source_timestamp = file_created_date(source_path);
+	freqman_index_header header {
+		FREQMAN_INDEX_MAGIC,
+		FREQMAN_INDEX_VERSION,
+		(uint32_t)source_file.size(),
+		source_timestamp.FAT_date,
+		source_timestamp.FAT_time,
+		0, 0, 0
+	};
+	
+	const size_t entry_limit = std::min<size_t>(max_entries, FREQMAN_INDEX_MAX_ENTRIES);
+	
+	// Use the cached index if it was built from this version of the file, and
+	// either covers the whole file or holds at least entry_limit
+	File index_file;
+	if (!index_file.open(index_path).is_valid()) {
+		freqman_index_header cached { };
+		auto read_size = index_file.read(&cached, sizeof(cached));
+		if (!read_size.is_error() && (read_size.value() == sizeof(cached)) &&
+			(cached.magic == header.magic) && (cached.version == header.version) &&
+			(cached.source_size == header.source_size) &&
+			(cached.source_date == header.source_date) && (cached.source_time == header.source_time) &&
+			(cached.entry_count <= FREQMAN_INDEX_MAX_ENTRIES) && (cached.descriptions_size <= 0xffff) &&
+			(cached.complete || (cached.entry_count >= entry_limit))) {
 			
-		// Restart at beginning of last incomplete line		
-	if (line_start != file_data )    {	file_position -= (file_data + 256 - line_start); }
+			if (read_freqman_index(index_file, cached, std::min<size_t>(cached.entry_count, entry_limit), index)) {
+				sort_freqman_index(index);
+				return true;
+			}
+		}
+	}
+	
+	bool complete;
+	if (!build_freqman_index(file_stem, index, entry_limit, complete))
+		return false;
+	
+	// Cache it for next time, not fatal if that fails
+	header.entry_count = index.entries.size();
+	header.descriptions_size = index.descriptions.size();
+	header.complete = complete;
+	File new_index_file;
+	if (!new_index_file.create(index_path).is_valid()) {
+		new_index_file.write(&header, sizeof(header));
+		new_index_file.write(index.entries.data(), index.entries.size() * sizeof(freqman_index_entry));
+		new_index_file.write(index.descriptions.data(), index.descriptions.size());
 	}
+	
+	sort_freqman_index(index);
 	return true;
 }
 
@@ -77,8 +77,39 @@ struct freqman_entry {
 
 using freqman_db = std::vector<freqman_entry>;
 
+#define FREQMAN_INDEX_MAX_ENTRIES 4096
+
+// Packed to 12 bytes, frequencies are 36 bits
+struct freqman_index_entry {
+	uint32_t frequency_a_lo;
+	uint32_t frequency_b_lo;
+	uint16_t description;		// Offset in freqman_index::descriptions
+	uint8_t frequency_hi;		// Bits 32-35 of A (low nibble) and B (high nibble)
+	uint8_t type : 4;			// freqman_entry_type
+	uint8_t step : 4;			// freqman_entry_step
+	
+	rf::Frequency frequency_a() const;
+	rf::Frequency frequency_b() const;
+};
+
+static_assert(sizeof(freqman_index_entry) == 12, "freqman_index_entry not packed");
+
+// Compact read-only copy of a frequency file: the first max_entries SINGLE
+// and RANGE entries, sorted by frequency, with descriptions interned in one
+// buffer.
+// Cached next to the file as FREQMAN/<stem>.IDX and rebuilt when it changes.
+struct freqman_index {
+	std::vector<freqman_index_entry> entries { };
+	std::vector<char> descriptions { };
+	
+	const char* description(const freqman_index_entry& entry) const {
+		return &descriptions[entry.description];
+	}
+};
+
 std::vector<std::string> get_freqman_files();
-bool load_freqman_file(std::string& file_stem, freqman_db& db);
+bool load_freqman_file(std::string& file_stem, freqman_db& db, const size_t max_entries = FREQMAN_MAX_PER_FILE);
+bool load_freqman_index(std::string& file_stem, freqman_index& index, const size_t max_entries = FREQMAN_INDEX_MAX_ENTRIES);
 bool save_freqman_file(std::string& file_stem, freqman_db& db);
 bool create_freqman_file(std::string& file_stem, File& freqman_file);
 std::string freqman_item_string(freqman_entry &item, size_t max_length);
@@ -34,6 +34,10 @@ public:
 class Writer {
 public:
 	virtual File::Result<File::Size> write(const void* const buffer, const File::Size bytes) = 0;
+
+	/* Hint that about this many bytes will be written. Optional. */
+	virtual Optional<File::Error> reserve(const uint64_t) { return { }; }
+
 	virtual ~Writer() = default;
 };
 
@@ -36,3 +36,26 @@ File::Result<File::Size> FileWriter::write(const void* const buffer, const File:
 	}
 	return write_result;
 }
+
+FileWriter::~FileWriter() {
+	/* Give back the reserved space that wasn't written. */
+	if( reserved ) {
+		file.truncate();
+	}
+}
+
+Optional<File::Error> FileWriter::reserve(const uint64_t size) {
+	if( bytes_written ) {
+		return { };
+	}
+
+	/* Best effort: with no contiguous area that big, fall back to allocating
+	 * as the file grows.
+	 */
+	const auto error = file.reserve(size);
+	if( error.is_valid() ) {
+		return (error.value().code() == FR_DENIED) ? Optional<File::Error> { } : error;
+	}
+	reserved = true;
+	return { };
+}
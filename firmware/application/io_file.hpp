@@ -51,6 +51,7 @@ protected:
 class FileWriter : public stream::Writer {
 public:
 	FileWriter() = default;
+	~FileWriter();
 
 	FileWriter(const FileWriter&) = delete;
 	FileWriter& operator=(const FileWriter&) = delete;
@@ -61,11 +62,14 @@ public:
 		return file.create(filename);
 	}
 
+	Optional<File::Error> reserve(const uint64_t size) override;
+
 	File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
 	
 protected:
 	File file { };
 	uint64_t bytes_written { 0 };
+	bool reserved { false };
 };
 
 using RawFileWriter = FileWriter;
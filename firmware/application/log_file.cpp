@@ -23,15 +23,147 @@
 
 #include "string_format.hpp"
 
+#include <algorithm>
+
+LogFile::LogFile() {
+	chMtxInit(&mutex);
+	chBSemInit(&flushed, TRUE);
+}
+
+LogFile::~LogFile() {
+	if( thread ) {
+		// The thread writes out whatever is left before exiting
+		chThdTerminate(thread);
+		chEvtSignal(thread, EVT_MASK_FLUSH);
+		chThdWait(thread);
+		thread = nullptr;
+	}
+}
+
+Optional<File::Error> LogFile::append(const std::filesystem::path& filename) {
+	const auto open_error = file.append(filename);
+	if( !open_error.is_valid() && !thread ) {
+		// Need significant stack for FATFS
+		thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO + 5, LogFile::static_fn, this);
+	}
+	return open_error;
+}
+
 Optional<File::Error> LogFile::write_entry(const rtc::RTC& datetime, const std::string& entry) {
 	std::string timestamp = to_string_timestamp(datetime);
 	return write_line(timestamp + " " + entry);
 }
 
 Optional<File::Error> LogFile::write_line(const std::string& message) {
-	auto error = file.write_line(message);
-	if( !error.is_valid() ) {
-		file.sync();
+	if( !thread ) {
+		return { File::Error { FR_INVALID_OBJECT } };
+	}
+	
+	chMtxLock(&mutex);
+	const size_t free = ring_size - (ring_write - ring_read);
+	const bool fits = (message.size() + 2) <= free;
+	if( fits ) {
+		push(message.c_str(), message.size());
+		push("\r\n", 2);
+	} else {
+		dropped_count++;
+	}
+	const size_t pending = ring_write - ring_read;
+	const auto last_error = error;
+	chMtxUnlock();
+	
+	if( (flush_policy == FlushPolicy::EveryLine) || (pending >= flush_size) ) {
+		chEvtSignal(thread, EVT_MASK_FLUSH);
+	}
+	
+	return last_error;
+}
+
+Optional<File::Error> LogFile::flush() {
+	if( !thread ) {
+		return error;
+	}
+	
+	// Only this (the UI) thread adds lines, so the target can't move
+	const size_t target = ring_write;
+	
+	while( true ) {
+		chMtxLock(&mutex);
+		const bool done = (ring_read == target) || error.is_valid();
+		const auto last_error = error;
+		chMtxUnlock();
+		
+		if( done ) {
+			return last_error;
+		}
+		
+		chBSemReset(&flushed, TRUE);
+		chEvtSignal(thread, EVT_MASK_FLUSH);
+		chBSemWait(&flushed);
+	}
+}
+
+void LogFile::push(const char* const data, const size_t length) {
+	for(size_t i=0; i<length; i++) {
+		ring[(ring_write + i) & (ring_size - 1)] = data[i];
+	}
+	ring_write += length;
+}
+
+Optional<File::Error> LogFile::write_pending() {
+	// Only the UI thread adds to the ring, and only into free space: the
+	// pending part can be written out without holding the lock.
+	chMtxLock(&mutex);
+	const size_t start = ring_read;
+	const size_t end = ring_write;
+	chMtxUnlock();
+	
+	if( start == end ) {
+		return { };
+	}
+	
+	// At most two pieces, split where the ring wraps
+	size_t position = start;
+	while( position != end ) {
+		const size_t offset = position & (ring_size - 1);
+		const size_t length = std::min(end - position, ring_size - offset);
+		const auto result = file.write(&ring[offset], length);
+		if( result.is_error() ) {
+			return { result.error() };
+		}
+		position += length;
+	}
+	
+	const auto sync_error = file.sync();
+	
+	chMtxLock(&mutex);
+	ring_read = end;
+	chMtxUnlock();
+	
+	return sync_error;
+}
+
+msg_t LogFile::static_fn(void* arg) {
+	auto obj = static_cast<LogFile*>(arg);
+	obj->run();
+	return 0;
+}
+
+void LogFile::run() {
+	while( !chThdShouldTerminate() ) {
+		chEvtWaitAnyTimeout(EVT_MASK_FLUSH, MS2ST(flush_interval_ms));
+		
+		const auto write_error = write_pending();
+		
+		chMtxLock(&mutex);
+		if( write_error.is_valid() ) {
+			error = write_error;
+		}
+		chMtxUnlock();
+		
+		chBSemSignal(&flushed);
 	}
-	return error;
+	
+	write_pending();
+	chBSemSignal(&flushed);
 }
@@ -23,24 +23,83 @@
 #define __LOG_FILE_H__
 
 #include <string>
+#include <array>
+
+#include "ch.h"
 
 #include "file.hpp"
 
 #include "lpc43xx_cpp.hpp"
 using namespace lpc43xx;
 
+/* Lines are collected in a RAM ring and written out by a background thread,
+ * so logging from the UI thread never waits on the SD card. The file stays
+ * open until the LogFile is destroyed.
+ *
+ * Flush policy: pending lines are written and the file synced as soon as
+ * flush_size bytes are waiting, and at least every flush_interval_ms. A crash
+ * or power loss can therefore lose at most that much. FlushPolicy::EveryLine
+ * writes and syncs each line as it comes, for rare but important entries.
+ * When the card falls so far behind that the ring is full, new lines are
+ * dropped (and counted) rather than blocking the caller.
+ */
 class LogFile {
 public:
-	Optional<File::Error> append(const std::filesystem::path& filename) {
-		return file.append(filename);
+	enum class FlushPolicy {
+		Interval,
+		EveryLine
+	};
+	
+	LogFile();
+	~LogFile();
+	
+	LogFile(const LogFile&) = delete;
+	LogFile(LogFile&&) = delete;
+	LogFile& operator=(const LogFile&) = delete;
+	LogFile& operator=(LogFile&&) = delete;
+	
+	Optional<File::Error> append(const std::filesystem::path& filename);
+	
+	void set_flush_policy(const FlushPolicy policy) {
+		flush_policy = policy;
 	}
-
+	
+	// Returns the last error from the background writer, if any
 	Optional<File::Error> write_entry(const rtc::RTC& datetime, const std::string& entry);
+	
+	// Blocks until everything logged so far is on the card
+	Optional<File::Error> flush();
+	
+	size_t dropped() const {
+		return dropped_count;
+	}
 
 private:
+	static constexpr size_t ring_size = 2048;		// Power of two
+	static constexpr size_t flush_size = 512;		// One sector
+	static constexpr uint32_t flush_interval_ms = 1000;
+	
+	static constexpr eventmask_t EVT_MASK_FLUSH = EVENT_MASK(0);
+	
 	File file { };
-
+	FlushPolicy flush_policy { FlushPolicy::Interval };
+	
+	std::array<char, ring_size> ring { };
+	size_t ring_write { 0 };		// Free-running, masked on access
+	size_t ring_read { 0 };
+	size_t dropped_count { 0 };
+	Optional<File::Error> error { };
+	
+	Mutex mutex { };
+	BinarySemaphore flushed { };
+	Thread* thread { nullptr };
+	
+	void push(const char* const data, const size_t length);
 	Optional<File::Error> write_line(const std::string& message);
+	Optional<File::Error> write_pending();
+	
+	static msg_t static_fn(void* arg);
+	void run();
 };
 
 #endif/*__LOG_FILE_H__*/
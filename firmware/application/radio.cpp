@@ -95,6 +95,7 @@ static max5864::MAX5864 baseband_codec { ssp1_target_max5864 };
 static baseband::CPLD baseband_cpld;
 
 static rf::Direction direction { rf::Direction::Receive };
+static bool first_if_enabled { false };
 
 void init() {
 	rf_path.init();
@@ -139,7 +140,8 @@ bool set_tuning_frequency(const rf::Frequency frequency) {
 	if( tuning_config.is_valid() ) {
 		first_if.disable();
 
-		if( tuning_config.first_lo_frequency ) {
+		first_if_enabled = (tuning_config.first_lo_frequency != 0);
+		if( first_if_enabled ) {
 			first_if.set_frequency(tuning_config.first_lo_frequency);
 			first_if.enable();
 		}
@@ -155,6 +157,13 @@ bool set_tuning_frequency(const rf::Frequency frequency) {
 	}
 }
 
+/* The MAX2837 synthesizer settles well within the time it takes to talk to
+ * it, only the RFFC507x has a lock indicator worth waiting for.
+ */
+bool is_tuning_locked() {
+	return first_if_enabled ? first_if.is_locked() : true;
+}
+
 void set_rf_amp(const bool rf_amp) {
 	rf_path.set_rf_amp(rf_amp);
 	
@@ -22,75 +22,18 @@
 #ifndef __RECENT_ENTRIES_H__
 #define __RECENT_ENTRIES_H__
 
+#include "recent_entries_lru.hpp"
+
 #include "ui_widget.hpp"
 #include "ui_font_fixed_8x16.hpp"
 
 #include <cstddef>
 #include <cstdint>
-#include <list>
 #include <utility>
 #include <functional>
 #include <iterator>
 #include <algorithm>
 
-template<class Entry>
-using RecentEntries = std::list<Entry>;
-
-template<typename ContainerType, typename Key>
-typename ContainerType::const_iterator find(const ContainerType& entries, const Key key) {
-	return std::find_if(
-		std::begin(entries), std::end(entries),
-		[key](typename ContainerType::const_reference e) { return e.key() == key; }
-	);
-}
-
-template<typename ContainerType>
-static void truncate_entries(ContainerType& entries, const size_t entries_max = 64) {
-	while(entries.size() > entries_max) {
-		entries.pop_back();
-	}
-}
-
-template<typename ContainerType, typename Key>
-typename ContainerType::reference on_packet(ContainerType& entries, const Key key) {
-	auto matching_recent = find(entries, key);
-	if( matching_recent != std::end(entries) ) {
-		// Found within. Move to front of list, increment counter.
-		entries.push_front(*matching_recent);
-		entries.erase(matching_recent);
-	} else {
-		entries.emplace_front(key);
-		truncate_entries(entries);
-	}
-
-	return entries.front();
-}
-
-template<typename ContainerType>
-static std::pair<typename ContainerType::const_iterator, typename ContainerType::const_iterator> range_around(
-	const ContainerType& entries,
-	typename ContainerType::const_iterator item,
-	const size_t count
-) {
-	auto start = item;
-	auto end = item;
-	size_t i = 0;
-
-	// Move start iterator toward first entry.
-	while( (start != std::begin(entries)) && (i < count / 2) ) {
-		std::advance(start, -1);
-		i++;
-	}
-
-	// Move end iterator toward last entry.
-	while( (end != std::end(entries)) && (i < count) ) {
-		std::advance(end, 1);
-		i++;
-	}
-
-	return { start, end };
-}
-
 namespace ui {
 
 using RecentEntriesColumn = std::pair<std::string, size_t>;
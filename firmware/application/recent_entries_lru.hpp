@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __RECENT_ENTRIES_LRU_H__
+#define __RECENT_ENTRIES_LRU_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <functional>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+/* Key hashing for the RecentEntries index. Apps with compound keys provide an
+ * overload next to the key type (found by argument-dependent lookup).
+ */
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, uint32_t>::type
+recent_entries_hash(const T value) {
+	const uint64_t v = static_cast<uint64_t>(value);
+	return static_cast<uint32_t>(v ^ (v >> 32)) * 0x9e3779b1U;
+}
+
+template<typename T1, typename T2>
+uint32_t recent_entries_hash(const std::pair<T1, T2>& value) {
+	return (recent_entries_hash(value.first) * 31) ^ recent_entries_hash(value.second);
+}
+
+/* Most recently seen first, at most Capacity entries. Entries live in a fixed
+ * pool and are chained in a doubly linked list of slot numbers, so moving one
+ * to the front doesn't copy or allocate. Keys are indexed in an open-addressed
+ * (linear probing) table twice the capacity for constant time lookup.
+ */
+template<class Entry, size_t Capacity = 64>
+class RecentEntries {
+	using Slot = uint16_t;
+	
+	static constexpr Slot no_slot = 0xffff;
+	static constexpr size_t index_bits = (Capacity <= 64) ? 7 : (Capacity <= 256) ? 9 : (Capacity <= 1024) ? 11 : 13;
+	static constexpr size_t index_size = 1 << index_bits;
+	static constexpr size_t index_mask = index_size - 1;
+	
+	static_assert(Capacity > 0, "RecentEntries needs at least one entry");
+	static_assert(index_size >= Capacity * 2, "RecentEntries capacity too large");
+	
+	template<bool Const>
+	class Iterator {
+	public:
+		using Container = typename std::conditional<Const, const RecentEntries, RecentEntries>::type;
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = Entry;
+		using difference_type = std::ptrdiff_t;
+		using pointer = typename std::conditional<Const, const Entry*, Entry*>::type;
+		using reference = typename std::conditional<Const, const Entry&, Entry&>::type;
+		
+		constexpr Iterator(
+			Container* const container = nullptr,
+			const Slot slot = no_slot
+		) : container { container },
+			slot { slot }
+		{
+		}
+		
+		// iterator to const_iterator
+		constexpr Iterator(
+			const Iterator<false>& other
+		) : container { other.container },
+			slot { other.slot }
+		{
+		}
+		
+		reference operator*() const { return container->entry(slot); }
+		pointer operator->() const { return &container->entry(slot); }
+		
+		Iterator& operator++() {
+			slot = container->next[slot];
+			return *this;
+		}
+		
+		Iterator operator++(int) {
+			auto result = *this;
+			++*this;
+			return result;
+		}
+		
+		Iterator& operator--() {
+			slot = (slot == no_slot) ? container->tail : container->prev[slot];
+			return *this;
+		}
+		
+		Iterator operator--(int) {
+			auto result = *this;
+			--*this;
+			return result;
+		}
+		
+		bool operator==(const Iterator& other) const { return slot == other.slot; }
+		bool operator!=(const Iterator& other) const { return slot != other.slot; }
+		
+	private:
+		friend class RecentEntries;
+		friend class Iterator<true>;
+		
+		Container* container;
+		Slot slot;
+	};
+	
+public:
+	using value_type = Entry;
+	using reference = Entry&;
+	using const_reference = const Entry&;
+	using size_type = size_t;
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+	
+	RecentEntries() {
+		std::fill(std::begin(index), std::end(index), no_slot);
+		
+		// All slots start out on the free list
+		for (size_t i = 0; i < Capacity; i++)
+			next[i] = (i + 1 < Capacity) ? i + 1 : no_slot;
+		free = 0;
+	}
+	
+	~RecentEntries() {
+		clear();
+	}
+	
+	RecentEntries(const RecentEntries&) = delete;
+	RecentEntries(RecentEntries&&) = delete;
+	RecentEntries& operator=(const RecentEntries&) = delete;
+	RecentEntries& operator=(RecentEntries&&) = delete;
+	
+	iterator begin() { return { this, head }; }
+	iterator end() { return { this, no_slot }; }
+	const_iterator begin() const { return { this, head }; }
+	const_iterator end() const { return { this, no_slot }; }
+	
+	reference front() { return entry(head); }
+	const_reference front() const { return entry(head); }
+	
+	bool empty() const { return count == 0; }
+	size_type size() const { return count; }
+	static constexpr size_type max_size() { return Capacity; }
+	
+	template<typename Key>
+	iterator find(const Key& key) {
+		return { this, lookup(key) };
+	}
+	
+	template<typename Key>
+	const_iterator find(const Key& key) const {
+		return { this, lookup(key) };
+	}
+	
+	// Returns the entry for key moved to the front, created if new
+	template<typename Key>
+	reference on_packet(const Key& key) {
+		Slot slot = lookup(key);
+		
+		if (slot != no_slot) {
+			unlink(slot);
+		} else {
+			if (free == no_slot) {
+				// Full, drop the least recently seen
+				slot = tail;
+				remove_key(entry(slot).key());
+				unlink(slot);
+				entry(slot).~Entry();
+				count--;
+			} else {
+				slot = free;
+				free = next[slot];
+			}
+			
+			new (&storage[slot]) Entry(key);
+			count++;
+			insert_key(key, slot);
+		}
+		
+		link_front(slot);
+		return entry(slot);
+	}
+	
+	void clear() {
+		while (head != no_slot) {
+			const Slot slot = head;
+			unlink(slot);
+			entry(slot).~Entry();
+			next[slot] = free;
+			free = slot;
+		}
+		count = 0;
+		std::fill(std::begin(index), std::end(index), no_slot);
+	}
+	
+private:
+	typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type storage[Capacity] { };
+	Slot prev[Capacity] { };
+	Slot next[Capacity] { };
+	Slot index[index_size] { };
+	Slot head { no_slot };
+	Slot tail { no_slot };
+	Slot free { no_slot };
+	size_t count { 0 };
+	
+	Entry& entry(const Slot slot) {
+		return *reinterpret_cast<Entry*>(&storage[slot]);
+	}
+	
+	const Entry& entry(const Slot slot) const {
+		return *reinterpret_cast<const Entry*>(&storage[slot]);
+	}
+	
+	template<typename Key>
+	static size_t home(const Key& key) {
+		// Top bits of the (multiplicative) hash are the best mixed
+		return recent_entries_hash(key) >> (32 - index_bits);
+	}
+	
+	template<typename Key>
+	Slot lookup(const Key& key) const {
+		for (size_t i = home(key); index[i] != no_slot; i = (i + 1) & index_mask) {
+			if (entry(index[i]).key() == key)
+				return index[i];
+		}
+		return no_slot;
+	}
+	
+	template<typename Key>
+	void insert_key(const Key& key, const Slot slot) {
+		size_t i = home(key);
+		while (index[i] != no_slot)
+			i = (i + 1) & index_mask;
+		index[i] = slot;
+	}
+	
+	template<typename Key>
+	void remove_key(const Key& key) {
+		size_t i = home(key);
+		while (!(entry(index[i]).key() == key))
+			i = (i + 1) & index_mask;
+		
+		// Backward shift: pull later entries of the probe run into the gap,
+		// unless that would move them before their home position.
+		for (size_t j = (i + 1) & index_mask; index[j] != no_slot; j = (j + 1) & index_mask) {
+			const size_t k = home(entry(index[j]).key());
+			if (((j - k) & index_mask) >= ((j - i) & index_mask)) {
+				index[i] = index[j];
+				i = j;
+			}
+		}
+		index[i] = no_slot;
+	}
+	
+	void unlink(const Slot slot) {
+		if (prev[slot] != no_slot)
+			next[prev[slot]] = next[slot];
+		else
+			head = next[slot];
+		
+		if (next[slot] != no_slot)
+			prev[next[slot]] = prev[slot];
+		else
+			tail = prev[slot];
+	}
+	
+	void link_front(const Slot slot) {
+		prev[slot] = no_slot;
+		next[slot] = head;
+		if (head != no_slot)
+			prev[head] = slot;
+		else
+			tail = slot;
+		head = slot;
+	}
+};
+
+template<typename ContainerType, typename Key>
+typename ContainerType::const_iterator find(const ContainerType& entries, const Key key) {
+	return entries.find(key);
+}
+
+template<typename ContainerType, typename Key>
+typename ContainerType::reference on_packet(ContainerType& entries, const Key key) {
+	return entries.on_packet(key);
+}
+
+template<typename ContainerType>
+static std::pair<typename ContainerType::const_iterator, typename ContainerType::const_iterator> range_around(
+	const ContainerType& entries,
+	typename ContainerType::const_iterator item,
+	const size_t count
+) {
+	auto start = item;
+	auto end = item;
+	size_t i = 0;
+
+	// Move start iterator toward first entry.
+	while( (start != std::begin(entries)) && (i < count / 2) ) {
+		std::advance(start, -1);
+		i++;
+	}
+
+	// Move end iterator toward last entry.
+	while( (end != std::end(entries)) && (i < count) ) {
+		std::advance(end, 1);
+		i++;
+	}
+
+	return { start, end };
+}
+
+#endif/*__RECENT_ENTRIES_LRU_H__*/
@@ -41,7 +41,8 @@ public:
 		size_t read_size,
 		size_t buffer_count,
 		bool* ready_signal,
-		std::function<void(uint32_t return_code)> terminate_callback
+		std::function<void(uint32_t return_code)> terminate_callback,
+		const IQFormat format = IQFormat::C16
 	);
 	~ReplayThread();
 
@@ -25,6 +25,7 @@
 #include "portapack.hpp"
 
 #include <cstring>
+#include <algorithm>
 #include <stdio.h>
 
 using namespace portapack;
@@ -144,42 +145,185 @@ GeoMap::GeoMap(
 	Rect parent_rect
 ) : Widget { parent_rect }
 {
-	//set_focusable(true);
+	// Focus to zoom with the encoder
+	set_focusable(true);
 }
 
-void GeoMap::paint(Painter& painter) {
-	u_int16_t line;
-	std::array<ui::Color, 240> map_line_buffer;
-	const auto r = screen_rect();
+size_t GeoMap::tiles_wide() const {
+	return (levels[zoom].width + tile_size - 1) / tile_size;
+}
+
+// Returns nullptr outside of the map
+const GeoMap::Tile* GeoMap::load_tile(const int32_t x, const int32_t y) {
+	const auto& level = levels[zoom];
+	if ((x < 0) || (y < 0) || (x >= (int32_t)tiles_wide()) || (y * tile_size >= level.height))
+		return nullptr;
+	
+	size_t slot = 0;
+	for (size_t i = 0; i < tile_cache_size; i++) {
+		const auto& tag = tile_tags[i];
+		if (tag.used && (tag.level == zoom) && (tag.x == x) && (tag.y == y)) {
+			tile_tags[i].used = ++tile_clock;
+			return &tile_cache[i];
+		}
+		if (tag.used < tile_tags[slot].used)
+			slot = i;
+	}
+	
+	// Miss, replace the least recently used
+	auto& tile = tile_cache[slot];
+	if (map_tiled) {
+		map_file.seek(level.offset + ((y * tiles_wide()) + x) * sizeof(Tile));
+		map_file.read(tile.data(), sizeof(Tile));
+	} else {
+		// Flat raster, one read per line
+		tile.fill(Color::black());
+		const size_t x0 = x * tile_size;
+		const size_t width = std::min(tile_size, level.width - x0);
+		for (size_t line = 0; (line < tile_size) && ((y * tile_size) + line < level.height); line++) {
+			map_file.seek(level.offset + ((((y * tile_size) + line) * level.width) + x0) * sizeof(Color));
+			map_file.read(&tile[line * tile_size], width * sizeof(Color));
+		}
+	}
+	
+	tile_tags[slot] = { (uint8_t)zoom, (uint16_t)x, (uint16_t)y, ++tile_clock };
+	return &tile;
+}
+
+// Reads a row of tiles at once into the cache
+bool GeoMap::load_tile_row(int32_t x, const int32_t y, size_t count) {
+	const auto& level = levels[zoom];
+	if ((y < 0) || (y * tile_size >= level.height))
+		return false;
 	
-	// Ony redraw map if it moved by at least 1 pixel
-	if ((x_pos != prev_x_pos) || (y_pos != prev_y_pos)) {
-		for (line = 0; line < r.height(); line++) {
-			map_file.seek(4 + ((x_pos + (map_width * (y_pos + line))) << 1));
-			map_file.read(map_line_buffer.data(), r.width() << 1);
-			display.draw_pixels({ 0, r.top() + line, r.width(), 1 }, map_line_buffer);
+	if (x < 0) {
+		count = (count > (size_t)-x) ? count + x : 0;
+		x = 0;
+	}
+	count = std::min(std::min(count, tile_cache_size), tiles_wide() - std::min((size_t)x, tiles_wide()));
+	if (!count)
+		return false;
+	
+	if (map_tiled) {
+		// Consecutive in the file
+		map_file.seek(level.offset + ((y * tiles_wide()) + x) * sizeof(Tile));
+		if (map_file.read(tile_cache.data(), count * sizeof(Tile)).is_error())
+			return false;
+	} else {
+		// Flat raster, one read per line spread over the tiles
+		std::array<Color, tile_cache_size * tile_size> line_buffer;
+		const size_t x0 = x * tile_size;
+		const size_t width = std::min(count * tile_size, level.width - x0);
+		line_buffer.fill(Color::black());
+		
+		for (size_t line = 0; line < tile_size; line++) {
+			if ((y * tile_size) + line < level.height) {
+				map_file.seek(level.offset + ((((y * tile_size) + line) * level.width) + x0) * sizeof(Color));
+				if (map_file.read(line_buffer.data(), width * sizeof(Color)).is_error())
+					return false;
+			} else {
+				line_buffer.fill(Color::black());
+			}
+			for (size_t i = 0; i < count; i++)
+				std::copy(&line_buffer[i * tile_size], &line_buffer[(i + 1) * tile_size], &tile_cache[i][line * tile_size]);
 		}
+	}
+	
+	for (size_t i = 0; i < tile_cache_size; i++)
+		tile_tags[i] = { (uint8_t)zoom, (uint16_t)(x + i), (uint16_t)y, (i < count) ? ++tile_clock : 0 };
+	
+	return true;
+}
+
+void GeoMap::draw_tile(const Tile* const tile, const Rect tile_rect, const Rect clip) {
+	const auto visible = tile_rect.intersect(clip);
+	if (visible.is_empty())
+		return;
+	
+	if (!tile) {
+		display.fill_rectangle(visible, Color::black());
+	} else if (((size_t)visible.width() == tile_size) && ((size_t)visible.height() == tile_size)) {
+		display.render_box(visible.location(), visible.size(), tile->data());
+	} else {
+		const auto dx = visible.left() - tile_rect.left();
+		for (auto y = visible.top(); y < visible.bottom(); y++)
+			display.render_line({ visible.left(), y }, visible.width(), &(*tile)[((y - tile_rect.top()) * tile_size) + dx]);
+	}
+}
+
+// Repaints the map under area (screen coordinates)
+void GeoMap::draw_area(const Rect area) {
+	const auto r = screen_rect();
+	const auto clip = area.intersect(r);
+	if (clip.is_empty())
+		return;
+	
+	// Tile coordinates, rounding toward -infinity
+	const int32_t map_left = x_pos + (clip.left() - r.left());
+	const int32_t map_top = y_pos + (clip.top() - r.top());
+	const int32_t tile_left = (map_left >= 0) ? (map_left / (int32_t)tile_size) : -((-map_left + (int32_t)tile_size - 1) / (int32_t)tile_size);
+	const int32_t tile_top = (map_top >= 0) ? (map_top / (int32_t)tile_size) : -((-map_top + (int32_t)tile_size - 1) / (int32_t)tile_size);
+	const int32_t tile_right = tile_left + ((map_left - (tile_left * (int32_t)tile_size) + clip.width() - 1) / (int32_t)tile_size);
+	const int32_t tile_bottom = tile_top + ((map_top - (tile_top * (int32_t)tile_size) + clip.height() - 1) / (int32_t)tile_size);
+	
+	// Whole rows are read at once, a small area is more likely to be cached
+	const bool whole_rows = (clip.width() == r.width());
+	
+	for (int32_t ty = tile_top; ty <= tile_bottom; ty++) {
+		if (whole_rows)
+			load_tile_row(tile_left, ty, tile_right - tile_left + 1);
 		
-		prev_x_pos = x_pos;
-		prev_y_pos = y_pos;
+		for (int32_t tx = tile_left; tx <= tile_right; tx++) {
+			const Rect tile_rect {
+				r.left() + (tx * (int32_t)tile_size) - x_pos,
+				r.top() + (ty * (int32_t)tile_size) - y_pos,
+				tile_size, tile_size
+			};
+			draw_tile(load_tile(tx, ty), tile_rect, clip);
+		}
 	}
+}
+
+void GeoMap::paint(Painter& painter) {
+	const auto r = screen_rect();
+	
+	// A clean paint is damage from above, anything but a marker move may have
+	// changed the whole area
+	if (redraw_map || !marker_moved || !dirty()) {
+		draw_area(r);
+	} else {
+		// Only put back the map under the previous marker
+		draw_area(marker_rect);
+	}
+	redraw_map = false;
+	marker_moved = false;
+	
+	const Point marker = r.location() + Point(marker_x - x_pos, marker_y - y_pos);
 	
 	if (mode_ == PROMPT) {
 		// Cross
-		display.fill_rectangle({ r.center() - Point(16, 1), { 32, 2 } }, Color::red());
-		display.fill_rectangle({ r.center() - Point(1, 16), { 2, 32 } }, Color::red());
+		display.fill_rectangle({ marker - Point(16, 1), { 32, 2 } }, Color::red());
+		display.fill_rectangle({ marker - Point(1, 16), { 2, 32 } }, Color::red());
+		marker_rect = { marker - Point(16, 16), { 32, 32 } };
 	} else if (angle_ < 360){
 		//if we have a valid angle draw bearing
-		draw_bearing(r.center(), angle_, 10, Color::red());
+		draw_bearing(marker, angle_, 10, Color::red());
+		marker_rect = { marker - Point(11, 11), { 23, 23 } };
 		//center tag above bearing
 		if(tag_.find_first_not_of(' ') != tag_.npos){ //only draw tag if we have something other than spaces
-			painter.draw_string(r.center() - Point(((int)tag_.length() * 8 / 2), 2 * 16), style(), tag_);
+			const Point tag_pos = marker - Point(((int)tag_.length() * 8 / 2), 2 * 16);
+			painter.draw_string(tag_pos, style(), tag_);
+			const Rect tag_rect { tag_pos, { (int)tag_.length() * 8, 16 } };
+			const Point top_left { std::min(marker_rect.left(), tag_rect.left()), std::min(marker_rect.top(), tag_rect.top()) };
+			const Point bottom_right { std::max(marker_rect.right(), tag_rect.right()), std::max(marker_rect.bottom(), tag_rect.bottom()) };
+			marker_rect = { top_left, { bottom_right.x() - top_left.x(), bottom_right.y() - top_left.y() } };
 		}
 	}
 	else {
 		//draw a small cross
-		display.fill_rectangle({ r.center() - Point(8, 1), { 16, 2 } }, Color::red());
-		display.fill_rectangle({ r.center() - Point(1, 8), { 2, 16 } }, Color::red());
+		display.fill_rectangle({ marker - Point(8, 1), { 16, 2 } }, Color::red());
+		display.fill_rectangle({ marker - Point(1, 8), { 2, 16 } }, Color::red());
+		marker_rect = { marker - Point(8, 8), { 16, 16 } };
 	}
 }
 
@@ -195,6 +339,26 @@ bool GeoMap::on_touch(const TouchEvent event) {
 	return false;
 }
 
+bool GeoMap::on_encoder(const EncoderEvent delta) {
+	// Level 0 is the most detailed
+	if ((delta > 0) && (zoom > 0))
+		zoom--;
+	else if ((delta < 0) && (zoom + 1 < level_count))
+		zoom++;
+	else
+		return false;
+	
+	map_width = levels[zoom].width;
+	map_height = levels[zoom].height;
+	lon_ratio = 180.0 / (map_width >> 1);
+	lat_ratio = -90.0 / (map_height >> 1);
+	
+	redraw_map = true;
+	move(lon_, lat_);
+	set_dirty();
+	return true;
+}
+
 void GeoMap::move(const float lon, const float lat) {
 	lon_ = lon;
 	lat_ = lat;
@@ -202,20 +366,32 @@ void GeoMap::move(const float lon, const float lat) {
 	Rect map_rect = screen_rect();
 	
 	// Using WGS 84/Pseudo-Mercator projection
-	x_pos = map_width * (lon_+180)/360  - (map_rect.width() / 2);
+	marker_x = map_width * (lon_+180)/360;
 
 	// Latitude calculation based on https://stackoverflow.com/a/10401734/2278659
 	double map_bottom = sin(-85.05 * pi / 180); // Map bitmap only goes from about -85 to 85 lat
 	double lat_rad = sin(lat * pi / 180);
 	double map_world_lon = map_width / (2 * pi); 
-    double map_offset = (map_world_lon / 2 * log((1 + map_bottom) / (1 - map_bottom)));
-	y_pos = map_height - ((map_world_lon / 2 * log((1 + lat_rad) / (1 - lat_rad))) - map_offset) - 128; // Offset added for the GUI
-
-	// Cap position
-	if (x_pos > (map_width - map_rect.width()))
-		x_pos = map_width - map_rect.width();
-	if (y_pos > (map_height + map_rect.height()))
-		y_pos = map_height - map_rect.height();
+	double map_offset = (map_world_lon / 2 * log((1 + map_bottom) / (1 - map_bottom)));
+	marker_y = map_height - ((map_world_lon / 2 * log((1 + lat_rad) / (1 - lat_rad))) - map_offset);
+	
+	// Only recenter when the marker gets near the edges, so that tracking
+	// just repaints around the marker
+	const int32_t dx = marker_x - x_pos;
+	const int32_t dy = marker_y - y_pos;
+	const int32_t w = map_rect.width();
+	const int32_t h = map_rect.height();
+	if (redraw_map || (mode_ == PROMPT) || (dx < w / 4) || (dx > w * 3 / 4) || (dy < h / 4) || (dy > h * 3 / 4)) {
+		x_pos = marker_x - (w / 2);
+		y_pos = marker_y - (h / 2);
+		redraw_map = true;
+	} else {
+		marker_moved = true;
+	}
+}
+
+void GeoMap::on_show() {
+	redraw_map = true;
 }
 
 bool GeoMap::init() {
@@ -223,14 +399,32 @@ bool GeoMap::init() {
 	if (result.is_valid())
 		return false;
 	
-	map_file.read(&map_width, 2);
-	map_file.read(&map_height, 2);
+	uint8_t header[16];
+	if (map_file.read(header, 16).is_error())
+		return false;
+	
+	if (!memcmp(header, "PPMT", 4)) {
+		const uint16_t version = header[4] | (header[5] << 8);
+		const uint16_t map_tile_size = header[6] | (header[7] << 8);
+		level_count = std::min((size_t)header[8], levels_max);
+		if ((version != 1) || (map_tile_size != tile_size) || !level_count)
+			return false;
+		
+		map_file.read(levels.data(), level_count * sizeof(MapLevel));
+		map_tiled = true;
+	} else {
+		// Flat raster
+		levels[0] = { (uint16_t)(header[0] | (header[1] << 8)), (uint16_t)(header[2] | (header[3] << 8)), 4 };
+		level_count = 1;
+		map_tiled = false;
+	}
 	
-	map_center_x = map_width >> 1;
-	map_center_y = map_height >> 1;
+	zoom = 0;
+	map_width = levels[0].width;
+	map_height = levels[0].height;
 	
-	lon_ratio = 180.0 / map_center_x;
-	lat_ratio = -90.0 / map_center_y;
+	lon_ratio = 180.0 / (map_width >> 1);
+	lat_ratio = -90.0 / (map_height >> 1);
 	
 	return true;
 }
@@ -256,7 +450,10 @@ void GeoMap::draw_bearing(const Point origin, const uint16_t angle, uint32_t siz
 }
 
 void GeoMapView::focus() {
-	geopos.focus();
+	if (map_opened && (mode_ == DISPLAY))
+		geomap.focus();		// Position is read only, the encoder zooms
+	else
+		geopos.focus();
 	
 	if (!map_opened)
 		nav_.display_modal("No map", "No world_map.bin file in\n/ADSB/ directory", ABORT, nullptr);
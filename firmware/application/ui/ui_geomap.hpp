@@ -113,6 +113,22 @@ private:
 	};
 };
 
+/* ADSB/world_map.bin, made by tools/generate_world_map.bin.py:
+ *
+ * 0x00	char[4]		"PPMT"
+ * 0x04	u16			version (1)
+ * 0x06	u16			tile size (16)
+ * 0x08	u8			zoom level count
+ * 0x10				Level table, from full resolution down to the smallest,
+ *					each halving the previous one:
+ *					u16 width, u16 height (pixels), u32 offset of the tiles
+ *
+ * The header and level table are padded to a 512-byte sector, and every level
+ * starts on a sector boundary.
+ * Tiles are 16x16 RGB565 pixels, one sector each, stored row by row so that
+ * the visible tiles of a row can be read in one go. The older flat raster
+ * format (u16 width, u16 height, pixels) is still read, at a single zoom level.
+ */
 class GeoMap : public Widget {
 public:
 	std::function<void(float, float)> on_move { };
@@ -120,8 +136,10 @@ public:
 	GeoMap(Rect parent_rect);
 
 	void paint(Painter& painter) override;
-
+	void on_show() override;
+	
 	bool on_touch(const TouchEvent event) override;
+	bool on_encoder(const EncoderEvent delta) override;
 	
 	bool init();
 	void set_mode(GeoMapMode mode);
@@ -135,15 +153,52 @@ public:
 	}
 
 private:
+	static constexpr size_t tile_size = 16;
+	static constexpr size_t tile_cache_size = 16;		// A full row of visible tiles
+	static constexpr size_t levels_max = 8;
+	
+	using Tile = std::array<ui::Color, tile_size * tile_size>;
+	
+	struct MapLevel {
+		uint16_t width;
+		uint16_t height;
+		uint32_t offset;
+	};
+	
+	struct TileTag {
+		uint8_t level;
+		uint16_t x;
+		uint16_t y;
+		uint32_t used;		// 0: empty
+	};
+	
 	void draw_bearing(const Point origin, const uint16_t angle, uint32_t size, const Color color);
 	
+	const Tile* load_tile(const int32_t x, const int32_t y);
+	bool load_tile_row(const int32_t x, const int32_t y, const size_t count);
+	size_t tiles_wide() const;
+	void draw_tile(const Tile* const tile, const Rect tile_rect, const Rect clip);
+	void draw_area(const Rect area);
+	
 	GeoMapMode mode_ { };
 	File map_file { };
+	bool map_tiled { false };
+	std::array<MapLevel, levels_max> levels { };
+	size_t level_count { 0 };
+	size_t zoom { 0 };
 	uint16_t map_width { }, map_height { };
-	int32_t map_center_x { }, map_center_y { };
 	float lon_ratio { }, lat_ratio { };
-	int32_t x_pos { }, y_pos { };
-	int32_t prev_x_pos { 0xFFFF }, prev_y_pos { 0xFFFF };
+	
+	std::array<Tile, tile_cache_size> tile_cache { };
+	std::array<TileTag, tile_cache_size> tile_tags { };
+	uint32_t tile_clock { 0 };
+	
+	int32_t x_pos { }, y_pos { };				// Top left of the view, in map pixels
+	int32_t marker_x { }, marker_y { };
+	bool redraw_map { true };
+	bool marker_moved { false };				// Only the marker needs repainting
+	Rect marker_rect { };						// Last drawn marker, to erase it
+	
 	float lat_ { };
 	float lon_ { };
 	uint16_t angle_ { };
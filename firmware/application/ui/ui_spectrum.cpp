@@ -24,12 +24,14 @@
 #include "spectrum_color_lut.hpp"
 
 #include "portapack.hpp"
+#include "portapack_persistent_memory.hpp"
 using namespace portapack;
 
 #include "baseband_api.hpp"
 
 #include "string_format.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <array>
 
@@ -295,15 +297,18 @@ void WaterfallView::on_channel_spectrum(
 ) {
 	/* TODO: static_assert that message.spectrum.db.size() >= pixel_row.size() */
 
+	const int offset = level_to_floor ? (floor_level - spectrum.noise_floor) : 0;
+	const auto color = [offset](const uint8_t db) {
+		return spectrum_rgb3_lut[std::min(std::max(db + offset, 0), 255)];
+	};
+
 	std::array<Color, 240> pixel_row;
 	for(size_t i=0; i<120; i++) {
-		const auto pixel_color = spectrum_rgb3_lut[spectrum.db[256 - 120 + i]];
-		pixel_row[i] = pixel_color;
+		pixel_row[i] = color(spectrum.db[256 - 120 + i]);
 	}
 
 	for(size_t i=120; i<240; i++) {
-		const auto pixel_color = spectrum_rgb3_lut[spectrum.db[i - 120]];
-		pixel_row[i] = pixel_color;
+		pixel_row[i] = color(spectrum.db[i - 120]);
 	}
 
 	const auto draw_y = display.scroll(1);
@@ -314,6 +319,10 @@ void WaterfallView::on_channel_spectrum(
 	);
 }
 
+void WaterfallView::set_level_to_floor(const bool v) {
+	level_to_floor = v;
+}
+
 void WaterfallView::clear() {
 	display.fill_rectangle(
 		screen_rect(),
@@ -339,6 +348,7 @@ WaterfallWidget::WaterfallWidget(const bool cursor) {
 
 void WaterfallWidget::on_show() {
 	baseband::spectrum_streaming_start();
+	apply_spectrum_config();
 }
 
 void WaterfallWidget::on_hide() {
@@ -385,6 +395,11 @@ void WaterfallWidget::paint(Painter& painter) {
 	(void)painter;
 }
 
+void WaterfallWidget::apply_spectrum_config() {
+	baseband::set_spectrum_config(persistent_memory::spectrum_config());
+	waterfall_view.set_level_to_floor(persistent_memory::spectrum_level_to_floor());
+}
+
 void WaterfallWidget::on_channel_spectrum(const ChannelSpectrum& spectrum) {
 	waterfall_view.on_channel_spectrum(spectrum);
 	sampling_rate = spectrum.sampling_rate;
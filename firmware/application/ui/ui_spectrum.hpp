@@ -115,7 +115,14 @@ public:
 
 	void on_channel_spectrum(const ChannelSpectrum& spectrum);
 
+	// Shift colors so the noise floor always lands on the same one
+	void set_level_to_floor(const bool v);
+
 private:
+	static constexpr uint8_t floor_level = 32;
+
+	bool level_to_floor { false };
+
 	void clear();
 };
 
@@ -165,6 +172,8 @@ private:
 		[this](const Message* const p) {
 			const auto message = *reinterpret_cast<const ChannelSpectrumConfigMessage*>(p);
 			this->channel_fifo = message.fifo;
+			// A newly started baseband image has the default settings
+			this->apply_spectrum_config();
 		}
 	};
 	MessageHandlerRegistration message_handler_audio_spectrum {
@@ -191,6 +200,7 @@ private:
 		}
 	};
 
+	void apply_spectrum_config();
 	void on_channel_spectrum(const ChannelSpectrum& spectrum);
 	void on_audio_spectrum();
 };
@@ -105,6 +105,7 @@ int LoadModuleView::load_image() {
 					// f_read can't read more than 512 bytes at a time ?
 					if (i == 16) {
 						f_lseek(&modfile, 512);
+						m4_image_invalidate();
 						for (cnt = 0; cnt < 64; cnt++) {
 							if (f_read(&modfile, reinterpret_cast<void*>(portapack::memory::map::m4_code.base() + (cnt * 512)), 512, &bw)) return 0;
 						}
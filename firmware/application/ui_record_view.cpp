@@ -71,6 +71,7 @@ RecordView::RecordView(
 		&button_record,
 		&text_record_filename,
 		&text_record_dropped,
+		&text_record_backlog,
 		&text_time_available,
 	});
 	
@@ -114,6 +115,30 @@ void RecordView::set_sampling_rate(const size_t new_sampling_rate) {
 	}
 }
 
+void RecordView::set_file_type(const FileType new_file_type) {
+	if( new_file_type != file_type ) {
+		stop();
+
+		file_type = new_file_type;
+
+		update_status_display();
+	}
+}
+
+IQFormat RecordView::capture_format() const {
+	switch(file_type) {
+	case FileType::RawS8:	return IQFormat::C8;
+	case FileType::RawBFP4:	return IQFormat::BFP4;
+	default:				return IQFormat::C16;
+	}
+}
+
+uint32_t RecordView::bytes_per_second_raw() const {
+	// Baseband decimates by 8 before writing.
+	const auto format = capture_format();
+	return (sampling_rate / 8) * iq_format::block_bytes(format) / iq_format::block_samples(format);
+}
+
 bool RecordView::is_active() const {
 	return (bool)capture_thread;
 }
@@ -131,6 +156,7 @@ void RecordView::start() {
 
 	text_record_filename.set("");
 	text_record_dropped.set("");
+	text_record_backlog.set("");
 
 	if( sampling_rate == 0 ) {
 		return;
@@ -142,6 +168,8 @@ void RecordView::start() {
 	}
 
 	std::unique_ptr<stream::Writer> writer;
+	size_t capture_write_size = write_size;
+	uint64_t reserve_size = 0;
 	switch(file_type) {
 	case FileType::WAV:
 		{
@@ -160,7 +188,14 @@ void RecordView::start() {
 		break;
 
 	case FileType::RawS16:
+	case FileType::RawS8:
+	case FileType::RawBFP4:
 		{
+			const auto format = capture_format();
+
+			// Buffers must hold whole blocks, so dropped data doesn't split one.
+			capture_write_size -= write_size % iq_format::block_bytes(format);
+
 			const auto metadata_file_error = write_metadata_file(base_path.replace_extension(u".TXT"));
 			if( metadata_file_error.is_valid() ) {
 				handle_error(metadata_file_error.value());
@@ -168,11 +203,13 @@ void RecordView::start() {
 			}
 
 			auto p = std::make_unique<RawFileWriter>();
-			auto create_error = p->create(base_path.replace_extension(u".C16"));
+			auto create_error = p->create(base_path.replace_extension(std::string { iq_format::extension(format) }));
 			if( create_error.is_valid() ) {
 				handle_error(create_error.value());
 			} else {
 				writer = std::move(p);
+				// The capture thread reserves contiguous space for the first minutes.
+				reserve_size = bytes_per_second_raw() * reserve_seconds;
 			}
 		}
 		break;
@@ -186,7 +223,7 @@ void RecordView::start() {
 		button_record.set_bitmap(&bitmap_stop);
 		capture_thread = std::make_unique<CaptureThread>(
 			std::move(writer),
-			write_size, buffer_count,
+			capture_write_size, buffer_count,
 			[]() {
 				CaptureThreadDoneMessage message { };
 				EventDispatcher::send_message(message);
@@ -194,7 +231,9 @@ void RecordView::start() {
 			[](File::Error error) {
 				CaptureThreadDoneMessage message { error.code() };
 				EventDispatcher::send_message(message);
-			}
+			},
+			capture_format(),
+			reserve_size
 		);
 	}
 
@@ -229,6 +268,10 @@ Optional<File::Error> RecordView::write_metadata_file(const std::filesystem::pat
 		if( error_line2.is_valid() ) {
 			return error_line2;
 		}
+		const auto error_line3 = file.write_line(std::string("format=") + iq_format::name(capture_format()));
+		if( error_line3.is_valid() ) {
+			return error_line3;
+		}
 		return { };
 	}
 }
@@ -242,6 +285,9 @@ void RecordView::update_status_display() {
 		const auto dropped_percent = std::min(99U, capture_thread->state().dropped_percent());
 		const auto s = to_string_dec_uint(dropped_percent, 2, ' ') + "\%";
 		text_record_dropped.set(s);
+
+		const auto backlog = std::min(static_cast<size_t>(9), capture_thread->state().buffers_queued_max);
+		text_record_backlog.set(to_string_dec_uint(backlog, 1));
 	}
 	
 	if (pitch_rssi_enabled) {
@@ -250,7 +296,7 @@ void RecordView::update_status_display() {
 
 	if( sampling_rate ) {
 		const auto space_info = std::filesystem::space(u"");
-		const uint32_t bytes_per_second = file_type == FileType::WAV ? (sampling_rate * 2) : (sampling_rate / 8 * 4);
+		const uint32_t bytes_per_second = file_type == FileType::WAV ? (sampling_rate * 2) : bytes_per_second_raw();
 		const uint32_t available_seconds = space_info.free / bytes_per_second;
 		const uint32_t seconds = available_seconds % 60;
 		const uint32_t available_minutes = available_seconds / 60;
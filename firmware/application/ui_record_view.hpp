@@ -42,6 +42,8 @@ public:
 	enum FileType {
 		RawS16 = 2,
 		WAV = 3,
+		RawS8 = 4,
+		RawBFP4 = 5,
 	};
 
 	RecordView(
@@ -56,6 +58,7 @@ public:
 	void focus() override;
 
 	void set_sampling_rate(const size_t new_sampling_rate);
+	void set_file_type(const FileType new_file_type);
 
 	void start();
 	void stop();
@@ -67,6 +70,8 @@ private:
 	void toggle();
 	void toggle_pitch_rssi();
 	Optional<File::Error> write_metadata_file(const std::filesystem::path& filename);
+	IQFormat capture_format() const;
+	uint32_t bytes_per_second_raw() const;
 
 	void on_tick_second();
 	void update_status_display();
@@ -74,9 +79,11 @@ private:
 	void handle_capture_thread_done(const File::Error error);
 	void handle_error(const File::Error error);
 
+	static constexpr uint64_t reserve_seconds = 120;
+
 	bool pitch_rssi_enabled = false;
 	const std::filesystem::path filename_stem_pattern;
-	const FileType file_type;
+	FileType file_type;
 	const size_t write_size;
 	const size_t buffer_count;
 	size_t sampling_rate { 0 };
@@ -111,6 +118,11 @@ private:
 		"",
 	};
 
+	Text text_record_backlog {
+		{ 19 * 8, 0 * 16, 1 * 8, 16 },
+		"",
+	};
+
 	Text text_time_available {
 		{ 21 * 8, 0 * 16, 9 * 8, 16 },
 		"",
@@ -102,8 +102,10 @@ static std::array<gpdma::channel::LLI, transfers_per_buffer> lli_loop;
 static constexpr auto& gpdma_channel_sgpio = gpdma::channels[portapack::sgpio_gpdma_channel_number];
 
 static ThreadWait thread_wait;
+static volatile uint32_t transfer_count = 0;
 
 static void transfer_complete() {
+	transfer_count++;
 	const auto next_lli_index = gpdma_channel_sgpio.next_lli() - &lli_loop[0];
 	thread_wait.wake_from_interrupt(next_lli_index);
 }
@@ -170,5 +172,9 @@ baseband::buffer_t wait_for_buffer() {
 	}
 }
 
+uint32_t transfers_completed() {
+	return transfer_count;
+}
+
 } /* namespace dma */
 } /* namespace baseband */
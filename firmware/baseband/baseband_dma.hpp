@@ -22,6 +22,7 @@
 #ifndef __BASEBAND_DMA_H__
 #define __BASEBAND_DMA_H__
 
+#include <cstdint>
 #include <cstddef>
 #include <array>
 
@@ -44,6 +45,11 @@ void disable();
 
 baseband::buffer_t wait_for_buffer();
 
+/* Running count of completed transfers, including any whose buffer was
+ * not collected because the baseband thread was still busy.
+ */
+uint32_t transfers_completed();
+
 } /* namespace dma */
 } /* namespace baseband */
 
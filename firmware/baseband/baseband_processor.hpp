@@ -36,6 +36,10 @@ public:
 
 	virtual void on_message(const Message* const) { };
 
+	void set_channel_stats_interval(const uint32_t update_interval_ms) {
+		channel_stats.set_update_interval(update_interval_ms);
+	}
+
 protected:
 	void feed_channel_stats(const buffer_c16_t& channel);
 
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2016 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "baseband_profiler.hpp"
+
+#include "portapack_shared_memory.hpp"
+
+#include "hackrf_hal.hpp"
+using namespace hackrf::one;
+
+BasebandProfiler baseband_profiler;
+
+void BasebandProfiler::block(
+	const buffer_c8_t& buffer,
+	const uint32_t execute_cycles,
+	const uint32_t buffers_skipped
+) {
+	if( buffer.sampling_rate == 0 ) {
+		return;
+	}
+
+	const uint32_t budget = static_cast<uint64_t>(base_m4_clk_f) * buffer.count / buffer.sampling_rate;
+
+	execute.record(execute_cycles);
+	if( execute_cycles > budget ) {
+		overruns++;
+	}
+	skipped += buffers_skipped;
+
+	samples += buffer.count;
+	if( samples >= buffer.sampling_rate * report_interval ) {
+		BasebandProfile profile;
+		profile.execute = execute.capture();
+		profile.spectrum = spectrum.capture();
+		profile.events = events.capture();
+		profile.cycles_budget = budget;
+		profile.overruns = overruns;
+		profile.buffers_skipped = skipped;
+
+		BasebandProfileMessage message { profile };
+		shared_memory.application_queue.push(message);
+
+		overruns = 0;
+		skipped = 0;
+		samples = 0;
+	}
+}
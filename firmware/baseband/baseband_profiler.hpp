@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2016 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __BASEBAND_PROFILER_H__
+#define __BASEBAND_PROFILER_H__
+
+#include "ch.h"
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+/* Accumulates DWT cycle counts for one code path. record() may be called
+ * from a lower priority thread than capture(), so both lock briefly.
+ */
+class CycleProfiler {
+public:
+	static uint32_t now() {
+		return halGetCounterValue();
+	}
+
+	void record(const uint32_t cycles) {
+		chSysLock();
+		count++;
+		cycles_accum += cycles;
+		if( cycles < cycles_min ) cycles_min = cycles;
+		if( cycles > cycles_max ) cycles_max = cycles;
+		chSysUnlock();
+	}
+
+	CycleStatistics capture() {
+		chSysLock();
+		CycleStatistics result;
+		result.count = count;
+		result.cycles_min = count ? cycles_min : 0;
+		result.cycles_max = cycles_max;
+		result.cycles_avg = count ? (cycles_accum / count) : 0;
+		count = 0;
+		cycles_accum = 0;
+		cycles_min = std::numeric_limits<uint32_t>::max();
+		cycles_max = 0;
+		chSysUnlock();
+		return result;
+	}
+
+private:
+	uint32_t count { 0 };
+	uint64_t cycles_accum { 0 };
+	uint32_t cycles_min { std::numeric_limits<uint32_t>::max() };
+	uint32_t cycles_max { 0 };
+};
+
+/* Times processor execute() calls against the DMA block period, and
+ * periodically publishes a BasebandProfileMessage to the application
+ * along with the spectrum and event handler timings.
+ */
+class BasebandProfiler {
+public:
+	CycleProfiler spectrum { };
+	CycleProfiler events { };
+
+	void block(
+		const buffer_c8_t& buffer,
+		const uint32_t execute_cycles,
+		const uint32_t buffers_skipped
+	);
+
+private:
+	static constexpr float report_interval { 1.0f };
+
+	CycleProfiler execute { };
+	uint32_t overruns { 0 };
+	uint32_t skipped { 0 };
+	size_t samples { 0 };
+};
+
+extern BasebandProfiler baseband_profiler;
+
+#endif/*__BASEBAND_PROFILER_H__*/
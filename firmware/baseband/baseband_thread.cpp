@@ -27,6 +27,8 @@
 #include "baseband_sgpio.hpp"
 #include "baseband_dma.hpp"
 
+#include "baseband_profiler.hpp"
+
 #include "rssi.hpp"
 #include "i2s.hpp"
 using namespace lpc43xx;
@@ -83,16 +85,26 @@ void BasebandThread::run() {
 	baseband::dma::enable(direction());
 	baseband_sgpio.streaming_enable();
 
+	uint32_t transfers_seen = baseband::dma::transfers_completed();
+
 	while( !chThdShouldTerminate() ) {
 		// TODO: Place correct sampling rate into buffer returned here:
 		const auto buffer_tmp = baseband::dma::wait_for_buffer();
 		if( buffer_tmp ) {
+			const auto transfers = baseband::dma::transfers_completed();
+			const uint32_t buffers_skipped = transfers - transfers_seen - 1;
+			transfers_seen = transfers;
+
 			buffer_c8_t buffer {
 				buffer_tmp.p, buffer_tmp.count, sampling_rate
 			};
 
 			if( baseband_processor ) {
+				const auto start = CycleProfiler::now();
 				baseband_processor->execute(buffer);
+				const uint32_t execute_cycles = CycleProfiler::now() - start;
+
+				baseband_profiler.block(buffer, execute_cycles, buffers_skipped);
 			}
 		}
 	}
@@ -45,7 +45,7 @@ public:
 		}
 		count += src.count;
 
-		const size_t samples_per_update = src.sampling_rate * update_interval;
+		const size_t samples_per_update = src.sampling_rate / 1000 * update_interval_ms;
 
 		if( count >= samples_per_update ) {
 			const float max_squared_f = max_squared;
@@ -57,8 +57,13 @@ public:
 		}
 	}
 
+	void set_update_interval(const uint32_t new_update_interval_ms) {
+		update_interval_ms = new_update_interval_ms ? new_update_interval_ms : update_interval_ms_default;
+	}
+
 private:
-	static constexpr float update_interval { 0.1f };
+	static constexpr uint32_t update_interval_ms_default { 100 };
+	uint32_t update_interval_ms { update_interval_ms_default };
 	uint32_t max_squared { 0 };
 	size_t count { 0 };
 };
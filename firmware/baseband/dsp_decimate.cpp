@@ -21,7 +21,9 @@
 
 #include "dsp_decimate.hpp"
 
+#if defined(LPC43XX_M4)
 #include <hal.h>
+#endif
 
 namespace dsp {
 namespace decimate {
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_modulate.hpp"
+
+namespace dsp {
+namespace modulate {
+
+/*
+import numpy
+v = numpy.round(32767 * numpy.sin(numpy.arange(257) * (numpy.pi / 2 / 256)))
+print(v)
+*/
+const std::array<int16_t, 257> sine_quarter_q15 { {
+	0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+	2410, 2611, 2811, 3012, 3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609,
+	4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6786, 6983,
+	7179, 7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+	9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+	11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+	14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+	16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+	18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+	20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+	22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+	23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+	25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+	26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+	28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+	29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+	30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+	31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+	31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+	32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+	32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+	32757, 32761, 32765, 32766, 32767
+} };
+
+std::array<uint16_t, 1 << carrier_table_log2> carrier_c8;
+
+namespace {
+
+bool carrier_c8_ready { false };
+
+/* Writes count samples of carrier, advancing phase by delta before each.
+ * Two samples go out per 32-bit store once dst is word aligned.
+ */
+uint32_t write_carrier(complex8_t* const dst, size_t count, uint32_t phase, const uint32_t delta) {
+	auto p16 = reinterpret_cast<uint16_t*>(dst);
+	if( (reinterpret_cast<uintptr_t>(p16) & 2) && count ) {
+		phase += delta;
+		*(p16++) = carrier_packed(phase);
+		count--;
+	}
+
+	auto p32 = reinterpret_cast<uint32_t*>(p16);
+	for(; count >= 2; count -= 2) {
+		const uint32_t iq0 = carrier_packed(phase + delta);
+		phase += delta * 2;
+		const uint32_t iq1 = carrier_packed(phase);
+		*(p32++) = iq0 | (iq1 << 16);
+	}
+
+	if( count ) {
+		phase += delta;
+		*reinterpret_cast<uint16_t*>(p32) = carrier_packed(phase);
+	}
+
+	return phase;
+}
+
+} /* namespace */
+
+NCO::NCO() {
+	if( carrier_c8_ready ) {
+		return;
+	}
+
+	for(size_t n=0; n<carrier_c8.size(); n++) {
+		int32_t s, c;
+		sin_cos_q15(n << (32 - carrier_table_log2), s, c);
+		const uint32_t re = __SSAT((c + 0x80) >> 8, 8);
+		const uint32_t im = __SSAT((s + 0x80) >> 8, 8);
+		carrier_c8[n] = (re & 0xff) | ((im & 0xff) << 8);
+	}
+	carrier_c8_ready = true;
+}
+
+void CW::execute(const buffer_c8_t& dst, const uint32_t delta) {
+	phase_ = write_carrier(dst.p, dst.count, phase_, delta);
+}
+
+void FM::configure(const uint32_t k) {
+	k_ = k;
+}
+
+void FM::execute(const buffer_s16_t& src, const buffer_c8_t& dst) {
+	const size_t hold = dst.count / src.count;
+	for(size_t n=0; n<src.count; n++) {
+		const int32_t delta = (static_cast<int64_t>(src.p[n]) * k_) >> 8;
+		phase_ = write_carrier(&dst.p[n * hold], hold, phase_, delta);
+	}
+}
+
+void PM::configure(const uint32_t delta, const uint32_t k) {
+	delta_ = delta;
+	k_ = k;
+}
+
+void PM::execute(const buffer_s16_t& src, const buffer_c8_t& dst) {
+	const size_t hold = dst.count / src.count;
+	for(size_t n=0; n<src.count; n++) {
+		const uint32_t offset = (static_cast<int64_t>(src.p[n]) * k_) >> 8;
+		phase_ = write_carrier(&dst.p[n * hold], hold, phase_ + offset, delta_) - offset;
+	}
+}
+
+void AM::configure(const uint32_t delta) {
+	delta_ = delta;
+}
+
+void AM::execute(const buffer_s16_t& src, const buffer_c8_t& dst) {
+	const size_t hold = dst.count / src.count;
+	auto p = dst.p;
+	for(size_t n=0; n<src.count; n++) {
+		const int32_t a = src.p[n];
+		for(size_t i=0; i<hold; i++) {
+			phase_ += delta_;
+			int32_t s, c;
+			sin_cos_q15(phase_, s, c);
+			*(p++) = {
+				static_cast<int8_t>(__SSAT(((c * a >> 15) + 0x80) >> 8, 8)),
+				static_cast<int8_t>(__SSAT(((s * a >> 15) + 0x80) >> 8, 8))
+			};
+		}
+	}
+}
+
+} /* namespace modulate */
+} /* namespace dsp */
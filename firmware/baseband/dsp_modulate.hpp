@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_MODULATE_H__
+#define __DSP_MODULATE_H__
+
+#include "dsp_types.hpp"
+#include "simd.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace dsp {
+namespace modulate {
+
+/* A quarter wave of sine, Q15, in 256 steps plus the end point. Read with
+ * linear interpolation for tones and AM, where the resolution carries
+ * through to the output.
+ */
+extern const std::array<int16_t, 257> sine_quarter_q15;
+
+/* Sine and cosine, Q15, of a phase where 2^32 is a full turn. */
+static inline void sin_cos_q15(const uint32_t phase, int32_t& s, int32_t& c) {
+	const uint32_t x = (phase >> 22) & 0xff;
+	const int32_t frac = (phase >> 6) & 0xffff;
+	const int32_t s0 = sine_quarter_q15[x];
+	const int32_t c0 = sine_quarter_q15[256 - x];
+	const int32_t s1 = s0 + (((sine_quarter_q15[x + 1] - s0) * frac) >> 16);
+	const int32_t c1 = c0 + (((sine_quarter_q15[255 - x] - c0) * frac) >> 16);
+
+	switch(phase >> 30) {
+	case 0:  s =  s1; c =  c1; break;
+	case 1:  s =  c1; c = -s1; break;
+	case 2:  s = -s1; c = -c1; break;
+	default: s = -c1; c =  s1; break;
+	}
+}
+
+/* Sine alone, same phase scale. */
+static inline int32_t sin_q15(const uint32_t phase) {
+	const uint32_t x = (phase >> 22) & 0xff;
+	const int32_t frac = (phase >> 6) & 0xffff;
+	const uint32_t i0 = (phase & 0x40000000) ? (256 - x) : x;
+	const uint32_t i1 = (phase & 0x40000000) ? (255 - x) : (x + 1);
+	const int32_t a = sine_quarter_q15[i0];
+	const int32_t v = a + (((sine_quarter_q15[i1] - a) * frac) >> 16);
+	return (phase & 0x80000000) ? -v : v;
+}
+
+/* Carrier as C8 at 1024 points per turn, packed I in the low byte, Q in the
+ * high byte. Built from sine_quarter_q15 by the first NCO. One load per
+ * sample, and spurs around -60dBc against -45dBc from the 256 entry
+ * sine_table_i8. Interpolating can't do much better once rounded to 8 bits.
+ */
+constexpr size_t carrier_table_log2 = 10;
+extern std::array<uint16_t, 1 << carrier_table_log2> carrier_c8;
+
+static inline uint32_t carrier_packed(const uint32_t phase) {
+	return carrier_c8[phase >> (32 - carrier_table_log2)];
+}
+
+/* Phase accumulator shared by the modulators. */
+class NCO {
+public:
+	NCO();
+
+	/* Advances by delta and returns the carrier. For modulators that work
+	 * out a new frequency every sample.
+	 */
+	complex8_t next(const uint32_t delta) {
+		phase_ += delta;
+		const uint32_t iq = carrier_packed(phase_);
+		return { static_cast<int8_t>(iq), static_cast<int8_t>(iq >> 8) };
+	}
+
+	void reset() {
+		phase_ = 0;
+	}
+
+protected:
+	uint32_t phase_ { 0 };
+};
+
+/* Unmodulated carrier, delta per sample. */
+class CW : public NCO {
+public:
+	void execute(const buffer_c8_t& dst, const uint32_t delta);
+};
+
+/* Each source sample sets the carrier to k * sample / 256 per sample, for
+ * dst.count / src.count output samples. k is the increment for one step of
+ * an 8-bit sample, as the TX processors compute fm_delta.
+ */
+class FM : public NCO {
+public:
+	void configure(const uint32_t k);
+	void execute(const buffer_s16_t& src, const buffer_c8_t& dst);
+
+private:
+	int32_t k_ { 0 };
+};
+
+/* Carrier at delta per sample, its phase offset by k * sample / 256. Each
+ * source sample spans dst.count / src.count output samples.
+ */
+class PM : public NCO {
+public:
+	void configure(const uint32_t delta, const uint32_t k);
+	void execute(const buffer_s16_t& src, const buffer_c8_t& dst);
+
+private:
+	uint32_t delta_ { 0 };
+	int32_t k_ { 0 };
+};
+
+/* Carrier at delta per sample, scaled by the source sample (Q15, full scale
+ * is full carrier). Each source sample spans dst.count / src.count output
+ * samples.
+ */
+class AM : public NCO {
+public:
+	void configure(const uint32_t delta);
+	void execute(const buffer_s16_t& src, const buffer_c8_t& dst);
+
+private:
+	uint32_t delta_ { 0 };
+};
+
+} /* namespace modulate */
+} /* namespace dsp */
+
+#endif/*__DSP_MODULATE_H__*/
@@ -25,6 +25,8 @@
 
 #include "message_queue.hpp"
 
+#include "baseband_profiler.hpp"
+
 #include "ch.h"
 
 #include "lpc43xx_cpp.hpp"
@@ -80,7 +82,9 @@ eventmask_t EventDispatcher::wait() {
 
 void EventDispatcher::dispatch(const eventmask_t events) {
 	if( events & EVT_MASK_BASEBAND ) {
+		const auto start = CycleProfiler::now();
 		handle_baseband_queue();
+		baseband_profiler.events.record(CycleProfiler::now() - start);
 	}
 
 	if( events & EVT_MASK_SPECTRUM ) {
@@ -101,6 +105,13 @@ void EventDispatcher::on_message(const Message* const message) {
 		on_message_shutdown(*reinterpret_cast<const ShutdownMessage*>(message));
 		break;
 
+	case Message::ID::ChannelStatsConfig:
+		baseband_processor->set_channel_stats_interval(
+			reinterpret_cast<const ChannelStatsConfigMessage*>(message)->update_interval_ms
+		);
+		shared_memory.baseband_message = nullptr;
+		break;
+
 	default:
 		on_message_default(message);
 		shared_memory.baseband_message = nullptr;
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2016 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include "iq_stream_reader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+IQStreamReader::IQStreamReader(
+	ReplayConfig* const config
+) : format { config->format },
+	stream { config }
+{
+}
+
+size_t IQStreamReader::read(complex16_t* const p, const size_t count) {
+	const size_t block_samples = iq_format::block_samples(format);
+	const size_t block_bytes = iq_format::block_bytes(format);
+	const size_t blocks_max = encoded.size() / block_bytes;
+
+	size_t decoded = 0;
+	while( decoded < count ) {
+		const size_t blocks = std::min(blocks_max, (count - decoded) / block_samples);
+		if( blocks == 0 ) {
+			break;
+		}
+
+		const size_t bytes = blocks * block_bytes;
+		const size_t bytes_read = stream.read(&encoded[encoded_count], bytes - encoded_count);
+		bytes_read_ += bytes_read;
+		encoded_count += bytes_read;
+
+		const size_t complete = encoded_count / block_bytes;
+		iq_format::decode(format, encoded.data(), complete * block_samples, &p[decoded]);
+		decoded += complete * block_samples;
+
+		// Keep any partial block for next time.
+		const size_t used = complete * block_bytes;
+		memmove(encoded.data(), &encoded[used], encoded_count - used);
+		encoded_count -= used;
+
+		if( complete < blocks ) {
+			break;
+		}
+	}
+
+	return decoded;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2016 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2016 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef __IQ_STREAM_READER_H__
+#define __IQ_STREAM_READER_H__
+
+#include "message.hpp"
+#include "iq_format.hpp"
+#include "stream_output.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Reads and decodes IQ samples in the replay's file format. If the
+ * application falls behind and a read comes up short, a trailing partial
+ * block is kept and completed on the next read, so the decoder never loses
+ * block alignment.
+ */
+class IQStreamReader {
+public:
+	IQStreamReader(ReplayConfig* const config);
+
+	/* Returns the number of samples decoded, less than count if the stream
+	 * ran dry. count must be a whole number of blocks.
+	 */
+	size_t read(complex16_t* const p, const size_t count);
+
+	uint32_t bytes_read() const {
+		return bytes_read_;
+	}
+
+private:
+	const IQFormat format;
+	StreamOutput stream;
+	std::array<uint8_t, 512> encoded { };
+	size_t encoded_count { 0 };
+	uint32_t bytes_read_ { 0 };
+};
+
+#endif/*__IQ_STREAM_READER_H__*/
@@ -25,6 +25,7 @@
 #include <cmath>
 
 #include "utility.hpp"
+#include "simd.hpp"
 
 namespace dsp {
 namespace matched_filter {
@@ -103,5 +104,89 @@ void MatchedFilter::shift_by_decimation_factor() {
 	}
 }
 
+void MatchedFilterQ15::configure(
+	const tap_t* const taps,
+	const size_t taps_count,
+	const size_t decimation_factor
+) {
+	// Each dual multiply-accumulate adds at most |sample| * |tap|, so the
+	// accumulators stay in range as long as the sum of tap magnitudes,
+	// times the largest complex16_t magnitude, fits in 31 bits.
+	float magnitude_sum = 0.0f;
+	float component_max = 0.0f;
+	for(size_t n=0; n<taps_count; n++) {
+		magnitude_sum += std::abs(taps[n]);
+		component_max = std::max(component_max, std::max(std::abs(taps[n].real()), std::abs(taps[n].imag())));
+	}
+
+	size_t shift = 15;
+	while( (shift > 0) && (
+		(magnitude_sum * (1U << shift) * 46341.0f >= 2147483648.0f) ||
+		(component_max * (1U << shift) > 32767.0f)
+	) ) {
+		shift--;
+	}
+	const float scale = 1U << shift;
+
+	history_ = std::make_unique<words_t>(taps_count * 2);
+	taps_reversed_ = std::make_unique<words_t>(taps_count);
+	taps_count_ = taps_count;
+	decimation_factor_ = decimation_factor;
+	decimation_phase = 0;
+	history_index = 0;
+	output_scale = 1.0f / scale;
+	output = 0;
+
+	for(size_t n=0; n<taps_count; n++) {
+		const complex16_t tap {
+			static_cast<int16_t>(std::round(taps[n].real() * scale)),
+			static_cast<int16_t>(std::round(taps[n].imag() * scale))
+		};
+		taps_reversed_[taps_count - 1 - n] = tap.__rep();
+	}
+}
+
+bool MatchedFilterQ15::execute_once(
+	const complex16_t input
+) {
+	history_[history_index] = history_[history_index + taps_count_] = input.__rep();
+	if( ++history_index == taps_count_ ) {
+		history_index = 0;
+	}
+
+	advance_decimation_phase();
+	if( is_new_decimation_cycle() ) {
+		// Oldest sample first, like the shifted window in MatchedFilter.
+		const uint32_t* s = &history_[history_index];
+		const uint32_t* t = &taps_reversed_[0];
+
+		int32_t r_n = 0;
+		int32_t r_p = 0;
+		int32_t i_n = 0;
+		int32_t i_p = 0;
+		for(size_t n=0; n<taps_count_; n++) {
+			const auto sample = *(s++);
+			const auto tap = *(t++);
+
+			r_n = __SMLAD(sample, tap, r_n);	// sr*tr + si*ti
+			r_p = __SMLSD(sample, tap, r_p);	// sr*tr - si*ti
+			i_n = __SMLSDX(tap, sample, i_n);	// si*tr - sr*ti
+			i_p = __SMLADX(sample, tap, i_p);	// sr*ti + si*tr
+		}
+
+		const float rn = r_n;
+		const float rp = r_p;
+		const float in = i_n;
+		const float ip = i_p;
+		const auto mag_n = std::sqrt(rn * rn + in * in);
+		const auto mag_p = std::sqrt(rp * rp + ip * ip);
+		output = (mag_p - mag_n) * output_scale;
+
+		return true;
+	} else {
+		return false;
+	}
+}
+
 } /* namespace matched_filter */
 } /* namespace dsp */
@@ -23,9 +23,12 @@
 #define __MATCHED_FILTER_H__
 
 #include <cstddef>
+#include <cstdint>
 #include <complex>
 #include <memory>
 
+#include "complex.hpp"
+
 namespace dsp {
 namespace matched_filter {
 
@@ -90,6 +93,66 @@ private:
 	);
 };
 
+// Fixed-point equivalent of MatchedFilter, which stays as the floating-point
+// reference. Taps are quantized to Q15 (or less, if needed to keep the
+// accumulators from overflowing at full-scale input) and each tap costs four
+// dual 16-bit multiply-accumulates. Input samples go into a circular history
+// that is written twice over, so the current window is always contiguous,
+// and the dot product only runs on the decimation phase that yields output.
+
+class MatchedFilterQ15 {
+public:
+	using tap_t = std::complex<float>;
+
+	template<class T>
+	MatchedFilterQ15(
+		const T& taps,
+		size_t decimation_factor = 1
+	) {
+		configure(taps, decimation_factor);
+	}
+
+	template<class T>
+	void configure(
+		const T& taps,
+		size_t decimation_factor
+	) {
+		configure(taps.data(), taps.size(), decimation_factor);
+	}
+
+	bool execute_once(const complex16_t input);
+
+	float get_output() const {
+		return output;
+	}
+
+private:
+	using words_t = uint32_t[];
+
+	std::unique_ptr<words_t> history_ { };
+	std::unique_ptr<words_t> taps_reversed_ { };
+	size_t taps_count_ { 0 };
+	size_t decimation_factor_ { 1 };
+	size_t decimation_phase { 0 };
+	size_t history_index { 0 };
+	float output_scale { 1.0f };
+	float output { 0 };
+
+	void advance_decimation_phase() {
+		decimation_phase = (decimation_phase + 1) % decimation_factor_;
+	}
+
+	bool is_new_decimation_cycle() const {
+		return (decimation_phase == 0);
+	}
+
+	void configure(
+		const tap_t* const taps,
+		const size_t taps_count,
+		const size_t decimation_factor
+	);
+};
+
 } /* namespace matched_filter */
 } /* namespace dsp */
 
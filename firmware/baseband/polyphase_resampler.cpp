@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "polyphase_resampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace dsp {
+namespace interpolation {
+
+namespace {
+
+/* Blackman-windowed sinc, cutoff relative to the prototype's sample rate. */
+float prototype_tap(const size_t n, const size_t length, const float cutoff) {
+	const float t = n - (length - 1) * 0.5f;
+	const float sinc = (t == 0.0f) ? (2.0f * cutoff) : (std::sin(2.0f * pi * cutoff * t) / (pi * t));
+	const float x = (n + 1.0f) / (length + 1.0f);
+	const float window = 0.42f - 0.5f * std::cos(2.0f * pi * x) + 0.08f * std::cos(4.0f * pi * x);
+	return sinc * window;
+}
+
+/* Splits the prototype into phases of taps_per_phase Q15 taps, oldest sample
+ * first, with unity gain through each phase. Taps are computed twice rather
+ * than kept in a float array, to spare the stack.
+ */
+void design_phases(
+	vec2_s16* const taps,
+	const size_t phases,
+	const size_t taps_per_phase,
+	const float cutoff
+) {
+	const size_t length = phases * taps_per_phase;
+	float sum = 0.0f;
+	for(size_t n=0; n<length; n++) {
+		sum += prototype_tap(n, length, cutoff);
+	}
+
+	for(size_t p=0; p<phases; p++) {
+		for(size_t k=0; k<taps_per_phase; k++) {
+			const float tap = prototype_tap(p + (taps_per_phase - 1 - k) * phases, length, cutoff) * phases / sum;
+			const int32_t tap_q15 = std::lround(tap * 32768.0f);
+			taps[(p * taps_per_phase + k) / 2].v[k & 1] = __SSAT(tap_q15, 16);
+		}
+	}
+}
+
+} /* namespace */
+
+bool PolyphaseResampler::configure(const uint32_t input_rate, const uint32_t output_rate) {
+	if( (input_rate == 0) || (output_rate == 0) ) {
+		return false;
+	}
+
+	const auto divisor = std::gcd(input_rate, output_rate);
+	const uint32_t l = output_rate / divisor;
+	const uint32_t m = input_rate / divisor;
+	if( l > phases_max ) {
+		return false;
+	}
+
+	interpolation = l;
+	decimation = m;
+
+	if( (l == 1) && (m == 1) ) {
+		// Passed through as is
+		taps.fill({ });
+		taps[pairs_per_phase - 1] = { 0, 32767 };
+	} else {
+		// Prototype at the interpolated rate, cut off at the lower of the two
+		// Nyquist frequencies.
+		design_phases(taps.data(), l, taps_per_phase, 0.5f / std::max(l, m));
+	}
+
+	reset();
+	return true;
+}
+
+void PolyphaseResampler::reset() {
+	history_i.fill({ });
+	history_q.fill({ });
+	phase = 0;
+}
+
+void PolyphaseResampler::push(const complex16_t sample) {
+	// Shift the history one sample towards the oldest end
+	for(size_t n=0; n<pairs_per_phase - 1; n++) {
+		history_i[n].w = (history_i[n].w >> 16) | (history_i[n + 1].w << 16);
+		history_q[n].w = (history_q[n].w >> 16) | (history_q[n + 1].w << 16);
+	}
+	auto& newest_i = history_i[pairs_per_phase - 1];
+	auto& newest_q = history_q[pairs_per_phase - 1];
+	newest_i.w = (newest_i.w >> 16) | (static_cast<uint32_t>(sample.real()) << 16);
+	newest_q.w = (newest_q.w >> 16) | (static_cast<uint32_t>(sample.imag()) << 16);
+}
+
+PolyphaseResampler::Result PolyphaseResampler::execute(
+	const complex16_t* const in,
+	const size_t in_count,
+	complex8_t* const out,
+	const size_t out_count
+) {
+	size_t consumed = 0;
+	size_t produced = 0;
+
+	while( produced < out_count ) {
+		while( phase >= interpolation ) {
+			if( consumed == in_count ) {
+				return { consumed, produced };
+			}
+			push(in[consumed++]);
+			phase -= interpolation;
+		}
+
+		const auto t = &taps[phase * pairs_per_phase];
+		int32_t i = 1 << 22;
+		int32_t q = 1 << 22;
+		for(size_t n=0; n<pairs_per_phase; n++) {
+			i = smlad(history_i[n], t[n], i);
+			q = smlad(history_q[n], t[n], q);
+		}
+
+		// Q15 taps, and C16 to C8
+		out[produced++] = {
+			static_cast<int8_t>(__SSAT(i >> 23, 8)),
+			static_cast<int8_t>(__SSAT(q >> 23, 8))
+		};
+
+		phase += decimation;
+	}
+
+	return { consumed, produced };
+}
+
+bool AudioResampler::configure(const uint32_t input_rate, const uint32_t output_rate) {
+	if( (input_rate == 0) || (input_rate >= output_rate) ) {
+		return false;
+	}
+
+	// Input rate as a 0.32 fraction of the output rate
+	step = (static_cast<uint64_t>(input_rate) << 32) / output_rate;
+
+	// Prototype at phases times the input rate, cut off at its Nyquist frequency
+	design_phases(taps.data(), phases, taps_per_phase, 0.5f / phases);
+
+	reset();
+	return true;
+}
+
+void AudioResampler::reset() {
+	history.fill({ });
+	phase = 0;
+	need_input = true;
+}
+
+void AudioResampler::push(const int16_t sample) {
+	for(size_t n=0; n<pairs_per_phase - 1; n++) {
+		history[n].w = (history[n].w >> 16) | (history[n + 1].w << 16);
+	}
+	auto& newest = history[pairs_per_phase - 1];
+	newest.w = (newest.w >> 16) | (static_cast<uint32_t>(sample) << 16);
+}
+
+AudioResampler::Result AudioResampler::execute(
+	const int16_t* const in,
+	const size_t in_count,
+	int16_t* const out,
+	const size_t out_count
+) {
+	size_t consumed = 0;
+	size_t produced = 0;
+
+	while( produced < out_count ) {
+		if( need_input ) {
+			if( consumed == in_count ) {
+				break;
+			}
+			push(in[consumed++]);
+			need_input = false;
+		}
+
+		// Nearest phase at or before the output's position between inputs
+		const auto t = &taps[(phase >> phase_shift) * pairs_per_phase];
+		int32_t acc = 1 << 14;
+		for(size_t n=0; n<pairs_per_phase; n++) {
+			acc = smlad(history[n], t[n], acc);
+		}
+		out[produced++] = __SSAT(acc >> 15, 16);
+
+		const uint32_t next_phase = phase + step;
+		need_input = (next_phase < phase);
+		phase = next_phase;
+	}
+
+	return { consumed, produced };
+}
+
+} /* namespace interpolation */
+} /* namespace dsp */
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __POLYPHASE_RESAMPLER_H__
+#define __POLYPHASE_RESAMPLER_H__
+
+#include "complex.hpp"
+#include "simd.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace dsp {
+namespace interpolation {
+
+/* Resamples complex16_t to complex8_t by any rational ratio L/M whose
+ * reduced interpolation factor L is at most phases_max. A windowed-sinc
+ * low-pass is designed at L times the input rate and split into L phases
+ * of taps_per_phase Q15 taps. Each output sample is one phase's dot product
+ * with the input history, so the cost per output doesn't depend on the
+ * ratio.
+ */
+class PolyphaseResampler {
+public:
+	static constexpr size_t taps_per_phase = 8;
+	static constexpr size_t phases_max = 32;
+
+	struct Result {
+		size_t consumed;
+		size_t produced;
+	};
+
+	/* Returns false if the ratio needs more than phases_max phases. */
+	bool configure(const uint32_t input_rate, const uint32_t output_rate);
+
+	void reset();
+
+	/* Produces up to out_count samples, stopping early if the input runs
+	 * out. Resampling state carries over between calls.
+	 */
+	Result execute(
+		const complex16_t* const in,
+		const size_t in_count,
+		complex8_t* const out,
+		const size_t out_count
+	);
+
+private:
+	static constexpr size_t pairs_per_phase = taps_per_phase / 2;
+
+	// Taps for each phase, paired for dual multiply-accumulate, oldest sample first
+	std::array<vec2_s16, phases_max * pairs_per_phase> taps { };
+	std::array<vec2_s16, pairs_per_phase> history_i { };
+	std::array<vec2_s16, pairs_per_phase> history_q { };
+	uint32_t interpolation { 1 };
+	uint32_t decimation { 1 };
+	uint32_t phase { 0 };
+
+	void push(const complex16_t sample);
+};
+
+/* Resamples 16-bit audio up to a higher rate by any ratio. The output's
+ * position between input samples is tracked as a 0.32 fraction, and its top
+ * bits pick one of phases filter phases, so no ratio needs more taps.
+ */
+class AudioResampler {
+public:
+	static constexpr size_t taps_per_phase = 16;
+	static constexpr size_t phases = 64;
+
+	struct Result {
+		size_t consumed;
+		size_t produced;
+	};
+
+	/* Returns false unless output_rate is above input_rate. */
+	bool configure(const uint32_t input_rate, const uint32_t output_rate);
+
+	void reset();
+
+	Result execute(
+		const int16_t* const in,
+		const size_t in_count,
+		int16_t* const out,
+		const size_t out_count
+	);
+
+private:
+	static constexpr size_t pairs_per_phase = taps_per_phase / 2;
+	static constexpr size_t phase_shift = 26;	// 32 - log2(phases)
+
+	std::array<vec2_s16, phases * pairs_per_phase> taps { };
+	std::array<vec2_s16, pairs_per_phase> history { };
+	uint32_t step { 0 };
+	uint32_t phase { 0 };
+	bool need_input { true };
+
+	void push(const int16_t sample);
+};
+
+} /* namespace interpolation */
+} /* namespace dsp */
+
+#endif/*__POLYPHASE_RESAMPLER_H__*/
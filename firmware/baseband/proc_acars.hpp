@@ -114,7 +114,7 @@ private:
 
 	dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };	// Translate already done here !
 	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
-	dsp::matched_filter::MatchedFilter mf { rect_taps_38k4_4k8_1t_2k4_p, 8 };
+	dsp::matched_filter::MatchedFilterQ15 mf { rect_taps_38k4_4k8_1t_2k4_p, 8 };
 
 	clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery {
 		4800, 2400, { 0.0555f },
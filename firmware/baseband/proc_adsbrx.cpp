@@ -27,123 +27,210 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <algorithm>
 
 using namespace adsb;
+
+bool ADSBRXProcessor::check_preamble(const uint32_t start, const uint8_t phase, Candidate& result) const {
+	// Pulses at 0, 1, 3.5 and 4.5us
+	const uint32_t p0 = power(start + 0, phase);
+	const uint32_t p2 = power(start + 2, phase);
+	const uint32_t p7 = power(start + 7, phase);
+	const uint32_t p9 = power(start + 9, phase);
 	
-void ADSBRXProcessor::execute(const buffer_c8_t& buffer) {
-	int8_t re, im;
-	float mag;
-	uint32_t c;
-	uint8_t level, bit, byte { };
-	//bool confidence;
-	bool first_in_window, last_in_window;
+	const uint32_t q1 = power(start + 1, phase);
+	const uint32_t q3 = power(start + 3, phase);
+	const uint32_t q6 = power(start + 6, phase);
+	const uint32_t q8 = power(start + 8, phase);
+	const uint32_t q10 = power(start + 10, phase);
+	
+	// Pulses must stand out from their neighbours. With pulses straddling
+	// samples, the gaps between the pulse pairs get half of each pulse.
+	if ((p2 <= q3) || (p7 <= q6) || (p9 <= q10))
+		return false;
+	if ((phase == 0) && ((p0 <= q1) || (p2 <= q1) || (p7 <= q8) || (p9 <= q8)))
+		return false;
+	
+	const uint32_t pulse_min = std::min(std::min(p0, p2), std::min(p7, p9));
+	if (pulse_min < power_blank * 2)
+		return false;
+	
+	uint32_t quiet = q1 + q3 + q6 + q8 + q10;
+	quiet += power(start + 4, phase) + power(start + 5, phase);
+	for (uint32_t c = 11; c < ADSB_PREAMBLE_LENGTH; c++)
+		quiet += power(start + c, phase);
+	
+	// The 12 quiet samples must average 3dB under the weakest pulse
+	if (pulse_min * 6 <= quiet)
+		return false;
 	
+	const uint32_t pulses = p0 + p2 + p7 + p9;
+	result.valid = true;
+	result.start = start;
+	result.phase = phase;
+	result.score = (int32_t)(pulses * 3) - (int32_t)quiet;
+	result.level = pulses / 4;
+	return true;
+}
+
+void ADSBRXProcessor::start_decoder(const Candidate& preamble) {
+	Decoder* slot = nullptr;
+	
+	stats_preambles++;
+	
+	for (auto& decoder : decoders) {
+		if (!decoder.active)
+			continue;
+		
+		// Not clearly stronger than a frame in flight: most likely its own data bits
+		if (preamble.level < decoder.level * 2)
+			return;
+		
+		if (!slot || (decoder.level < slot->level))
+			slot = &decoder;
+	}
+	
+	// Prefer a free decoder, else take over the weakest one
+	for (auto& decoder : decoders) {
+		if (!decoder.active) {
+			slot = &decoder;
+			break;
+		}
+	}
+	
+	slot->active = true;
+	slot->start = preamble.start + ADSB_PREAMBLE_LENGTH;
+	slot->phase = preamble.phase;
+	slot->level = preamble.level;
+	slot->threshold_low = preamble.level / 2;		// -3dB
+	slot->bit_count = 0;
+	slot->bit_total = 112;
+	slot->null_count = 0;
+	slot->byte = 0;
+	slot->prev_bit = 1;		// Quiet end of preamble, same as a 1 for the next bit
+	slot->frame.clear();
+}
+
+void ADSBRXProcessor::decode(Decoder& decoder) {
+	// Decoders can start a few samples late, so catch up on every complete bit
+	while (decoder.active) {
+		const uint32_t first = decoder.start + (decoder.bit_count * 2);
+		if ((int32_t)(sample_index - (first + 1 + decoder.phase)) < 0)
+			return;
+		
+		const uint32_t p0 = power(first, decoder.phase);
+		const uint32_t p1 = power(first + 1, decoder.phase);
+		
+		if ((p0 < decoder.threshold_low) && (p1 < decoder.threshold_low)) {
+			// Both under window, silence.
+			if (++decoder.null_count > 3) {
+				decoder.active = false;
+				return;
+			}
+		} else {
+			decoder.null_count = 0;
+		}
+		
+		uint8_t bit;
+		if (decoder.phase == 0) {
+			bit = (p0 > p1) ? 1 : 0;
+		} else {
+			/* Chips straddle samples: the middle sample gets half of the pulse
+			 * either way, compare the outer ones. Those also get half of the
+			 * neighbouring bits' pulses, which makes 111 and 000 look the same:
+			 * a tie repeats the previous bit.
+			 */
+			const uint32_t h0 = history[first & history_mask];
+			const uint32_t h2 = history[(first + 2) & history_mask];
+			const uint32_t tie = decoder.level / 4;
+			if (h0 > h2 + tie)
+				bit = 1;
+			else if (h2 > h0 + tie)
+				bit = 0;
+			else
+				bit = decoder.prev_bit;
+		}
+		decoder.prev_bit = bit;
+		
+		decoder.byte = (decoder.byte << 1) | bit;
+		decoder.bit_count++;
+		
+		if (decoder.bit_count == 5)		// DF known: 56 or 112 bits
+			decoder.bit_total = (decoder.byte & 0x10) ? 112 : 56;
+		
+		if (!(decoder.bit_count & 7))
+			decoder.frame.push_byte(decoder.byte);
+		
+		if (decoder.bit_count == decoder.bit_total) {
+			const ADSBFrameMessage message(decoder.frame);
+			shared_memory.application_queue.push(message);
+			stats_frames++;
+			decoder.active = false;
+		}
+	}
+}
+
+void ADSBRXProcessor::execute(const buffer_c8_t& buffer) {
 	// This is called at 2M/2048 = 977Hz
-	// One pulse = 500ns = 2 samples
-	// One bit = 2 pulses = 1us = 4 samples
+	// One pulse = 500ns = 1 sample
+	// One bit = 2 pulses = 1us = 2 samples
 	
 	if (!configured) return;
 	
 	for (size_t i = 0; i < buffer.count; i++) {
 		
-		// Compute sample's magnitude
-		re = buffer.p[i].real();
-		im = buffer.p[i].imag();
-		mag = __builtin_sqrtf((re * re) + (im * im)) * k;
+		// Compare powers, no need for the magnitude
+		const int32_t re = buffer.p[i].real();
+		const int32_t im = buffer.p[i].imag();
+		history[sample_index & history_mask] = (re * re) + (im * im);
 		
-		// Only used for preamble detection and visualisation
-		level = (mag < 0.3) ? 0 :		// Blank weak signals
-					(mag > prev_mag) ? 1 : 0;
+		for (auto& decoder : decoders)
+			decode(decoder);
 		
-		if (decoding) {
-			// Decode
-			
-			// 1 bit lasts 2 samples
-			if (sample_count & 1) {
-				if ((prev_mag < threshold_low) && (mag < threshold_low)) {
-					// Both under window, silence.
-					if (null_count > 3) {
-						const ADSBFrameMessage message(frame);
-						shared_memory.application_queue.push(message);
-							
-						decoding = false;
-					} else
-						null_count++;
-						
-					//confidence = false;
-					if (prev_mag > mag)
-						bit = 1;
-					else
-						bit = 0;
-					
-				} else {
-					
-					null_count = 0;
-				
-					first_in_window = ((prev_mag >= threshold_low) && (prev_mag <= threshold_high));
-					last_in_window = ((mag >= threshold_low) && (mag <= threshold_high));
-					
-					if ((first_in_window && !last_in_window) || (!first_in_window && last_in_window)) {
-						//confidence = true;
-						if (prev_mag > mag)
-							bit = 1;
-						else
-							bit = 0;
-					} else {
-						//confidence = false;
-						if (prev_mag > mag)
-							bit = 1;
-						else
-							bit = 0;
-					}
-				}
-				
-				byte = bit | (byte << 1);
-				bit_count++;
-				if (!(bit_count & 7)) {
-					// Got one byte
-					frame.push_byte(byte);
-				}
-			}
-			sample_count++;
-		} else {
-			// Look for preamble
-			
-			// Shift
-			for (c = 0; c < (ADSB_PREAMBLE_LENGTH - 1); c++)
-				shifter[c] = shifter[c + 1];
-			shifter[15] = std::make_pair(mag, level);
-			
-			// Compare
-			for (c = 0; c < ADSB_PREAMBLE_LENGTH; c++) {
-				if (shifter[c].second != adsb_preamble[c])
-					break;
-			}
-				
-			if (c == ADSB_PREAMBLE_LENGTH) {
-				decoding = true;
-				sample_count = 0;
-				null_count = 0;
-				bit_count = 0;
-				frame.clear();
-				
-				// Compute preamble pulses power to set thresholds
-				threshold = (shifter[0].first + shifter[2].first + shifter[7].first + shifter[9].first) / 4;
-				threshold_high = threshold * 1.414;		// +3dB
-				threshold_low = threshold * 0.707;		// -3dB
-			}
+		// Preamble that just ended (phase 1 needs one more sample)
+		const uint32_t start = sample_index - ADSB_PREAMBLE_LENGTH;
+		Candidate found { };
+		if (power(start, 1) >= power_blank) {
+			Candidate found_phase_1 { };
+			check_preamble(start, 0, found);
+			if (check_preamble(start, 1, found_phase_1) && (!found.valid || (found_phase_1.score > found.score)))
+				found = found_phase_1;
 		}
 		
-		prev_mag = mag;
+		// Keep the best scoring of adjacent detections, they're the same frame
+		if (found.valid && (!candidate.valid || (found.score > candidate.score))) {
+			candidate = found;
+		} else if (candidate.valid) {
+			start_decoder(candidate);
+			candidate.valid = false;
+		}
+		
+		sample_index++;
+	}
+	
+	stats_samples += buffer.count;
+	if (stats_samples >= baseband_fs) {
+		const ADSBStatisticsMessage message { stats_preambles, stats_frames };
+		shared_memory.application_queue.push(message);
+		stats_samples = 0;
+		stats_preambles = 0;
+		stats_frames = 0;
 	}
 }
 
+void ADSBRXProcessor::reset() {
+	history.fill(0);
+	candidate.valid = false;
+	for (auto& decoder : decoders)
+		decoder.active = false;
+	stats_samples = 0;
+	stats_preambles = 0;
+	stats_frames = 0;
+}
+
 void ADSBRXProcessor::on_message(const Message* const message) {
 	if (message->id == Message::ID::ADSBConfigure) {
-		null_count = 0;
-		bit_count = 0;
-		sample_count = 0;
-		decoding = false;
+		reset();
 		configured = true;
 	}
 }
@@ -29,9 +29,12 @@
 
 #include "adsb_frame.hpp"
 
+#include <array>
+
 using namespace adsb;
 
 #define ADSB_PREAMBLE_LENGTH 16
+#define ADSB_DECODERS 4		// Frames that can be decoded at the same time
 
 class ADSBRXProcessor : public BasebandProcessor {
 public:
@@ -40,25 +43,62 @@ public:
 	void on_message(const Message* const message) override;
 
 private:
-	static constexpr float k = 1.0f / 128.0f;
-	
 	static constexpr size_t baseband_fs = 2000000;
 	
+	// Sample powers (I^2 + Q^2), only needs to cover the preamble and a bit
+	static constexpr size_t history_size = 32;
+	static constexpr uint32_t history_mask = history_size - 1;
+	
+	// Blank weak signals, (0.3 * 128)^2
+	static constexpr uint32_t power_blank = 1474;
+	
+	/* Pulses are 500ns, one sample at 2Msps. Phase 0 looks at single samples
+	 * (doubled, to keep the same scale), phase 1 at the sum of two adjacent
+	 * samples, which catches pulses straddling a sample boundary.
+	 */
+	struct Candidate {
+		bool valid;
+		uint32_t start;			// Sample index of the first preamble pulse
+		uint8_t phase;
+		int32_t score;
+		uint32_t level;			// Mean pulse power
+	};
+	
+	struct Decoder {
+		bool active;
+		uint32_t start;			// Sample index of the first data bit
+		uint8_t phase;
+		uint32_t level;
+		uint32_t threshold_low;
+		size_t bit_count;
+		size_t bit_total;
+		size_t null_count;
+		uint8_t byte;
+		uint8_t prev_bit;
+		ADSBFrame frame;
+	};
+	
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 	
-	ADSBFrame frame { };
 	bool configured { false };
-	float prev_mag { 0 };
-	float threshold { }, threshold_low { }, threshold_high { };
-	size_t null_count { 0 }, bit_count { 0 }, sample_count { 0 };
-	std::pair<float, uint8_t> shifter[ADSB_PREAMBLE_LENGTH];
-	bool decoding { };
-	bool preamble { }, active { };
-    uint16_t bit_pos { 0 };
-    uint8_t cur_bit { 0 };
-	uint32_t sample { 0 };
-	int8_t re { }, im { };
+	std::array<uint16_t, history_size> history { };
+	uint32_t sample_index { 0 };
+	Candidate candidate { };
+	std::array<Decoder, ADSB_DECODERS> decoders { };
+	
+	uint32_t stats_samples { 0 };
+	uint32_t stats_preambles { 0 };
+	uint32_t stats_frames { 0 };
+	
+	uint32_t power(const uint32_t index, const uint8_t phase) const {
+		return history[index & history_mask] + history[(index + phase) & history_mask];
+	}
+	
+	bool check_preamble(const uint32_t start, const uint8_t phase, Candidate& result) const;
+	void start_decoder(const Candidate& preamble);
+	void decode(Decoder& decoder);
+	void reset();
 };
 
 #endif
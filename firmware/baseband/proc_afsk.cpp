@@ -22,7 +22,6 @@
 
 #include "proc_afsk.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
@@ -79,17 +78,11 @@ void AFSKProcessor::execute(const buffer_c8_t& buffer) {
 		else
 			tone_phase += afsk_phase_inc_space;
 
-		tone_sample = sine_table_i8[(tone_phase & 0xFF000000U) >> 24];
+		tone_sample = dsp::modulate::sin_q15(tone_phase) >> 8;
 
 		delta = tone_sample * fm_delta;
 		
-		phase += delta;
-		sphase = phase + (64 << 24);
-
-		re = (sine_table_i8[(sphase & 0xFF000000U) >> 24]);
-		im = (sine_table_i8[(phase & 0xFF000000U) >> 24]);
-			
-		buffer.p[i] = {re, im};
+		buffer.p[i] = nco.next(delta);
 	}
 }
 
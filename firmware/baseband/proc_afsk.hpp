@@ -25,6 +25,7 @@
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
+#include "dsp_modulate.hpp"
 
 #define AFSK_SAMPLERATE 1536000
 #define AFSK_DELTA_COEF ((1ULL << 32) / AFSK_SAMPLERATE)
@@ -53,10 +54,10 @@ private:
     uint16_t cur_word { 0 };
     uint8_t cur_bit { 0 };
     uint32_t sample_count { 0 };
-	uint32_t tone_phase { 0 }, phase { 0 }, sphase { 0 };
+	uint32_t tone_phase { 0 };
 	int32_t tone_sample { 0 }, delta { 0 };
 	
-	int8_t re { 0 }, im { 0 };
+	dsp::modulate::NCO nco { };
 	
 	TXProgressMessage txprogress_message { };
 };
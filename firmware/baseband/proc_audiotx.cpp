@@ -22,50 +22,97 @@
 
 #include "proc_audiotx.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
+#include <cmath>
 
 void AudioTXProcessor::execute(const buffer_c8_t& buffer){
 	
 	if (!configured) return;
 	
-	// Zero-order hold (poop)
-	for (size_t i = 0; i < buffer.count; i++) {
-		resample_acc += resample_inc;
-		if (resample_acc >= 0x10000) {
-			resample_acc -= 0x10000;
-			if (stream) {
-				stream->read(&audio_sample, 1);
-				bytes_read++;
-			}
-		}
-		
-		sample = tone_gen.process(audio_sample - 0x80);
-		
-		// FM
-		delta = sample * fm_delta;
+	const size_t resampled_count = buffer.count / audio_decimation;
+	size_t produced = 0;
+	while (produced < resampled_count) {
+		if (audio_index == audio_count)
+			refill_audio();
 		
-		phase += delta;
-		sphase = phase + (64 << 24);
-		
-		re = sine_table_i8[(sphase & 0xFF000000U) >> 24];
-		im = sine_table_i8[(phase & 0xFF000000U) >> 24];
-		
-		buffer.p[i] = { (int8_t)re, (int8_t)im };
+		const auto result = resampler.execute(
+			&audio[audio_index], audio_count - audio_index,
+			&audio_resampled[produced], resampled_count - produced
+		);
+		audio_index += result.consumed;
+		produced += result.produced;
 	}
 	
+	for (size_t i = 0; i < resampled_count; i++)
+		audio_resampled[i] = __SSAT(tone_gen.process_s16(audio_resampled[i]), 16);
+	
+	fm.execute({ audio_resampled.data(), resampled_count }, buffer);
+	
 	progress_samples += buffer.count;
 	if (progress_samples >= progress_interval_samples) {
 		progress_samples -= progress_interval_samples;
 		
-		txprogress_message.progress = bytes_read;	// Inform UI about progress
+		txprogress_message.progress = bytes_read / bytes_per_sample;	// Inform UI about progress
+		txprogress_message.underruns = underruns;
 		txprogress_message.done = false;
 		shared_memory.application_queue.push(txprogress_message);
 	}
 }
 
+void AudioTXProcessor::refill_audio() {
+	// Read as many whole samples as the FIFO has, up to one block of audio
+	const size_t bytes = stream ? stream->read(&raw[raw_count], (audio.size() * bytes_per_sample) - raw_count) : 0;
+	bytes_read += bytes;
+	raw_count += bytes;
+	
+	audio_index = 0;
+	audio_count = raw_count / bytes_per_sample;
+	
+	if (!audio_count) {
+		// The application fell behind, send silence rather than stall
+		audio.fill(0);
+		audio_count = audio.size();
+		if (stream) underruns++;
+		return;
+	}
+	
+	for (size_t i = 0; i < audio_count; i++) {
+		int32_t x;
+		if (bytes_per_sample == 2)
+			x = (int16_t)(raw[i * 2] | (raw[i * 2 + 1] << 8));
+		else
+			x = (raw[i] - 0x80) << 8;
+		
+		if (pre_emphasis_us) {
+			// b0 and b1 pass 16 bits at high rates, the products need 64
+			const int32_t y = ((int64_t)pre_emphasis_b0 * x - (int64_t)pre_emphasis_b1 * pre_emphasis_x1) >> 12;
+			pre_emphasis_x1 = x;
+			x = __SSAT(y, 16);
+		}
+		
+		audio[i] = x;
+	}
+	
+	// Keep a partial sample for next time
+	const size_t used = audio_count * bytes_per_sample;
+	for (size_t i = used; i < raw_count; i++)
+		raw[i - used] = raw[i];
+	raw_count -= used;
+}
+
+void AudioTXProcessor::update_pre_emphasis() {
+	if (!pre_emphasis_us || !sample_rate)
+		return;
+	
+	// First order high-pass shelf, unity gain at DC
+	const float a = std::exp(-1000000.0f / (pre_emphasis_us * (float)sample_rate));
+	pre_emphasis_b0 = 4096.0f / (1.0f - a);
+	pre_emphasis_b1 = 4096.0f * a / (1.0f - a);
+	pre_emphasis_x1 = 0;
+}
+
 void AudioTXProcessor::on_message(const Message* const message) {
 	switch(message->id) {
 		case Message::ID::AudioTXConfig:
@@ -83,7 +130,7 @@ void AudioTXProcessor::on_message(const Message* const message) {
 			break;
 		
 		case Message::ID::FIFOData:
-			configured = true;
+			configured = rate_supported;
 			break;
 		
 		default:
@@ -92,16 +139,25 @@ void AudioTXProcessor::on_message(const Message* const message) {
 }
 
 void AudioTXProcessor::audio_config(const AudioTXConfigMessage& message) {
-	fm_delta = message.deviation_hz * (0xFFFFFFULL / baseband_fs);
-	tone_gen.configure(message.tone_key_delta, message.tone_key_mix_weight);
+	fm.configure(message.deviation_hz * (0xFFFFFFULL / baseband_fs));
+	// Tone deltas are given for the baseband rate, the tone is mixed at audio_fs
+	tone_gen.configure(message.tone_key_delta * audio_decimation, message.tone_key_mix_weight);
 	progress_interval_samples = message.divider;
-	resample_acc = 0;
+	bytes_per_sample = (message.bits_per_sample == 16) ? 2 : 1;
+	pre_emphasis_us = message.pre_emphasis_us;
+	update_pre_emphasis();
 }
 
 void AudioTXProcessor::replay_config(const ReplayConfigMessage& message) {
 	if( message.config ) {
 		
 		stream = std::make_unique<StreamOutput>(message.config);
+		raw_count = 0;
+		audio_index = 0;
+		audio_count = 0;
+		underruns = 0;
+		pre_emphasis_x1 = 0;
+		resampler.reset();
 		
 		// Tell application that the buffers and FIFO pointers are ready, prefill
 		shared_memory.application_queue.push(sig_message);
@@ -111,7 +167,16 @@ void AudioTXProcessor::replay_config(const ReplayConfigMessage& message) {
 }
 
 void AudioTXProcessor::samplerate_config(const SamplerateConfigMessage& message) {
-	resample_inc = (((uint64_t)message.sample_rate) << 16) / baseband_fs;	// 16.16 fixed point message.sample_rate
+	sample_rate = message.sample_rate;
+	rate_supported = resampler.configure(sample_rate, audio_fs);
+	if (!rate_supported) {
+		// Only upsampling, audio_fs and above can't be played
+		txprogress_message.done = true;
+		txprogress_message.error = true;
+		shared_memory.application_queue.push(txprogress_message);
+		txprogress_message.error = false;
+	}
+	update_pre_emphasis();
 }
 
 int main() {
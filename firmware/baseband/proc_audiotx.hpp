@@ -27,6 +27,11 @@
 #include "baseband_thread.hpp"
 #include "tone_gen.hpp"
 #include "stream_output.hpp"
+#include "polyphase_resampler.hpp"
+#include "dsp_modulate.hpp"
+
+#include <array>
+#include <memory>
 
 class AudioTXProcessor : public BasebandProcessor {
 public:
@@ -36,6 +41,10 @@ public:
 
 private:
 	static constexpr size_t baseband_fs = 1536000;
+	// Audio is resampled to baseband_fs / audio_decimation, each sample then
+	// sets the FM frequency for audio_decimation baseband samples.
+	static constexpr size_t audio_decimation = 8;
+	static constexpr size_t audio_fs = baseband_fs / audio_decimation;
 	
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit };
 	
@@ -43,17 +52,35 @@ private:
 	
 	ToneGen tone_gen { };
 	
-	uint32_t resample_inc { }, resample_acc { };
-	uint32_t fm_delta { 0 };
-	uint32_t phase { 0 }, sphase { 0 };
-	uint8_t audio_sample { };
-	int32_t sample { 0 }, delta { };
-	int8_t re { 0 }, im { 0 };
+	// Raw file data, then the same samples as signed 16-bit
+	std::array<uint8_t, 128> raw { };
+	size_t raw_count { 0 };
+	std::array<int16_t, 64> audio { };
+	size_t audio_index { 0 };
+	size_t audio_count { 0 };
+	std::array<int16_t, 2048 / audio_decimation> audio_resampled { };
+	
+	dsp::interpolation::AudioResampler resampler { };
+	uint32_t sample_rate { 0 };
+	uint32_t bytes_per_sample { 1 };
+	
+	// Pre-emphasis as y = (b0.x[n] - b1.x[n-1]) >> 12
+	uint32_t pre_emphasis_us { 0 };
+	int32_t pre_emphasis_b0 { 4096 };
+	int32_t pre_emphasis_b1 { 0 };
+	int32_t pre_emphasis_x1 { 0 };
 	
-	size_t progress_interval_samples, progress_samples = 0;
+	dsp::modulate::FM fm { };
+	
+	size_t progress_interval_samples { 0 }, progress_samples { 0 };
 	
 	bool configured { false };
+	bool rate_supported { false };
 	uint32_t bytes_read { 0 };
+	uint32_t underruns { 0 };
+	
+	void refill_audio();
+	void update_pre_emphasis();
 	
 	void samplerate_config(const SamplerateConfigMessage& message);
 	void audio_config(const AudioTXConfigMessage& message);
@@ -43,8 +43,13 @@ void CaptureProcessor::execute(const buffer_c8_t& buffer) {
 	const auto& channel = decimator_out;
 
 	if( stream ) {
-		const size_t bytes_to_write = sizeof(*decimator_out.p) * decimator_out.count;
-		const auto result = stream->write(decimator_out.p, bytes_to_write);
+		if( format == IQFormat::C16 ) {
+			const size_t bytes_to_write = sizeof(*decimator_out.p) * decimator_out.count;
+			stream->write(decimator_out.p, bytes_to_write);
+		} else {
+			const size_t bytes_to_write = iq_format::encode(format, decimator_out.p, decimator_out.count, encoded.data());
+			stream->write(encoded.data(), bytes_to_write);
+		}
 	}
 
 	feed_channel_stats(channel);
@@ -60,6 +65,7 @@ void CaptureProcessor::on_message(const Message* const message) {
 	switch(message->id) {
 	case Message::ID::UpdateSpectrum:
 	case Message::ID::SpectrumStreamingConfig:
+	case Message::ID::SpectrumConfig:
 		channel_spectrum.on_message(message);
 		break;
 
@@ -94,6 +100,7 @@ void CaptureProcessor::samplerate_config(const SamplerateConfigMessage& message)
 
 void CaptureProcessor::capture_config(const CaptureConfigMessage& message) {
 	if( message.config ) {
+		format = message.config->format;
 		stream = std::make_unique<StreamInput>(message.config);
 	} else {
 		stream.reset();
@@ -32,6 +32,7 @@
 #include "spectrum_collector.hpp"
 
 #include "stream_input.hpp"
+#include "iq_format.hpp"
 
 #include <array>
 #include <memory>
@@ -64,6 +65,9 @@ private:
 	uint32_t channel_filter_stop_f = 0;
 
 	std::unique_ptr<StreamInput> stream { };
+	IQFormat format { IQFormat::C16 };
+	/* Large enough for one block of decimator output in C8 or BFP4. */
+	std::array<uint8_t, 512> encoded { };
 
 	SpectrumCollector channel_spectrum { };
 	size_t spectrum_interval_samples = 0;
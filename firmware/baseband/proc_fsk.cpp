@@ -22,14 +22,11 @@
 
 #include "proc_fsk.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
 
 void FSKProcessor::execute(const buffer_c8_t& buffer) {
-	int8_t re, im;
-	
 	// This is called at 2.28M/2048 = 1113Hz
 	
 	for (size_t i = 0; i < buffer.count; i++) {
@@ -59,21 +56,10 @@ void FSKProcessor::execute(const buffer_c8_t& buffer) {
 				sample_count++;
 			}
 		
-			if (cur_bit)
-				phase += shift_one;
-			else
-				phase += shift_zero;
-			
-			sphase = phase + (64 << 24);
-
-			re = (sine_table_i8[(sphase & 0xFF000000) >> 24]);
-			im = (sine_table_i8[(phase & 0xFF000000) >> 24]);
+			buffer.p[i] = nco.next(cur_bit ? shift_one : shift_zero);
 		} else {
-			re = 0;
-			im = 0;
+			buffer.p[i] = { 0, 0 };
 		}
-	
-		buffer.p[i] = {re, im};
 	}
 }
 
@@ -25,6 +25,7 @@
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
+#include "dsp_modulate.hpp"
 
 class FSKProcessor : public BasebandProcessor {
 public:
@@ -45,7 +46,8 @@ private:
     uint32_t progress_notice { }, progress_count { 0 };
     uint8_t cur_bit { 0 };
     uint32_t sample_count { 0 };
-	uint32_t phase { 0 }, sphase { 0 };
+	
+	dsp::modulate::NCO nco { };
 	
 	TXProgressMessage txprogress_message { };
 };
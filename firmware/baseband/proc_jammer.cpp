@@ -22,7 +22,6 @@
 
 #include "proc_jammer.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
@@ -71,18 +70,12 @@ void JammerProcessor::execute(const buffer_c8_t& buffer) {
 		
 		if (noise_type == JammerType::TYPE_TONE) {
 			aphase += tone_delta;
-			sample = sine_table_i8[(aphase & 0xFF000000) >> 24];
+			sample = dsp::modulate::sin_q15(aphase) >> 8;
 		}
 		
 		delta = sample * jammer_bw;
 		
-		phase += delta;
-		sphase = phase + (64 << 24);
-
-		re = (sine_table_i8[(sphase & 0xFF000000) >> 24]);
-		im = (sine_table_i8[(phase & 0xFF000000) >> 24]);
-
-		buffer.p[i] = {re, im};
+		buffer.p[i] = nco.next(delta);
 	}
 };
 
@@ -25,6 +25,7 @@
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
+#include "dsp_modulate.hpp"
 #include "portapack_shared_memory.hpp"
 #include "jammer.hpp"
 
@@ -50,9 +51,9 @@ private:
     uint32_t current_range { 0 };
 	int64_t jammer_center { 0 }, jammer_bw { 0 };
     uint32_t sample_count { 0 };
-	uint32_t aphase { 0 }, phase { 0 }, delta { 0 }, sphase { 0 };
+	uint32_t aphase { 0 }, delta { 0 };
 	int8_t sample { 0 };
-	int8_t re { 0 }, im { 0 };
+	dsp::modulate::NCO nco { };
 	RetuneMessage message { };
 };
 
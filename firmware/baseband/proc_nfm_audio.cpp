@@ -120,6 +120,7 @@ void NarrowbandFMAudio::on_message(const Message* const message) {
 	switch(message->id) {
 	case Message::ID::UpdateSpectrum:
 	case Message::ID::SpectrumStreamingConfig:
+	case Message::ID::SpectrumConfig:
 		channel_spectrum.on_message(message);
 		break;
 
@@ -22,14 +22,11 @@
 
 #include "proc_ook.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
 
 void OOKProcessor::execute(const buffer_c8_t& buffer) {
-	int8_t re, im;
-	
 	// This is called at 2.28M/2048 = 1113Hz
 	
 	if (!configured) return;
@@ -81,17 +78,10 @@ void OOKProcessor::execute(const buffer_c8_t& buffer) {
 		}
 		
 		if (cur_bit) {
-			phase = (phase + 200);			// What ?
-			sphase = phase + (64 << 18);
-
-			re = (sine_table_i8[(sphase & 0x03FC0000) >> 18]);
-			im = (sine_table_i8[(phase & 0x03FC0000) >> 18]);
+			buffer.p[i] = carrier.next(200 << 6);			// What ?
 		} else {
-			re = 0;
-			im = 0;
+			buffer.p[i] = { 0, 0 };
 		}
-	
-		buffer.p[i] = {re, im};
 	}
 }
 
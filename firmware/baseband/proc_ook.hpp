@@ -25,6 +25,7 @@
 
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
+#include "dsp_modulate.hpp"
 
 class OOKProcessor : public BasebandProcessor {
 public:
@@ -48,7 +49,8 @@ private:
     uint16_t bit_pos { 0 };
     uint8_t cur_bit { 0 };
     uint32_t sample_count { 0 };
-	uint32_t tone_phase { 0 }, phase { 0 }, sphase { 0 };
+	
+	dsp::modulate::NCO carrier { };
 	int32_t tone_sample { 0 }, sig { 0 }, frq { 0 };
 	
 	TXProgressMessage txprogress_message { };
@@ -36,11 +36,13 @@
 #include "pocsag_packet.hpp"
 
 #include "pocsag.hpp"
+#include "bch_code.hpp"
 #include "message.hpp"
 #include "audio_output.hpp"
 #include "portapack_shared_memory.hpp"
 
 #include <cstdint>
+#include <array>
 
 class POCSAGProcessor : public BasebandProcessor {
 public:
@@ -83,24 +85,42 @@ private:
 	
 	//AudioOutput audio_output { };
 
-	uint32_t sync_timeout { 0 };
-	uint32_t msg_timeout { 0 };
+	// One slicer per bit rate, all fed from the same demodulated audio
+	struct Decoder {
+		pocsag::BitRate bitrate;
+		uint32_t sphase { 0 };
+		uint32_t sphase_delta { 0 };
+		uint32_t sphase_delta_half { 0 };
+		uint32_t sphase_delta_eighth { 0 };
+		uint32_t rx_data { 0 };
+		uint32_t rx_bit { 0 };
+		uint32_t sync_timeout { 0 };
+		uint32_t msg_timeout { 0 };
+		uint32_t codeword_count { 0 };
+		rx_states rx_state { WAITING };
+		pocsag::POCSAGPacket packet { };
+	};
+
+	std::array<Decoder, 3> decoders { {
+		{ pocsag::BitRate::FSK512 },
+		{ pocsag::BitRate::FSK1200 },
+		{ pocsag::BitRate::FSK2400 }
+	} };
+
+	BCHCode bch_code {
+		{ 1, 0, 1, 0, 0, 1 },
+		5, 31, 21, 2
+	};
 
 	uint32_t slicer_sr { 0 };
-	uint32_t sphase { 0 };
-	uint32_t sphase_delta { 0 };
-	uint32_t sphase_delta_half { 0 };
-	uint32_t sphase_delta_eighth { 0 };
-	uint32_t rx_data { 0 };
-	uint32_t rx_bit { 0 };
 	bool configured = false;
-	rx_states rx_state { WAITING };
-	pocsag::BitRate bitrate { pocsag::BitRate::FSK1200 };
-	bool phase;
-	uint32_t codeword_count { 0 };
-	pocsag::POCSAGPacket packet { };
-	
-	void push_packet(pocsag::PacketFlag flag);
+	bool phase { false };
+	pocsag::POCSAGStatistics statistics { };
+	uint32_t stats_count { 0 };
+
+	void execute_decoder(Decoder& decoder, const size_t index);
+	int correct_codeword(uint32_t& codeword);
+	void push_packet(Decoder& decoder, pocsag::PacketFlag flag);
 	void configure(const POCSAGConfigureMessage& message);
 	
 };
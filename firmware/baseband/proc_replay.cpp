@@ -44,27 +44,28 @@ void ReplayProcessor::execute(const buffer_c8_t& buffer) {
 	
 	if (!configured) return;
 	
-	// File data is in C16 format, we need C8
-	// File samplerate is 500kHz, we're at 4MHz
-	// iq_buffer can only be 512 C16 samples (RAM limitation)
-	// To fill up the 2048-sample C8 buffer, we need:
-	// 2048 samples * 2 bytes per sample = 4096 bytes
-	// Since we're oversampling by 4M/500k = 8, we only need 2048/8 = 256 samples from the file and duplicate them 8 times each
-	// So 256 * 4 bytes per sample (C16) = 1024 bytes from the file
-	if( stream ) {
-		const size_t bytes_to_read = sizeof(*buffer.p) * 2 * (buffer.count / 8);	// *2 (C16), /8 (oversampling) should be == 1024
-		bytes_read += stream->read(iq_buffer.p, bytes_to_read);
-	}
-	
-	// Fill and "stretch"
-	for (size_t i = 0; i < buffer.count; i++) {
-		if (i & 3) {
-			buffer.p[i] = buffer.p[i - 1];
-		} else {
-			auto re_out = iq_buffer.p[i >> 3].real() >> 8;
-			auto im_out = iq_buffer.p[i >> 3].imag() >> 8;
-			buffer.p[i] = { (int8_t)re_out, (int8_t)im_out };
+	// File data is decoded to C16 (whatever the file format), we need C8 at
+	// the baseband rate. The resampler interpolates from the file's rate,
+	// pulling file data one iq buffer at a time.
+	size_t produced = 0;
+	while( produced < buffer.count ) {
+		if( iq_index == iq_count ) {
+			iq_index = 0;
+			iq_count = stream ? stream->read(iq.data(), iq.size()) : 0;
+			if( iq_count < iq.size() ) {
+				// The application fell behind, send silence rather than stall
+				std::fill(&iq[iq_count], &iq[iq.size()], complex16_t { 0, 0 });
+				iq_count = iq.size();
+				if( stream ) underruns++;
+			}
 		}
+
+		const auto result = resampler.execute(
+			&iq[iq_index], iq_count - iq_index,
+			&buffer.p[produced], buffer.count - produced
+		);
+		iq_index += result.consumed;
+		produced += result.produced;
 	}
 	
 	spectrum_samples += buffer.count;
@@ -72,7 +73,8 @@ void ReplayProcessor::execute(const buffer_c8_t& buffer) {
 		spectrum_samples -= spectrum_interval_samples;
 		channel_spectrum.feed(iq_buffer, channel_filter_pass_f, channel_filter_stop_f);
 		
-		txprogress_message.progress = bytes_read;	// Inform UI about progress
+		txprogress_message.progress = stream ? stream->bytes_read() : 0;	// Inform UI about progress
+		txprogress_message.underruns = underruns;
 		txprogress_message.done = false;
 		shared_memory.application_queue.push(txprogress_message);
 	}
@@ -82,6 +84,7 @@ void ReplayProcessor::on_message(const Message* const message) {
 	switch(message->id) {
 	case Message::ID::UpdateSpectrum:
 	case Message::ID::SpectrumStreamingConfig:
+	case Message::ID::SpectrumConfig:
 		channel_spectrum.on_message(message);
 		break;
 
@@ -91,13 +94,12 @@ void ReplayProcessor::on_message(const Message* const message) {
 	
 	case Message::ID::ReplayConfig:
 		configured = false;
-		bytes_read = 0;
 		replay_config(*reinterpret_cast<const ReplayConfigMessage*>(message));
 		break;
 		
 	// App has prefilled the buffers, we're ready to go now
 	case Message::ID::FIFOData:
-		configured = true;
+		configured = rate_supported;
 		break;
 
 	default:
@@ -109,12 +111,27 @@ void ReplayProcessor::samplerate_config(const SamplerateConfigMessage& message)
 	baseband_fs = message.sample_rate;
 	baseband_thread.set_sampling_rate(baseband_fs);
 	spectrum_interval_samples = baseband_fs / spectrum_rate_hz;
+
+	// Files without a known rate were captured at an eighth of the baseband rate
+	const uint32_t source_fs = message.source_sample_rate ? message.source_sample_rate : (baseband_fs / 8);
+	rate_supported = resampler.configure(source_fs, baseband_fs);
+	if (!rate_supported) {
+		// Stay silent and tell the application why
+		txprogress_message.done = true;
+		txprogress_message.error = true;
+		shared_memory.application_queue.push(txprogress_message);
+		txprogress_message.error = false;
+	}
 }
 
 void ReplayProcessor::replay_config(const ReplayConfigMessage& message) {
 	if( message.config ) {
 		
-		stream = std::make_unique<StreamOutput>(message.config);
+		stream = std::make_unique<IQStreamReader>(message.config);
+		iq_index = 0;
+		iq_count = 0;
+		underruns = 0;
+		resampler.reset();
 		
 		// Tell application that the buffers and FIFO pointers are ready, prefill
 		shared_memory.application_queue.push(sig_message);
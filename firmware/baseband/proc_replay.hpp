@@ -28,7 +28,8 @@
 
 #include "spectrum_collector.hpp"
 
-#include "stream_output.hpp"
+#include "iq_stream_reader.hpp"
+#include "polyphase_resampler.hpp"
 
 #include <array>
 #include <memory>
@@ -47,24 +48,30 @@ private:
 
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit };
 
+	// A whole number of blocks for every file format
 	std::array<complex16_t, 256> iq { };
 	const buffer_c16_t iq_buffer {
 		iq.data(),
 		iq.size(),
 		baseband_fs / 8
 	};
+	size_t iq_index { 0 };
+	size_t iq_count { 0 };
+	uint32_t underruns { 0 };
+
+	dsp::interpolation::PolyphaseResampler resampler { };
 	
 	uint32_t channel_filter_pass_f = 0;
 	uint32_t channel_filter_stop_f = 0;
 
-	std::unique_ptr<StreamOutput> stream { };
+	std::unique_ptr<IQStreamReader> stream { };
 
 	SpectrumCollector channel_spectrum { };
 	size_t spectrum_interval_samples = 0;
 	size_t spectrum_samples = 0;
 	
 	bool configured { false };
-	uint32_t bytes_read { 0 };
+	bool rate_supported { false };
 
 	void samplerate_config(const SamplerateConfigMessage& message);
 	void replay_config(const ReplayConfigMessage& message);
@@ -22,10 +22,14 @@
 #include "proc_wideband_spectrum.hpp"
 
 #include "event_m4.hpp"
+#include "portapack_shared_memory.hpp"
+#include "dsp_fft.hpp"
+#include "utility.hpp"
 
 #include <cstdint>
 #include <cstddef>
 
+#include <algorithm>
 #include <array>
 
 void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
@@ -34,6 +38,11 @@ void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
 	
 	if (!configured) return;
 
+	if( sweep_spans ) {
+		sweep_span_execute(buffer);
+		return;
+	}
+
 	if( phase == 0 ) {
 		std::fill(spectrum.begin(), spectrum.end(), 0);
 	}
@@ -73,15 +82,141 @@ void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
 
 }
 
+void WidebandSpectrum::sweep_configure(const SweepConfigMessage& message) {
+	sweep_state = SweepState::Idle;
+	sweep_spans = std::min(message.spans, SweepConfigMessage::spans_max);
+	if( !sweep_spans ) return;
+
+	baseband_fs = message.sampling_rate;
+	baseband_thread.set_sampling_rate(baseband_fs);
+	sweep_settle_buffers = message.settle_buffers;
+	sweep_averages = std::max(message.averages, size_t(1));
+
+	// Merge adjacent bins (keeping the strongest) until every span fits
+	sweep_pool = 1;
+	while( ((sweep_spans * sweep_span_bins / sweep_pool) > SweepConfigMessage::bins_max) ||
+		(sweep_span_bins % sweep_pool) ) {
+		sweep_pool++;
+	}
+
+	// Hann window, sin^2(pi * i / N), from the FFT sine table
+	for(size_t i=0; i<sweep_fft_n; i++) {
+		const size_t r = std::min(i, sweep_fft_n - i) * (2 * fft_quarter_n_max / sweep_fft_n);
+		const float s = fft_quarter_sine_f32[r];
+		sweep_window[i] = s * s;
+	}
+
+	configured = true;
+	sweep_span = 0;
+	sweep_retune();
+}
+
+void WidebandSpectrum::sweep_retune() {
+	// Samples are stale until the application confirms the new frequency
+	sweep_state = SweepState::Retuning;
+	const SweepRetuneMessage message { sweep_span };
+	shared_memory.application_queue.push(message);
+}
+
+void WidebandSpectrum::sweep_span_execute(const buffer_c8_t& buffer) {
+	if( sweep_state != SweepState::Settling ) return;
+
+	if( sweep_settle_count ) {
+		sweep_settle_count--;
+		return;
+	}
+
+	// Average consecutive FFTs from the same buffer, in linear power
+	const size_t averages = std::min(sweep_averages, buffer.count / sweep_fft_n);
+	std::fill(sweep_power.begin(), sweep_power.end(), 0.0f);
+	for(size_t a=0; a<averages; a++) {
+		const auto src = &buffer.p[a * sweep_fft_n];
+		for(size_t i=0; i<sweep_fft_n; i++) {
+			const size_t i_rev = __RBIT(i) >> (32 - log_2(sweep_fft_n));
+			sweep_fft[i_rev] = {
+				src[i].real() * sweep_window[i],
+				src[i].imag() * sweep_window[i]
+			};
+		}
+		fft_c_preswapped_radix4(sweep_fft);
+		for(size_t i=0; i<sweep_fft_n; i++) {
+			sweep_power[i] += magnitude_squared(sweep_fft[i]);
+		}
+	}
+
+	// Full scale complex8 tone through the Hann window (coherent gain 1/2) is 0dB
+	constexpr float full_scale = 128.0f * sweep_fft_n * 0.5f;
+	const float mag2_scale = 1.0f / (full_scale * full_scale * averages);
+
+	// Middle 3/4 of the spectrum, lowest frequency first
+	constexpr size_t first_bin = sweep_fft_n - (sweep_span_bins / 2);
+	const auto power = [this](const size_t k) {
+		return sweep_power[(first_bin + k) & (sweep_fft_n - 1)];
+	};
+
+	// The DC spike is replaced by a line between its neighbours
+	constexpr size_t dc = sweep_span_bins / 2;
+	constexpr size_t dc_half_width = 2;
+	const float dc_low = power(dc - dc_half_width - 1);
+	const float dc_high = power(dc + dc_half_width + 1);
+
+	uint8_t* const out = &sweep_db[sweep_page][sweep_span * (sweep_span_bins / sweep_pool)];
+	for(size_t k=0; k<sweep_span_bins; k+=sweep_pool) {
+		float mag2_max = 0;
+		for(size_t j=k; j<(k + sweep_pool); j++) {
+			float mag2;
+			if( (j >= dc - dc_half_width) && (j <= dc + dc_half_width) ) {
+				const float t = float(j - (dc - dc_half_width - 1)) / (dc_half_width * 2 + 2);
+				mag2 = dc_low + (dc_high - dc_low) * t;
+			} else {
+				mag2 = power(j);
+			}
+			mag2_max = std::max(mag2_max, mag2);
+		}
+		const float db = mag2_to_dbv_norm(mag2_max * mag2_scale);
+		constexpr float mag_scale = 5.0f;
+		const int v = (db * mag_scale) + 255.0f;
+		out[k / sweep_pool] = std::max(0, std::min(255, v));
+	}
+
+	sweep_span++;
+	if( sweep_span >= sweep_spans ) {
+		// Whole range done, hand the page over and fill the other one
+		const SweepSpectrumMessage message {
+			sweep_db[sweep_page].data(),
+			sweep_spans,
+			sweep_span_bins / sweep_pool
+		};
+		shared_memory.application_queue.push(message);
+		sweep_page ^= 1;
+		sweep_span = 0;
+	}
+
+	sweep_retune();
+}
+
 void WidebandSpectrum::on_message(const Message* const msg) {
 	const WidebandSpectrumConfigMessage message = *reinterpret_cast<const WidebandSpectrumConfigMessage*>(msg);
 	
 	switch(msg->id) {
 	case Message::ID::UpdateSpectrum:
 	case Message::ID::SpectrumStreamingConfig:
+	case Message::ID::SpectrumConfig:
 		channel_spectrum.on_message(msg);
 		break;
 		
+	case Message::ID::SweepConfig:
+		sweep_configure(*reinterpret_cast<const SweepConfigMessage*>(msg));
+		break;
+
+	case Message::ID::SweepTuned:
+		if( (sweep_state == SweepState::Retuning) &&
+			(reinterpret_cast<const SweepTunedMessage*>(msg)->span == sweep_span) ) {
+			sweep_settle_count = sweep_settle_buffers;
+			sweep_state = SweepState::Settling;
+		}
+		break;
+
 	case Message::ID::WidebandSpectrumConfig:
 		baseband_fs = message.sampling_rate;
 		trigger = message.trigger;
@@ -36,11 +36,23 @@
 
 class WidebandSpectrum : public BasebandProcessor {
 public:
+	/* In sweep mode, each span keeps the middle 3/4 of its FFT bins, so
+	 * spans are meant to be tuned sampling_rate * 3/4 apart.
+	 */
+	static constexpr size_t sweep_fft_n = 256;
+	static constexpr size_t sweep_span_bins = sweep_fft_n * 3 / 4;
+
 	void execute(const buffer_c8_t& buffer) override;
 
 	void on_message(const Message* const message) override;
 
 private:
+	enum class SweepState {
+		Idle,
+		Retuning,
+		Settling,
+	};
+
 	bool configured = false;
 	
 	size_t baseband_fs = 20000000;
@@ -53,6 +65,23 @@ private:
 	std::array<complex16_t, 256> spectrum { };
 
 	size_t phase = 0, trigger = 127;
+
+	volatile SweepState sweep_state { SweepState::Idle };
+	size_t sweep_spans { 0 };
+	size_t sweep_span { 0 };
+	size_t sweep_settle_buffers { 0 };
+	size_t sweep_settle_count { 0 };
+	size_t sweep_averages { 1 };
+	size_t sweep_pool { 1 };
+	size_t sweep_page { 0 };
+	std::array<float, sweep_fft_n> sweep_window { };
+	std::array<std::complex<float>, sweep_fft_n> sweep_fft { };
+	std::array<float, sweep_fft_n> sweep_power { };
+	std::array<std::array<uint8_t, SweepConfigMessage::bins_max>, 2> sweep_db { };
+
+	void sweep_configure(const SweepConfigMessage& message);
+	void sweep_retune();
+	void sweep_span_execute(const buffer_c8_t& buffer);
 };
 
 #endif/*__PROC_WIDEBAND_SPECTRUM_H__*/
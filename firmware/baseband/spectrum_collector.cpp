@@ -26,6 +26,7 @@
 #include "utility.hpp"
 #include "event_m4.hpp"
 #include "portapack_shared_memory.hpp"
+#include "baseband_profiler.hpp"
 
 #include "event_m4.hpp"
 
@@ -41,6 +42,10 @@ void SpectrumCollector::on_message(const Message* const message) {
 		set_state(*reinterpret_cast<const SpectrumStreamingConfigMessage*>(message));
 		break;
 
+	case Message::ID::SpectrumConfig:
+		set_config(reinterpret_cast<const SpectrumConfigMessage*>(message)->config);
+		break;
+
 	default:
 		break;
 	}
@@ -54,7 +59,26 @@ void SpectrumCollector::set_state(const SpectrumStreamingConfigMessage& message)
 	}
 }
 
+void SpectrumCollector::set_config(const SpectrumConfig& new_config) {
+	config = new_config;
+	if( config.averages < 1 ) {
+		config.averages = 1;
+	}
+	reset();
+}
+
+void SpectrumCollector::reset() {
+	// Called with the baseband thread possibly still posting frames, which only
+	// costs a spectrum with one frame too many.
+	frame_count = 0;
+	power_sum.fill(0.0f);
+	power_frames = 0;
+	max_hold.fill(0);
+	min_hold.fill(255);
+}
+
 void SpectrumCollector::start() {
+	reset();
 	streaming = true;
 	ChannelSpectrumConfigMessage message { &fifo };
 	shared_memory.application_queue.push(message);
@@ -93,61 +117,131 @@ void SpectrumCollector::feed(
 	);
 }
 
+/* Time domain window weight for sample i of an N point frame. sin(pi*i/N)
+ * comes from the FFT sine table, Hann is its square and the Blackman-Harris
+ * cosine terms follow from the multiple angle identities.
+ */
+template<size_t N>
+static float spectrum_window(const SpectrumConfig::Window window, const size_t i) {
+	const size_t r = std::min(i, N - i) * (2 * fft_quarter_n_max / N);
+	const float s = fft_quarter_sine_f32[r];
+	const float s2 = s * s;
+
+	switch(window) {
+	case SpectrumConfig::Window::Hann:
+		return s2;
+
+	case SpectrumConfig::Window::BlackmanHarris: {
+		const float c1 = 1.0f - 2.0f * s2;			// cos(2*pi*i/N)
+		const float c2 = 2.0f * c1 * c1 - 1.0f;
+		const float c3 = (4.0f * c1 * c1 - 3.0f) * c1;
+		return 0.35875f - 0.48829f * c1 + 0.14128f * c2 - 0.01168f * c3;
+	}
+
+	default:
+		return 1.0f;
+	}
+}
+
+static float spectrum_window_coherent_gain(const SpectrumConfig::Window window) {
+	switch(window) {
+	case SpectrumConfig::Window::Hann:				return 0.5f;
+	case SpectrumConfig::Window::BlackmanHarris:	return 0.35875f;
+	default:										return 1.0f;
+	}
+}
+
 void SpectrumCollector::post_message(const buffer_c16_t& data) {
 	// Called from baseband processing thread.
-	if( streaming && !channel_spectrum_request_update ) {
-		fft_swap(data, channel_spectrum);
+	if( !streaming ) {
+		return;
+	}
+
+	// Slide the frame along by one hop. With overlap, every hop completes a frame.
+	if( frame_count == fft_n ) {
+		if( config.overlap ) {
+			std::copy(frame.begin() + hop_n, frame.end(), frame.begin());
+			frame_count = hop_n;
+		} else {
+			frame_count = 0;
+		}
+	}
+	std::copy_n(data.p, hop_n, frame.begin() + frame_count);
+	frame_count += hop_n;
+
+	if( (frame_count == fft_n) && !channel_spectrum_request_update ) {
+		for(size_t i=0; i<fft_n; i++) {
+			const size_t i_rev = __RBIT(i) >> (32 - log_2(fft_n));
+			const float w = spectrum_window<fft_n>(config.window, i);
+			channel_spectrum[i_rev] = {
+				frame[i].real() * w,
+				frame[i].imag() * w
+			};
+		}
 		channel_spectrum_sampling_rate = data.sampling_rate;
 		channel_spectrum_request_update = true;
 		EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
 	}
 }
 
-template<typename T>
-static typename T::value_type spectrum_window_none(const T& s, const size_t i) {
-	static_assert(power_of_two(s.size()), "Array size must be power of 2");
-	return s[i];
-};
-
-template<typename T>
-static typename T::value_type spectrum_window_hamming_3(const T& s, const size_t i) {
-	static_assert(power_of_two(s.size()), "Array size must be power of 2");
-	constexpr size_t mask = s.size() - 1;
-	// Three point Hamming window.
-	return s[i] * 0.54f + (s[(i-1) & mask] + s[(i+1) & mask]) * -0.23f;
-};
-
-template<typename T>
-static typename T::value_type spectrum_window_blackman_3(const T& s, const size_t i) {
-	static_assert(power_of_two(s.size()), "Array size must be power of 2");
-	constexpr size_t mask = s.size() - 1;
-	// Three term Blackman window.
-	constexpr float alpha = 0.42f;
-	constexpr float beta = 0.5f * 0.5f;
-	constexpr float gamma = 0.08f * 0.05f;
-	return s[i] * alpha - (s[(i-1) & mask] + s[(i+1) & mask]) * beta + (s[(i-2) & mask] + s[(i+2) & mask]) * gamma;
-};
-
 void SpectrumCollector::update() {
 	// Called from idle thread (after EVT_MASK_SPECTRUM is flagged)
 	if( streaming && channel_spectrum_request_update ) {
-		/* Decimated buffer is full. Compute spectrum. */
-		fft_c_preswapped(channel_spectrum, 0, 8);
-
-		ChannelSpectrum spectrum;
-		spectrum.sampling_rate = channel_spectrum_sampling_rate;
-		spectrum.channel_filter_pass_frequency = channel_filter_pass_frequency;
-		spectrum.channel_filter_stop_frequency = channel_filter_stop_frequency;
-		for(size_t i=0; i<spectrum.db.size(); i++) {
-			const auto corrected_sample = spectrum_window_hamming_3(channel_spectrum, i);
-			const auto mag2 = magnitude_squared(corrected_sample * (1.0f / 32768.0f));
-			const float db = mag2_to_dbv_norm(mag2);
-			constexpr float mag_scale = 5.0f;
-			const unsigned int v = (db * mag_scale) + 255.0f;
-			spectrum.db[i] = std::max(0U, std::min(255U, v));
+		const auto start = CycleProfiler::now();
+
+		/* Frame is windowed and swapped. Compute spectrum. */
+		fft_c_preswapped_radix4(channel_spectrum);
+
+		for(size_t i=0; i<fft_n; i++) {
+			power_sum[i] += magnitude_squared(channel_spectrum[i]);
+		}
+		power_frames++;
+
+		if( power_frames >= config.averages ) {
+			publish();
 		}
-		fifo.in(spectrum);
+
+		baseband_profiler.spectrum.record(CycleProfiler::now() - start);
 	}
 
 	channel_spectrum_request_update = false;
 }
+
+void SpectrumCollector::publish() {
+	ChannelSpectrum spectrum;
+	spectrum.sampling_rate = channel_spectrum_sampling_rate;
+	spectrum.channel_filter_pass_frequency = channel_filter_pass_frequency;
+	spectrum.channel_filter_stop_frequency = channel_filter_stop_frequency;
+	spectrum.config = config;
+
+	// Normalized to the gain of the former frequency domain Hamming window, so
+	// the display scale does not move with the window choice.
+	const float gain = 0.54f / spectrum_window_coherent_gain(config.window);
+	const float mag2_scale = (gain * gain) / (32768.0f * 32768.0f * power_frames);
+
+	std::array<uint8_t, fft_n> average;
+	for(size_t i=0; i<fft_n; i++) {
+		const float db = mag2_to_dbv_norm(power_sum[i] * mag2_scale);
+		constexpr float mag_scale = 5.0f;
+		const int v = (db * mag_scale) + 255.0f;
+		average[i] = std::max(0, std::min(255, v));
+		max_hold[i] = std::max(max_hold[i], average[i]);
+		min_hold[i] = std::min(min_hold[i], average[i]);
+	}
+
+	switch(config.trace) {
+	case SpectrumConfig::Trace::MaxHold:	spectrum.db = max_hold;	break;
+	case SpectrumConfig::Trace::MinHold:	spectrum.db = min_hold;	break;
+	default:								spectrum.db = average;	break;
+	}
+
+	// Most bins only hold noise, so the median is a fair noise floor
+	constexpr size_t median = fft_n / 2;
+	std::nth_element(average.begin(), average.begin() + median, average.end());
+	spectrum.noise_floor = average[median];
+
+	fifo.in(spectrum);
+
+	power_sum.fill(0.0f);
+	power_frames = 0;
+}
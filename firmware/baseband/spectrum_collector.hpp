@@ -45,24 +45,38 @@ public:
 	);
 
 private:
-	BlockDecimator<complex16_t, 256> channel_spectrum_decimator { 1 };
+	static constexpr size_t fft_n = 256;
+	static constexpr size_t hop_n = fft_n / 2;
+
+	BlockDecimator<complex16_t, hop_n> channel_spectrum_decimator { 1 };
 	ChannelSpectrum fifo_data[1 << ChannelSpectrumConfigMessage::fifo_k] { };
 	ChannelSpectrumFIFO fifo { fifo_data, ChannelSpectrumConfigMessage::fifo_k };
 
 	volatile bool channel_spectrum_request_update { false };
 	bool streaming { false };
-	std::array<std::complex<float>, 256> channel_spectrum { };
+	SpectrumConfig config { };
+	std::array<complex16_t, fft_n> frame { };
+	size_t frame_count { 0 };
+	std::array<std::complex<float>, fft_n> channel_spectrum { };
 	uint32_t channel_spectrum_sampling_rate { 0 };
 	uint32_t channel_filter_pass_frequency { 0 };
 	uint32_t channel_filter_stop_frequency { 0 };
 
+	std::array<float, fft_n> power_sum { };
+	size_t power_frames { 0 };
+	std::array<uint8_t, fft_n> max_hold { };
+	std::array<uint8_t, fft_n> min_hold { };
+
 	void post_message(const buffer_c16_t& data);
 
 	void set_state(const SpectrumStreamingConfigMessage& message);
+	void set_config(const SpectrumConfig& new_config);
 	void start();
 	void stop();
+	void reset();
 
 	void update();
+	void publish();
 };
 
 #endif/*__SPECTRUM_COLLECTOR_H__*/
@@ -21,7 +21,7 @@
  */
 
 #include "tone_gen.hpp"
-#include "sine_table_int8.hpp"
+#include "dsp_modulate.hpp"
 
 void ToneGen::configure(const uint32_t delta, const float tone_mix_weight) {
 	delta_ = delta;
@@ -33,7 +33,18 @@ int32_t ToneGen::process(const int32_t sample_in) {
 	if (!delta_)
 		return sample_in;
 	
-	int32_t tone_sample = sine_table_i8[(tone_phase_ & 0xFF000000U) >> 24];
+	int32_t tone_sample = dsp::modulate::sin_q15(tone_phase_) >> 8;
+	tone_phase_ += delta_;
+	
+	return (sample_in * input_mix_weight_) + (tone_sample * tone_mix_weight_);
+}
+
+// Same as process(), for 16-bit samples
+int32_t ToneGen::process_s16(const int32_t sample_in) {
+	if (!delta_)
+		return sample_in;
+	
+	int32_t tone_sample = dsp::modulate::sin_q15(tone_phase_);
 	tone_phase_ += delta_;
 	
 	return (sample_in * input_mix_weight_) + (tone_sample * tone_mix_weight_);
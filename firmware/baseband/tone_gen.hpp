@@ -34,6 +34,7 @@ public:
 
 	void configure(const uint32_t delta, const float tone_mix_weight);
 	int32_t process(const int32_t sample_in);
+	int32_t process_s16(const int32_t sample_in);
 
 private:
 	//size_t sample_rate_;
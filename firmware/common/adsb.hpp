@@ -33,6 +33,7 @@ namespace adsb {
 
 enum downlink_format {
 	DF_ADSB = 17,
+	DF_ADSB_NON_TRANSPONDER = 18,
 	DF_EHS_SQUAWK = 21
 };
 
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2017 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "adsb_crc.hpp"
+
+#include <array>
+
+namespace adsb {
+
+using crc24_table_t = std::array<uint32_t, 256>;
+
+static constexpr crc24_table_t make_crc24_table() {
+	crc24_table_t table { };
+	for(uint32_t i=0; i<table.size(); i++) {
+		uint32_t c = i << 16;
+		for(size_t b=0; b<8; b++) {
+			c = (c & 0x800000) ? ((c << 1) ^ crc24_polynomial) : (c << 1);
+		}
+		table[i] = c & 0xFFFFFF;
+	}
+	return table;
+}
+
+static constexpr crc24_table_t crc24_table = make_crc24_table();
+
+static constexpr uint32_t crc24_bytes(const uint8_t* const data, const size_t length) {
+	uint32_t c = 0;
+	for(size_t i=0; i<length; i++) {
+		c = ((c << 8) ^ crc24_table[((c >> 16) ^ data[i]) & 0xFF]) & 0xFFFFFF;
+	}
+	return c;
+}
+
+/* Syndrome of a single bit error in a 112 bit frame, for every bit outside
+ * the DF field, sorted by syndrome for binary search.
+ */
+constexpr size_t frame_long_bits = frame_long_bytes * 8;
+constexpr size_t repair_first_bit = 5;
+
+struct crc24_syndrome_entry {
+	uint32_t syndrome;
+	uint8_t bit;
+};
+
+using crc24_syndrome_table_t = std::array<crc24_syndrome_entry, frame_long_bits - repair_first_bit>;
+
+static constexpr crc24_syndrome_table_t make_crc24_syndrome_table() {
+	crc24_syndrome_table_t table { };
+	for(size_t bit=repair_first_bit; bit<frame_long_bits; bit++) {
+		uint8_t frame[frame_long_bytes] { };
+		frame[bit >> 3] = 0x80 >> (bit & 7);
+		const uint32_t parity = (frame[11] << 16) | (frame[12] << 8) | frame[13];
+		const crc24_syndrome_entry entry { crc24_bytes(frame, frame_long_bytes - 3) ^ parity, static_cast<uint8_t>(bit) };
+
+		// Insertion sort
+		size_t i = bit - repair_first_bit;
+		for(; (i > 0) && (table[i - 1].syndrome > entry.syndrome); i--) {
+			table[i] = table[i - 1];
+		}
+		table[i] = entry;
+	}
+	return table;
+}
+
+static constexpr crc24_syndrome_table_t crc24_syndrome_table = make_crc24_syndrome_table();
+
+static int find_single_bit(const uint32_t syndrome) {
+	size_t lo = 0;
+	size_t hi = crc24_syndrome_table.size();
+	while( lo < hi ) {
+		const size_t mid = (lo + hi) / 2;
+		if( crc24_syndrome_table[mid].syndrome < syndrome ) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if( (lo < crc24_syndrome_table.size()) && (crc24_syndrome_table[lo].syndrome == syndrome) ) {
+		return crc24_syndrome_table[lo].bit;
+	}
+	return -1;
+}
+
+static void flip_bit(uint8_t* const frame, const size_t bit) {
+	frame[bit >> 3] ^= 0x80 >> (bit & 7);
+}
+
+uint32_t crc24(const uint8_t* const data, const size_t length) {
+	return crc24_bytes(data, length);
+}
+
+uint32_t crc24_syndrome(const uint8_t* const frame, const size_t length) {
+	const size_t n = length - 3;
+	const uint32_t parity = (frame[n] << 16) | (frame[n + 1] << 8) | frame[n + 2];
+	return crc24_bytes(frame, n) ^ parity;
+}
+
+int crc24_repair(uint8_t* const frame, const size_t max_errors) {
+	const uint32_t syndrome = crc24_syndrome(frame, frame_long_bytes);
+	if( syndrome == 0 ) {
+		return 0;
+	}
+
+	if( max_errors >= 1 ) {
+		const auto bit = find_single_bit(syndrome);
+		if( bit >= 0 ) {
+			flip_bit(frame, bit);
+			return 1;
+		}
+	}
+
+	if( max_errors >= 2 ) {
+		// Two errors: the syndrome is the XOR of two single bit syndromes
+		for(const auto& first : crc24_syndrome_table) {
+			const auto bit = find_single_bit(syndrome ^ first.syndrome);
+			if( bit > first.bit ) {
+				flip_bit(frame, first.bit);
+				flip_bit(frame, bit);
+				return 2;
+			}
+		}
+	}
+
+	return -1;
+}
+
+} /* namespace adsb */
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ * Copyright (C) 2017 Furrtek
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __ADSB_CRC_H__
+#define __ADSB_CRC_H__
+
+#include <cstdint>
+#include <cstddef>
+
+namespace adsb {
+
+/* Mode S parity: CRC-24 with generator 0x1FFF409, MSB first, no initial
+ * value or final XOR. A valid frame's last 3 bytes hold the CRC of the
+ * bytes before them, so the syndrome of a valid frame is 0.
+ */
+
+constexpr uint32_t crc24_polynomial = 0xFFF409;
+constexpr size_t frame_long_bytes = 14;
+
+uint32_t crc24(const uint8_t* const data, const size_t length);
+
+/* CRC of the data bytes XOR the parity field */
+uint32_t crc24_syndrome(const uint8_t* const frame, const size_t length);
+
+/* Tries to make a 112 bit frame's syndrome 0 by flipping up to max_errors
+ * (1 or 2) bits, never touching the downlink format field. Only meaningful
+ * for DF17/DF18, whose parity is not overlaid with an address.
+ * Returns the number of bits flipped, or -1 if the frame can't be repaired.
+ */
+int crc24_repair(uint8_t* const frame, const size_t max_errors);
+
+} /* namespace adsb */
+
+#endif/*__ADSB_CRC_H__*/
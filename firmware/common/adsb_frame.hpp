@@ -26,6 +26,8 @@
 #include <cstring>
 #include <string>
 
+#include "adsb_crc.hpp"
+
 namespace adsb {
 
 alignas(4) const uint8_t adsb_preamble[16] = { 1, 0, 1, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0 };
@@ -82,13 +84,12 @@ public:
 	}
 
 	bool check_CRC() {
-		uint32_t computed_CRC = compute_CRC();
-		
-		if ((raw_data[11] != ((computed_CRC >> 16) & 0xFF)) ||
-			(raw_data[12] != ((computed_CRC >> 8) & 0xFF)) ||
-			(raw_data[13] != (computed_CRC & 0xFF))) return false;
-		
-		return true;
+		return (crc24_syndrome(raw_data, 14) == 0);
+	}
+	
+	// Flips up to max_errors bits to fix the CRC, see crc24_repair()
+	int repair_CRC(const size_t max_errors) {
+		return crc24_repair(raw_data, max_errors);
 	}
 	
 	bool empty() {
@@ -103,26 +104,7 @@ private:
 	uint32_t rx_timestamp { };
 
 	uint32_t compute_CRC() {
-		uint8_t adsb_crc[14] = { 0 };	// Temp buffer
-		uint8_t b, c, s, bitn;
-		const uint32_t crc_poly = 0x1205FFF;
-		
-		// Copy frame data
-		memcpy(adsb_crc, raw_data, 11);
-		
-		// Compute CRC
-		for (c = 0; c < 11; c++) {
-			for (b = 0; b < 8; b++) {
-				if ((adsb_crc[c] << b) & 0x80) {
-					for (s = 0; s < 25; s++) {
-						bitn = (c * 8) + b + s;
-						if ((crc_poly >> s) & 1) adsb_crc[bitn >> 3] ^= (0x80 >> (bitn & 7));
-					}
-				}
-			}
-		}
-		
-		return (adsb_crc[11] << 16) + (adsb_crc[12] << 8) + adsb_crc[13];
+		return crc24(raw_data, 11);
 	}
 };
 
@@ -305,6 +305,75 @@ int BCHCode::decode(int recd[]) {
 	return retval;
 }
 
+uint32_t BCHCode::syndrome(uint32_t codeword) const {
+	// Remainder of the received polynomial divided by g(x)
+	const int rdncy = n - k;
+	
+	for (int i = n - 1; i >= rdncy; i--) {
+		if (codeword & (1U << i))
+			codeword ^= generator << (i - rdncy);
+	}
+	
+	return codeword;
+}
+
+bool BCHCode::build_syndrome_table() {
+	// Syndromes are linear, so those of two-bit errors are the XOR of the
+	// single-bit ones. Entries hold the error count in bits 10-11 and the
+	// bit positions in bits 0-4 and 5-9.
+	const size_t size = 1U << (n - k);
+	uint32_t single[32];
+	int i, j;
+	
+	syndrome_table = (uint16_t *)chHeapAlloc(NULL, sizeof(uint16_t) * size);
+	if (syndrome_table == NULL)
+		return false;
+	
+	for (size_t c = 0; c < size; c++)
+		syndrome_table[c] = syndrome_uncorrectable;
+	
+	for (i = 0; i < n; i++) {
+		single[i] = syndrome(1U << i);
+		syndrome_table[single[i]] = (1 << 10) | i;
+	}
+	
+	for (i = 0; i < n; i++) {
+		for (j = i + 1; j < n; j++)
+			syndrome_table[single[i] ^ single[j]] = (2 << 10) | (j << 5) | i;
+	}
+	
+	return true;
+}
+
+int BCHCode::correct(uint32_t& codeword) {
+	uint32_t s;
+	uint16_t entry;
+	int count;
+	
+	if (!valid || (n > 32) || (t > 2)) return -1;
+	
+	if ((syndrome_table == NULL) && !build_syndrome_table())
+		return -1;
+	
+	if (n < 32)
+		codeword &= (1U << n) - 1;
+	
+	s = syndrome(codeword);
+	if (s == 0)
+		return 0;
+	
+	entry = syndrome_table[s];
+	if (entry == syndrome_uncorrectable)
+		return -1;
+	
+	count = entry >> 10;
+	codeword ^= 1U << (entry & 31);
+	if (count == 2)
+		codeword ^= 1U << ((entry >> 5) & 31);
+	
+	return count;
+}
+
 /*
  * Example usage BCH(31,21,5)
  *
@@ -352,6 +421,11 @@ BCHCode::BCHCode(
 
 		generate_gf();			/* generate the Galois Field GF(2**m) */
 		gen_poly();				/* Compute the generator polynomial of BCH code */
+		
+		for (i = 0; i < (size_t)(n - k + 1); i++) {
+			if (g[i] != 0)
+				generator |= 1U << i;
+		}
 	}
 }
 
@@ -361,4 +435,5 @@ BCHCode::~BCHCode() {
 	if (p != NULL) chHeapFree(p);
 	if (g != NULL) chHeapFree(g);
 	if (bb != NULL) chHeapFree(bb);
+	if (syndrome_table != NULL) chHeapFree(syndrome_table);
 }
@@ -25,6 +25,7 @@
 #ifndef __BCHCODE_H__
 #define __BCHCODE_H__
 
+#include <cstdint>
 #include <vector>
 
 class BCHCode {
@@ -40,9 +41,19 @@ public:
 	int * encode(int data[]);
 	int decode(int recd[]);
 	
+	// Corrects up to 2 bit errors in a codeword packed MSB first (first data
+	// bit in bit n-1, last redundancy bit in bit 0), by looking the syndrome
+	// up in a table built on first use. Returns the number of bits flipped,
+	// or -1 if the errors can't be corrected. Needs n <= 32 and t <= 2.
+	int correct(uint32_t& codeword);
+	
 private:
+	static constexpr uint16_t syndrome_uncorrectable = 0xFFFF;
+	
 	void gen_poly();
 	void generate_gf();
+	uint32_t syndrome(uint32_t codeword) const;
+	bool build_syndrome_table();
 	
 	bool valid { false };
 
@@ -56,6 +67,8 @@ private:
 	int * index_of { };		// antilog table of GF(2**5)
 	int * g { };			// coefficients of generator polynomial, g(x) [n - k + 1]=[11]
 	int * bb { };			// coefficients of redundancy polynomial ( x**(10) i(x) ) modulo g(x)
+	uint32_t generator { };	// g(x) as a bit mask, bit i = coefficient of X**i
+	uint16_t * syndrome_table { };	// error positions for each syndrome, 2**(n-k) entries
 };
 
 #endif/*__BCHCODE_H__*/
@@ -47,6 +47,18 @@ struct Timestamp {
 using Timestamp = lpc43xx::rtc::RTC;
 #endif
 
+#if !defined(LPC43XX_M0) && !defined(LPC43XX_M4)
+/* Host builds (DSP checks, tools) have no RTC to read. */
+struct Timestamp {
+	uint32_t tv_date { 0 };
+	uint32_t tv_time { 0 };
+
+	static Timestamp now() {
+		return { };
+	}
+};
+#endif
+
 template<typename T>
 struct buffer_t {
 	T* const p;
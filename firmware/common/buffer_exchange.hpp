@@ -51,6 +51,10 @@ public:
 		return get_prefill(fifo_buffers_for_application);
 	}
 
+	size_t queued() const {
+		return fifo_buffers_for_application->len();
+	}
+
 	bool put(StreamBuffer* const p) {
 		return fifo_buffers_for_baseband->in(p);
 	}
@@ -153,16 +153,69 @@ private:
 	}
 };
 
+/* CRC-32 as used by PNG, zlib and Ethernet (reflected polynomial
+ * 0xedb88320), one table lookup per byte instead of eight bit steps.
+ */
+constexpr std::array<uint32_t, 256> make_crc32_table() {
+	std::array<uint32_t, 256> table { };
+	for(uint32_t i=0; i<table.size(); i++) {
+		uint32_t c = i;
+		for(size_t k=0; k<8; k++) {
+			c = (c & 1) ? ((c >> 1) ^ 0xedb88320) : (c >> 1);
+		}
+		table[i] = c;
+	}
+	return table;
+}
+
+class CRC32 {
+public:
+	void reset() {
+		remainder = 0xffffffff;
+	}
+
+	void process_bytes(const void* const data, const size_t length) {
+		const uint8_t* const p = reinterpret_cast<const uint8_t*>(data);
+		for(size_t i=0; i<length; i++) {
+			remainder = table[(remainder ^ p[i]) & 0xff] ^ (remainder >> 8);
+		}
+	}
+
+	template<size_t N>
+	void process_bytes(const std::array<uint8_t, N>& data) {
+		process_bytes(data.data(), data.size());
+	}
+
+	uint32_t checksum() const {
+		return remainder ^ 0xffffffff;
+	}
+
+private:
+	static constexpr std::array<uint32_t, 256> table = make_crc32_table();
+
+	uint32_t remainder { 0xffffffff };
+};
+
 class Adler32 {
 public:
 	void feed(const uint8_t v) {
 		feed_one(v);
 	}
 
-	void feed(const void* const data, const size_t n) {
-		const uint8_t* const p = reinterpret_cast<const uint8_t*>(data);
-		for(size_t i=0; i<n; i++) {
-			feed_one(p[i]);
+	void feed(const void* const data, size_t n) {
+		/* Reduce once per block_max bytes, the most that can be summed
+		 * before b overflows 32 bits.
+		 */
+		const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+		while( n > 0 ) {
+			const size_t block = (n < block_max) ? n : block_max;
+			n -= block;
+			for(size_t i=0; i<block; i++) {
+				a += *(p++);
+				b += a;
+			}
+			a %= mod;
+			b %= mod;
 		}
 	}
 
@@ -182,6 +235,7 @@ public:
 
 private:
 	static constexpr uint32_t mod = 65521;
+	static constexpr size_t block_max = 5552;
 
 	uint32_t a { 1 };
 	uint32_t b { 0 };
@@ -20,3 +20,153 @@
  */
 
 #include "dsp_fft.hpp"
+
+const std::array<float, fft_quarter_n_max + 1> fft_quarter_sine_f32 { {
+	0.000000000e+00f, 6.135884649e-03f, 1.227153829e-02f, 1.840672991e-02f,
+	2.454122852e-02f, 3.067480318e-02f, 3.680722294e-02f, 4.293825693e-02f,
+	4.906767433e-02f, 5.519524435e-02f, 6.132073630e-02f, 6.744391956e-02f,
+	7.356456360e-02f, 7.968243797e-02f, 8.579731234e-02f, 9.190895650e-02f,
+	9.801714033e-02f, 1.041216339e-01f, 1.102222073e-01f, 1.163186309e-01f,
+	1.224106752e-01f, 1.284981108e-01f, 1.345807085e-01f, 1.406582393e-01f,
+	1.467304745e-01f, 1.527971853e-01f, 1.588581433e-01f, 1.649131205e-01f,
+	1.709618888e-01f, 1.770042204e-01f, 1.830398880e-01f, 1.890686641e-01f,
+	1.950903220e-01f, 2.011046348e-01f, 2.071113762e-01f, 2.131103199e-01f,
+	2.191012402e-01f, 2.250839114e-01f, 2.310581083e-01f, 2.370236060e-01f,
+	2.429801799e-01f, 2.489276057e-01f, 2.548656596e-01f, 2.607941179e-01f,
+	2.667127575e-01f, 2.726213554e-01f, 2.785196894e-01f, 2.844075372e-01f,
+	2.902846773e-01f, 2.961508882e-01f, 3.020059493e-01f, 3.078496400e-01f,
+	3.136817404e-01f, 3.195020308e-01f, 3.253102922e-01f, 3.311063058e-01f,
+	3.368898534e-01f, 3.426607173e-01f, 3.484186802e-01f, 3.541635254e-01f,
+	3.598950365e-01f, 3.656129978e-01f, 3.713171940e-01f, 3.770074102e-01f,
+	3.826834324e-01f, 3.883450467e-01f, 3.939920401e-01f, 3.996241998e-01f,
+	4.052413140e-01f, 4.108431711e-01f, 4.164295601e-01f, 4.220002708e-01f,
+	4.275550934e-01f, 4.330938189e-01f, 4.386162385e-01f, 4.441221446e-01f,
+	4.496113297e-01f, 4.550835871e-01f, 4.605387110e-01f, 4.659764958e-01f,
+	4.713967368e-01f, 4.767992301e-01f, 4.821837721e-01f, 4.875501601e-01f,
+	4.928981922e-01f, 4.982276670e-01f, 5.035383837e-01f, 5.088301425e-01f,
+	5.141027442e-01f, 5.193559902e-01f, 5.245896827e-01f, 5.298036247e-01f,
+	5.349976199e-01f, 5.401714727e-01f, 5.453249884e-01f, 5.504579729e-01f,
+	5.555702330e-01f, 5.606615762e-01f, 5.657318108e-01f, 5.707807459e-01f,
+	5.758081914e-01f, 5.808139581e-01f, 5.857978575e-01f, 5.907597019e-01f,
+	5.956993045e-01f, 6.006164794e-01f, 6.055110414e-01f, 6.103828063e-01f,
+	6.152315906e-01f, 6.200572118e-01f, 6.248594881e-01f, 6.296382389e-01f,
+	6.343932842e-01f, 6.391244449e-01f, 6.438315429e-01f, 6.485144010e-01f,
+	6.531728430e-01f, 6.578066933e-01f, 6.624157776e-01f, 6.669999223e-01f,
+	6.715589548e-01f, 6.760927036e-01f, 6.806009978e-01f, 6.850836678e-01f,
+	6.895405447e-01f, 6.939714609e-01f, 6.983762494e-01f, 7.027547445e-01f,
+	7.071067812e-01f, 7.114321957e-01f, 7.157308253e-01f, 7.200025080e-01f,
+	7.242470830e-01f, 7.284643904e-01f, 7.326542717e-01f, 7.368165689e-01f,
+	7.409511254e-01f, 7.450577854e-01f, 7.491363945e-01f, 7.531867990e-01f,
+	7.572088465e-01f, 7.612023855e-01f, 7.651672656e-01f, 7.691033376e-01f,
+	7.730104534e-01f, 7.768884657e-01f, 7.807372286e-01f, 7.845565972e-01f,
+	7.883464276e-01f, 7.921065773e-01f, 7.958369046e-01f, 7.995372691e-01f,
+	8.032075315e-01f, 8.068475535e-01f, 8.104571983e-01f, 8.140363297e-01f,
+	8.175848132e-01f, 8.211025150e-01f, 8.245893028e-01f, 8.280450453e-01f,
+	8.314696123e-01f, 8.348628750e-01f, 8.382247056e-01f, 8.415549774e-01f,
+	8.448535652e-01f, 8.481203448e-01f, 8.513551931e-01f, 8.545579884e-01f,
+	8.577286100e-01f, 8.608669386e-01f, 8.639728561e-01f, 8.670462455e-01f,
+	8.700869911e-01f, 8.730949784e-01f, 8.760700942e-01f, 8.790122264e-01f,
+	8.819212643e-01f, 8.847970984e-01f, 8.876396204e-01f, 8.904487232e-01f,
+	8.932243012e-01f, 8.959662498e-01f, 8.986744657e-01f, 9.013488470e-01f,
+	9.039892931e-01f, 9.065957045e-01f, 9.091679831e-01f, 9.117060320e-01f,
+	9.142097557e-01f, 9.166790599e-01f, 9.191138517e-01f, 9.215140393e-01f,
+	9.238795325e-01f, 9.262102421e-01f, 9.285060805e-01f, 9.307669611e-01f,
+	9.329927988e-01f, 9.351835099e-01f, 9.373390119e-01f, 9.394592236e-01f,
+	9.415440652e-01f, 9.435934582e-01f, 9.456073254e-01f, 9.475855910e-01f,
+	9.495281806e-01f, 9.514350210e-01f, 9.533060404e-01f, 9.551411683e-01f,
+	9.569403357e-01f, 9.587034749e-01f, 9.604305194e-01f, 9.621214043e-01f,
+	9.637760658e-01f, 9.653944417e-01f, 9.669764710e-01f, 9.685220943e-01f,
+	9.700312532e-01f, 9.715038910e-01f, 9.729399522e-01f, 9.743393828e-01f,
+	9.757021300e-01f, 9.770281427e-01f, 9.783173707e-01f, 9.795697657e-01f,
+	9.807852804e-01f, 9.819638691e-01f, 9.831054874e-01f, 9.842100924e-01f,
+	9.852776424e-01f, 9.863080972e-01f, 9.873014182e-01f, 9.882575677e-01f,
+	9.891765100e-01f, 9.900582103e-01f, 9.909026354e-01f, 9.917097537e-01f,
+	9.924795346e-01f, 9.932119492e-01f, 9.939069700e-01f, 9.945645707e-01f,
+	9.951847267e-01f, 9.957674145e-01f, 9.963126122e-01f, 9.968202993e-01f,
+	9.972904567e-01f, 9.977230666e-01f, 9.981181129e-01f, 9.984755806e-01f,
+	9.987954562e-01f, 9.990777278e-01f, 9.993223846e-01f, 9.995294175e-01f,
+	9.996988187e-01f, 9.998305818e-01f, 9.999247018e-01f, 9.999811753e-01f,
+	1.000000000e+00f
+} };
+
+const std::array<int16_t, fft_quarter_n_max + 1> fft_quarter_sine_q15 { {
+	     0,    201,    402,    603,    804,   1005,   1206,   1407,
+	  1608,   1809,   2009,   2210,   2411,   2611,   2811,   3012,
+	  3212,   3412,   3612,   3812,   4011,   4211,   4410,   4609,
+	  4808,   5007,   5205,   5404,   5602,   5800,   5998,   6195,
+	  6393,   6590,   6787,   6983,   7180,   7376,   7571,   7767,
+	  7962,   8157,   8351,   8546,   8740,   8933,   9127,   9319,
+	  9512,   9704,   9896,  10088,  10279,  10469,  10660,  10850,
+	 11039,  11228,  11417,  11605,  11793,  11980,  12167,  12354,
+	 12540,  12725,  12910,  13095,  13279,  13463,  13646,  13828,
+	 14010,  14192,  14373,  14553,  14733,  14912,  15091,  15269,
+	 15447,  15624,  15800,  15976,  16151,  16326,  16500,  16673,
+	 16846,  17018,  17190,  17361,  17531,  17700,  17869,  18037,
+	 18205,  18372,  18538,  18703,  18868,  19032,  19195,  19358,
+	 19520,  19681,  19841,  20001,  20160,  20318,  20475,  20632,
+	 20788,  20943,  21097,  21251,  21403,  21555,  21706,  21856,
+	 22006,  22154,  22302,  22449,  22595,  22740,  22884,  23028,
+	 23170,  23312,  23453,  23593,  23732,  23870,  24008,  24144,
+	 24279,  24414,  24548,  24680,  24812,  24943,  25073,  25202,
+	 25330,  25457,  25583,  25708,  25833,  25956,  26078,  26199,
+	 26320,  26439,  26557,  26674,  26791,  26906,  27020,  27133,
+	 27246,  27357,  27467,  27576,  27684,  27791,  27897,  28002,
+	 28106,  28209,  28311,  28411,  28511,  28610,  28707,  28803,
+	 28899,  28993,  29086,  29178,  29269,  29359,  29448,  29535,
+	 29622,  29707,  29792,  29875,  29957,  30038,  30118,  30196,
+	 30274,  30350,  30425,  30499,  30572,  30644,  30715,  30784,
+	 30853,  30920,  30986,  31050,  31114,  31177,  31238,  31298,
+	 31357,  31415,  31471,  31527,  31581,  31634,  31686,  31737,
+	 31786,  31834,  31881,  31927,  31972,  32015,  32058,  32099,
+	 32138,  32177,  32214,  32251,  32286,  32319,  32352,  32383,
+	 32413,  32442,  32470,  32496,  32522,  32546,  32568,  32590,
+	 32610,  32629,  32647,  32664,  32679,  32693,  32706,  32718,
+	 32729,  32738,  32746,  32753,  32758,  32762,  32766,  32767,
+	 32767
+} };
+
+const std::array<int32_t, fft_quarter_n_max + 1> fft_quarter_sine_q31 { {
+	          0,    13176712,    26352928,    39528151,    52701887,    65873638,
+	   79042909,    92209205,   105372028,   118530885,   131685278,   144834714,
+	  157978697,   171116733,   184248325,   197372981,   210490206,   223599506,
+	  236700388,   249792358,   262874923,   275947592,   289009871,   302061269,
+	  315101295,   328129457,   341145265,   354148230,   367137861,   380113669,
+	  393075166,   406021865,   418953276,   431868915,   444768294,   457650927,
+	  470516330,   483364019,   496193509,   509004318,   521795963,   534567963,
+	  547319836,   560051104,   572761285,   585449903,   598116479,   610760536,
+	  623381598,   635979190,   648552838,   661102068,   673626408,   686125387,
+	  698598533,   711045377,   723465451,   735858287,   748223418,   760560380,
+	  772868706,   785147934,   797397602,   809617249,   821806413,   833964638,
+	  846091463,   858186435,   870249095,   882278992,   894275671,   906238681,
+	  918167572,   930061894,   941921200,   953745043,   965532978,   977284562,
+	  988999351,  1000676905,  1012316784,  1023918550,  1035481766,  1047005996,
+	 1058490808,  1069935768,  1081340445,  1092704411,  1104027237,  1115308496,
+	 1126547765,  1137744621,  1148898640,  1160009405,  1171076495,  1182099496,
+	 1193077991,  1204011567,  1214899813,  1225742318,  1236538675,  1247288478,
+	 1257991320,  1268646800,  1279254516,  1289814068,  1300325060,  1310787095,
+	 1321199781,  1331562723,  1341875533,  1352137822,  1362349204,  1372509294,
+	 1382617710,  1392674072,  1402678000,  1412629117,  1422527051,  1432371426,
+	 1442161874,  1451898025,  1461579514,  1471205974,  1480777044,  1490292364,
+	 1499751576,  1509154322,  1518500250,  1527789007,  1537020244,  1546193612,
+	 1555308768,  1564365367,  1573363068,  1582301533,  1591180426,  1599999411,
+	 1608758157,  1617456335,  1626093616,  1634669676,  1643184191,  1651636841,
+	 1660027308,  1668355276,  1676620432,  1684822463,  1692961062,  1701035922,
+	 1709046739,  1716993211,  1724875040,  1732691928,  1740443581,  1748129707,
+	 1755750017,  1763304224,  1770792044,  1778213194,  1785567396,  1792854372,
+	 1800073849,  1807225553,  1814309216,  1821324572,  1828271356,  1835149306,
+	 1841958164,  1848697674,  1855367581,  1861967634,  1868497586,  1874957189,
+	 1881346202,  1887664383,  1893911494,  1900087301,  1906191570,  1912224073,
+	 1918184581,  1924072871,  1929888720,  1935631910,  1941302225,  1946899451,
+	 1952423377,  1957873796,  1963250501,  1968553292,  1973781967,  1978936331,
+	 1984016189,  1989021350,  1993951625,  1998806829,  2003586779,  2008291295,
+	 2012920201,  2017473321,  2021950484,  2026351522,  2030676269,  2034924562,
+	 2039096241,  2043191150,  2047209133,  2051150040,  2055013723,  2058800036,
+	 2062508835,  2066139983,  2069693342,  2073168777,  2076566160,  2079885360,
+	 2083126254,  2086288720,  2089372638,  2092377892,  2095304370,  2098151960,
+	 2100920556,  2103610054,  2106220352,  2108751352,  2111202959,  2113575080,
+	 2115867626,  2118080511,  2120213651,  2122266967,  2124240380,  2126133817,
+	 2127947206,  2129680480,  2131333572,  2132906420,  2134398966,  2135811153,
+	 2137142927,  2138394240,  2139565043,  2140655293,  2141664948,  2142593971,
+	 2143442326,  2144209982,  2144896910,  2145503083,  2146028480,  2146473080,
+	 2146836866,  2147119825,  2147321946,  2147443222,  2147483647
+} };
@@ -28,6 +28,7 @@
 #include <cmath>
 #include <type_traits>
 #include <array>
+#include <limits>
 
 #include "dsp_types.hpp"
 #include "complex.hpp"
@@ -135,4 +136,184 @@ void fft_c_preswapped(std::array<T, N>& data, const size_t from, const size_t to
 	}
 }
 
+/* Radix-4 decimation-in-time FFT, for sizes up to fft_n_max points.
+ *
+ * Data is provided pre-swapped (bit-reversed order, see fft_swap()), same as
+ * fft_c_preswapped(). Pairs of radix-2 stages are merged into one radix-4
+ * pass, so each pass costs three complex multiplies per four points instead
+ * of four, and memory is traversed half as often. An odd number of stages
+ * is handled with a leading multiply-free radix-2 pass.
+ *
+ * Twiddle factors come from quarter-wave sine tables in ROM (dsp_fft.cpp)
+ * rather than from a recurrence, so accuracy does not degrade with size.
+ */
+
+constexpr size_t fft_n_max_log2 = 10;
+constexpr size_t fft_n_max = 1 << fft_n_max_log2;
+constexpr size_t fft_quarter_n_max = fft_n_max / 4;
+
+/*
+import numpy
+length = 1024 / 4
+v = numpy.sin(numpy.arange(length + 1) * (numpy.pi / 2 / length))
+*/
+extern const std::array<float, fft_quarter_n_max + 1> fft_quarter_sine_f32;
+extern const std::array<int16_t, fft_quarter_n_max + 1> fft_quarter_sine_q15;
+extern const std::array<int32_t, fft_quarter_n_max + 1> fft_quarter_sine_q31;
+
+/* W^k = exp(-2*pi*j*k/fft_n_max), valid for 0 <= k < 3 * fft_quarter_n_max,
+ * which covers every twiddle a radix-4 pass needs.
+ */
+template<typename T, typename Table>
+inline T fft_twiddle(const Table& quarter_sine, const size_t k) {
+	constexpr size_t q = fft_quarter_n_max;
+	const size_t r = k & (q - 1);
+	switch(k / q) {
+	case 0:  return { quarter_sine[q - r], -quarter_sine[r] };
+	case 1:  return { -quarter_sine[r], -quarter_sine[q - r] };
+	default: return { -quarter_sine[q - r], quarter_sine[r] };
+	}
+}
+
+template<typename T, size_t N>
+void fft_c_preswapped_radix4(std::array<T, N>& data) {
+	static_assert(power_of_two(N), "only defined for N == power of two");
+	static_assert(N <= fft_n_max, "No FFT twiddle factors for N > fft_n_max");
+	constexpr auto K = log_2(N);
+
+	size_t m = 1;
+	if( K & 1 ) {
+		for(size_t i=0; i<N; i+=2) {
+			const T a = data[i + 0];
+			const T b = data[i + 1];
+			data[i + 0] = a + b;
+			data[i + 1] = a - b;
+		}
+		m = 2;
+	}
+
+	for(; m < N; m *= 4) {
+		const size_t stride = fft_n_max / (m * 4);
+		for(size_t j=0; j<m; j++) {
+			const auto w1 = fft_twiddle<T>(fft_quarter_sine_f32, j * stride * 1);
+			const auto w2 = fft_twiddle<T>(fft_quarter_sine_f32, j * stride * 2);
+			const auto w3 = fft_twiddle<T>(fft_quarter_sine_f32, j * stride * 3);
+			for(size_t i=j; i<N; i+=m*4) {
+				const T x0 = data[i + m * 0];
+				const T b1 = data[i + m * 1] * w2;
+				const T b2 = data[i + m * 2] * w1;
+				const T b3 = data[i + m * 3] * w3;
+				const T s0 = x0 + b1;
+				const T d0 = x0 - b1;
+				const T s1 = b2 + b3;
+				const T d1_mj { b2.imag() - b3.imag(), b3.real() - b2.real() };	// -j * (b2 - b3)
+				data[i + m * 0] = s0 + s1;
+				data[i + m * 1] = d0 + d1_mj;
+				data[i + m * 2] = s0 - s1;
+				data[i + m * 3] = d0 - d1_mj;
+			}
+		}
+	}
+}
+
+/* Fixed-point variants operate in place on Q15 (complex16_t) or Q31
+ * (complex32_t) samples, giving a result scaled by 1/N overall.
+ *
+ * Each radix-4 pass scales by 1/4 (1/2 for the leading radix-2 pass). For
+ * inputs with magnitude at most full scale, that keeps every output within
+ * full scale, since a twiddle only rotates. Components are another matter:
+ * a rotation can grow one by sqrt(2), so inputs out in the corners of the
+ * square (e.g. -32768 - 32768j) and rounding at full scale could still
+ * exceed the sample type. Stores saturate rather than wrap for that case.
+ */
+
+template<typename T>
+struct fft_fixed_traits;
+
+template<>
+struct fft_fixed_traits<complex16_t> {
+	using accum_type = int32_t;
+	static constexpr size_t twiddle_bits = 15;
+	static constexpr const std::array<int16_t, fft_quarter_n_max + 1>& quarter_sine = fft_quarter_sine_q15;
+};
+
+template<>
+struct fft_fixed_traits<complex32_t> {
+	using accum_type = int64_t;
+	static constexpr size_t twiddle_bits = 31;
+	static constexpr const std::array<int32_t, fft_quarter_n_max + 1>& quarter_sine = fft_quarter_sine_q31;
+};
+
+template<typename T, size_t N>
+void fft_c_preswapped_radix4_fixed(std::array<T, N>& data) {
+	static_assert(power_of_two(N), "only defined for N == power of two");
+	static_assert(N <= fft_n_max, "No FFT twiddle factors for N > fft_n_max");
+	constexpr auto K = log_2(N);
+
+	using traits = fft_fixed_traits<T>;
+	using A = typename traits::accum_type;
+	using V = typename T::value_type;
+	using W = std::complex<A>;
+	constexpr size_t B = traits::twiddle_bits;
+
+	const auto mul = [](const T& x, const W& w) -> W {
+		const A xr = x.real();
+		const A xi = x.imag();
+		constexpr A round = A(1) << (B - 1);
+		return {
+			(xr * w.real() - xi * w.imag() + round) >> B,
+			(xr * w.imag() + xi * w.real() + round) >> B
+		};
+	};
+
+	/* Round, scale by 1/2^shift, and saturate to the sample type. */
+	const auto narrow = [](const A v, const size_t shift) -> V {
+		const A r = (v + (A(1) << (shift - 1))) >> shift;
+		constexpr A min = std::numeric_limits<V>::min();
+		constexpr A max = std::numeric_limits<V>::max();
+		return static_cast<V>((r < min) ? min : ((r > max) ? max : r));
+	};
+
+	size_t m = 1;
+	if( K & 1 ) {
+		for(size_t i=0; i<N; i+=2) {
+			const A ar = data[i + 0].real();
+			const A ai = data[i + 0].imag();
+			const A br = data[i + 1].real();
+			const A bi = data[i + 1].imag();
+			data[i + 0] = { narrow(ar + br, 1), narrow(ai + bi, 1) };
+			data[i + 1] = { narrow(ar - br, 1), narrow(ai - bi, 1) };
+		}
+		m = 2;
+	}
+
+	for(; m < N; m *= 4) {
+		const size_t stride = fft_n_max / (m * 4);
+		for(size_t j=0; j<m; j++) {
+			const auto w1 = fft_twiddle<W>(traits::quarter_sine, j * stride * 1);
+			const auto w2 = fft_twiddle<W>(traits::quarter_sine, j * stride * 2);
+			const auto w3 = fft_twiddle<W>(traits::quarter_sine, j * stride * 3);
+			for(size_t i=j; i<N; i+=m*4) {
+				const A x0r = data[i + m * 0].real();
+				const A x0i = data[i + m * 0].imag();
+				const W b1 = mul(data[i + m * 1], w2);
+				const W b2 = mul(data[i + m * 2], w1);
+				const W b3 = mul(data[i + m * 3], w3);
+				const A s0r = x0r + b1.real();
+				const A s0i = x0i + b1.imag();
+				const A d0r = x0r - b1.real();
+				const A d0i = x0i - b1.imag();
+				const A s1r = b2.real() + b3.real();
+				const A s1i = b2.imag() + b3.imag();
+				const A d1r = b2.imag() - b3.imag();	// -j * (b2 - b3)
+				const A d1i = b3.real() - b2.real();
+				data[i + m * 0] = { narrow(s0r + s1r, 2), narrow(s0i + s1i, 2) };
+				data[i + m * 1] = { narrow(d0r + d1r, 2), narrow(d0i + d1i, 2) };
+				data[i + m * 2] = { narrow(s0r - s1r, 2), narrow(s0i - s1i, 2) };
+				data[i + m * 3] = { narrow(d0r - d1r, 2), narrow(d0i - d1i, 2) };
+			}
+		}
+	}
+}
+
 #endif/*__DSP_FFT_H__*/
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "iq_format.hpp"
+
+#include <cstring>
+
+namespace iq_format {
+
+namespace {
+
+/* Maps v < 0 to -v - 1, so the highest set bit of the result is the highest
+ * magnitude bit needed to represent v in two's complement.
+ */
+inline uint32_t fold(const int32_t v) {
+	return v ^ (v >> 31);
+}
+
+size_t encode_bfp4(const complex16_t* const src, const size_t count, uint8_t* const dst) {
+	uint8_t* p = dst;
+
+	for(size_t n=0; n<count; n+=bfp4_block_samples) {
+		const auto block = &src[n];
+
+		uint32_t m = 0;
+		for(size_t i=0; i<bfp4_block_samples; i++) {
+			m |= fold(block[i].real()) | fold(block[i].imag());
+		}
+
+		// Smallest shift that brings every component into [-8, 7].
+		const int32_t bits = m ? (32 - __builtin_clz(m)) : 0;
+		const int32_t shift = (bits > 3) ? (bits - 3) : 0;
+
+		*(p++) = shift;
+		for(size_t i=0; i<bfp4_block_samples; i++) {
+			const uint32_t re = (block[i].real() >> shift) & 0xf;
+			const uint32_t im = (block[i].imag() >> shift) & 0xf;
+			*(p++) = re | (im << 4);
+		}
+	}
+
+	return p - dst;
+}
+
+void decode_bfp4(const uint8_t* const src, const size_t count, complex16_t* const dst) {
+	const uint8_t* p = src;
+
+	for(size_t n=0; n<count; n+=bfp4_block_samples) {
+		const int32_t shift = *(p++);
+		const int32_t half = (shift > 0) ? (1 << (shift - 1)) : 0;
+
+		for(size_t i=0; i<bfp4_block_samples; i++) {
+			const int8_t v = *(p++);
+			const int32_t re = static_cast<int8_t>(v << 4) >> 4;
+			const int32_t im = v >> 4;
+			dst[n + i] = {
+				static_cast<int16_t>((re << shift) + half),
+				static_cast<int16_t>((im << shift) + half)
+			};
+		}
+	}
+}
+
+} /* namespace */
+
+size_t encode(const IQFormat format, const complex16_t* const src, const size_t count, uint8_t* const dst) {
+	switch(format) {
+	case IQFormat::C8:
+		{
+			auto p = reinterpret_cast<complex8_t*>(dst);
+			for(size_t i=0; i<count; i++) {
+				p[i] = {
+					static_cast<int8_t>(src[i].real() >> 8),
+					static_cast<int8_t>(src[i].imag() >> 8)
+				};
+			}
+			return count * sizeof(complex8_t);
+		}
+
+	case IQFormat::BFP4:
+		return encode_bfp4(src, count, dst);
+
+	case IQFormat::C16:
+	default:
+		memcpy(dst, src, count * sizeof(complex16_t));
+		return count * sizeof(complex16_t);
+	}
+}
+
+void decode(const IQFormat format, const uint8_t* const src, const size_t count, complex16_t* const dst) {
+	switch(format) {
+	case IQFormat::C8:
+		{
+			auto p = reinterpret_cast<const complex8_t*>(src);
+			for(size_t i=0; i<count; i++) {
+				dst[i] = {
+					static_cast<int16_t>(p[i].real() << 8),
+					static_cast<int16_t>(p[i].imag() << 8)
+				};
+			}
+		}
+		break;
+
+	case IQFormat::BFP4:
+		decode_bfp4(src, count, dst);
+		break;
+
+	case IQFormat::C16:
+	default:
+		memcpy(dst, src, count * sizeof(complex16_t));
+		break;
+	}
+}
+
+} /* namespace iq_format */
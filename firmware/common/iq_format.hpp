@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __IQ_FORMAT_H__
+#define __IQ_FORMAT_H__
+
+#include "complex.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+/* Sample formats for IQ capture files.
+ *
+ * C16:  complex16_t, little-endian, 4 bytes per sample.
+ * C8:   complex8_t, the top 8 bits of each C16 component, 2 bytes per sample.
+ * BFP4: 4-bit block floating point. Blocks of 64 samples, each a shift
+ *       count byte followed by one byte per sample (I in the low nibble,
+ *       Q in the high nibble, both signed). A component decodes to
+ *       (nibble << shift) plus half a step.
+ *
+ * Files are always whole blocks, and the capture buffer size is a multiple
+ * of the block size, so dropped data never leaves a partial block behind.
+ */
+enum class IQFormat : uint8_t {
+	C16 = 0,
+	C8 = 1,
+	BFP4 = 2,
+};
+
+namespace iq_format {
+
+constexpr size_t bfp4_block_samples = 64;
+
+constexpr size_t block_samples(const IQFormat format) {
+	return (format == IQFormat::BFP4) ? bfp4_block_samples : 1;
+}
+
+constexpr size_t block_bytes(const IQFormat format) {
+	return (format == IQFormat::BFP4) ? (1 + bfp4_block_samples)
+		: ((format == IQFormat::C8) ? 2 : 4);
+}
+
+constexpr const char* name(const IQFormat format) {
+	return (format == IQFormat::BFP4) ? "BFP4"
+		: ((format == IQFormat::C8) ? "C8" : "C16");
+}
+
+/* File extension, including the dot. */
+constexpr const char* extension(const IQFormat format) {
+	return (format == IQFormat::BFP4) ? ".CBF"
+		: ((format == IQFormat::C8) ? ".C8" : ".C16");
+}
+
+/* Encodes count samples (a whole number of blocks) into dst, returns the
+ * number of bytes written.
+ */
+size_t encode(const IQFormat format, const complex16_t* const src, const size_t count, uint8_t* const dst);
+
+/* Decodes count samples (a whole number of blocks) from src. */
+void decode(const IQFormat format, const uint8_t* const src, const size_t count, complex16_t* const dst);
+
+} /* namespace iq_format */
+
+#endif/*__IQ_FORMAT_H__*/
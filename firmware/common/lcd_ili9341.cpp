@@ -31,6 +31,7 @@ using namespace portapack;
 #include "ch.h"
 
 #include <complex>
+#include <algorithm>
 
 namespace lcd {
 
@@ -215,10 +216,18 @@ void lcd_paset(const uint_fast16_t start_page, const uint_fast16_t end_page) {
 	lcd_set(0x2b, start_page, end_page);
 }
 
+/* Pixels sent through RAM write windows since boot, and the bounding box of
+ * the windows opened since the last ILI9341::reset_write_extent().
+ */
+uint32_t ram_write_pixels = 0;
+ui::Rect ram_write_extent { };
+
 void lcd_start_ram_write(
 	const ui::Point p,
 	const ui::Size s
 ) {
+	ram_write_pixels += s.width() * s.height();
+	ram_write_extent += ui::Rect { p, s };
 	lcd_caset(p.x(), p.x() + s.width()  - 1);
 	lcd_paset(p.y(), p.y() + s.height() - 1);
 	lcd_ramwr_start();
@@ -269,7 +278,7 @@ void lcd_vertical_scrolling_start_address(
 	});
 }
 
-}
+} /* namespace */
 
 void ILI9341::init() {
 	lcd_reset();
@@ -512,6 +521,106 @@ void ILI9341::draw_glyph(
 	draw_bitmap(p, glyph.size(), glyph.pixels(), foreground, background);
 }
 
+/* Glyphs are 1bpp, LSB first, rows packed back to back. The whole run gets
+ * one RAM window, filled a line at a time: each line of all the glyphs is
+ * expanded into a line buffer, two pixels per table lookup, and written out
+ * in one burst.
+ */
+int ILI9341::draw_glyph_run(
+	const ui::Point p,
+	const ui::Font& font,
+	const char* const text,
+	const size_t count,
+	const ui::Color foreground,
+	const ui::Color background
+) {
+	static constexpr size_t glyphs_max = 240 / 4;
+	
+	if( !count ) {
+		return 0;
+	}
+	
+	const auto glyph_size = font.glyph(text[0]).size();
+	const size_t w = glyph_size.width();
+	const size_t h = glyph_size.height();
+	
+	// Only what fits on screen goes in the window, as with single glyphs
+	// anything else is drawn one by one.
+	size_t run_count = 0;
+	if( (p.x() >= 0) && (p.x() < width()) && (w >= 4) && !(w & 1) ) {
+		run_count = std::min(std::min(count, (width() - p.x()) / w), glyphs_max);
+	}
+	
+	if( run_count ) {
+		std::array<const uint8_t*, glyphs_max> glyphs;
+		for(size_t i=0; i<run_count; i++) {
+			glyphs[i] = font.glyph(text[i]).pixels();
+		}
+		
+		// Bit pairs to pixel pairs, first pixel in the low half
+		const uint32_t bg = background.v;
+		const uint32_t fg = foreground.v;
+		const std::array<uint32_t, 4> pairs { {
+			bg | (bg << 16),
+			fg | (bg << 16),
+			bg | (fg << 16),
+			fg | (fg << 16)
+		} };
+		
+		std::array<uint32_t, 240 / 2> line_buffer;
+		const size_t run_width = run_count * w;
+		lcd_start_ram_write(p, { static_cast<int>(run_width), static_cast<int>(h) });
+		
+		for(size_t y=0; y<h; y++) {
+			const size_t bit_start = y * w;
+			auto out = line_buffer.data();
+			
+			for(size_t i=0; i<run_count; i++) {
+				const auto pixels = glyphs[i];
+				if( !(w & 7) && !(bit_start & 7) ) {
+					// Whole bytes
+					for(size_t n=0; n<(w >> 3); n++) {
+						const uint32_t bits = pixels[(bit_start >> 3) + n];
+						*(out++) = pairs[bits & 3];
+						*(out++) = pairs[(bits >> 2) & 3];
+						*(out++) = pairs[(bits >> 4) & 3];
+						*(out++) = pairs[(bits >> 6) & 3];
+					}
+				} else {
+					for(size_t bit=bit_start; bit<bit_start + w; bit += 2) {
+						const uint32_t bits = (pixels[bit >> 3] >> (bit & 7)) & 1;
+						const uint32_t next = (pixels[(bit + 1) >> 3] >> ((bit + 1) & 7)) & 1;
+						*(out++) = pairs[bits | (next << 1)];
+					}
+				}
+			}
+			
+			io.lcd_write_pixels(reinterpret_cast<const ui::Color*>(line_buffer.data()), run_width);
+		}
+	}
+	
+	ui::Point pos = p + ui::Point(run_count * w, 0);
+	for(size_t i=run_count; i<count; i++) {
+		const auto glyph = font.glyph(text[i]);
+		draw_glyph(pos, glyph, foreground, background);
+		pos += glyph.advance();
+	}
+	
+	return pos.x() - p.x();
+}
+
+uint32_t ILI9341::pixels_written() const {
+	return ram_write_pixels;
+}
+
+ui::Rect ILI9341::write_extent() const {
+	return ram_write_extent;
+}
+
+void ILI9341::reset_write_extent() {
+	ram_write_extent = { };
+}
+
 void ILI9341::scroll_set_area(
 	const ui::Coord top_y,
 	const ui::Coord bottom_y
@@ -94,6 +94,22 @@ public:
 		const ui::Color background
 	);
 
+	// Draws count characters in one go, returns the width drawn
+	int draw_glyph_run(
+		const ui::Point p,
+		const ui::Font& font,
+		const char* const text,
+		const size_t count,
+		const ui::Color foreground,
+		const ui::Color background
+	);
+
+	/* Running total of pixels written to the panel (wraps). */
+	uint32_t pixels_written() const;
+	/* Bounding box of everything written since reset_write_extent(). */
+	ui::Rect write_extent() const;
+	void reset_write_extent();
+
 	void scroll_set_area(const ui::Coord top_y, const ui::Coord bottom_y);
 	ui::Coord scroll_set_position(const ui::Coord position);
 	ui::Coord scroll(const int32_t delta);
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "lz4_block.hpp"
+
+#include <cstring>
+
+namespace lz4 {
+
+namespace {
+
+/* Length fields of 15 continue in following bytes, each adding up to 255. */
+bool read_length(const uint8_t*& p, const uint8_t* const end, size_t& length) {
+	uint8_t b;
+	do {
+		if( p >= end ) {
+			return false;
+		}
+		b = *(p++);
+		length += b;
+	} while( b == 255 );
+	return true;
+}
+
+} /* namespace */
+
+size_t decompress_block(
+	const uint8_t* src, const size_t src_size,
+	uint8_t* dst, const size_t dst_size
+) {
+	const uint8_t* ip = src;
+	const uint8_t* const ip_end = src + src_size;
+	uint8_t* op = dst;
+	uint8_t* const op_end = dst + dst_size;
+
+	while( ip < ip_end ) {
+		const uint32_t token = *(ip++);
+
+		size_t literal_length = token >> 4;
+		if( (literal_length == 15) && !read_length(ip, ip_end, literal_length) ) {
+			return 0;
+		}
+		if( (literal_length > size_t(ip_end - ip)) || (literal_length > size_t(op_end - op)) ) {
+			return 0;
+		}
+		std::memcpy(op, ip, literal_length);
+		ip += literal_length;
+		op += literal_length;
+
+		/* The last sequence is literals only. */
+		if( ip == ip_end ) {
+			break;
+		}
+
+		if( (ip_end - ip) < 2 ) {
+			return 0;
+		}
+		const size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if( (offset == 0) || (offset > size_t(op - dst)) ) {
+			return 0;
+		}
+
+		size_t match_length = token & 15;
+		if( (match_length == 15) && !read_length(ip, ip_end, match_length) ) {
+			return 0;
+		}
+		match_length += 4;
+		if( match_length > size_t(op_end - op) ) {
+			return 0;
+		}
+
+		/* Matches may overlap their own output (offset < length encodes a
+		 * run), so copy forward a byte at a time unless they are disjoint.
+		 */
+		const uint8_t* match = op - offset;
+		if( offset >= match_length ) {
+			std::memcpy(op, match, match_length);
+			op += match_length;
+		} else {
+			while( match_length-- ) {
+				*(op++) = *(match++);
+			}
+		}
+	}
+
+	return op - dst;
+}
+
+} /* namespace lz4 */
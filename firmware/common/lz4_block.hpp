@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __LZ4_BLOCK_H__
+#define __LZ4_BLOCK_H__
+
+#include <cstdint>
+#include <cstddef>
+
+namespace lz4 {
+
+/* Decoder for the LZ4 block format (no frame header, no checksums), as
+ * written by tools/make_image_chunk.py for compressed baseband images.
+ *
+ * Every read and write is bounds-checked. Returns the number of bytes
+ * written to dst, or 0 if the stream is malformed or does not fit.
+ */
+size_t decompress_block(
+	const uint8_t* src, const size_t src_size,
+	uint8_t* dst, const size_t dst_size
+);
+
+} /* namespace lz4 */
+
+#endif/*__LZ4_BLOCK_H__*/
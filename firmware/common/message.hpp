@@ -42,6 +42,7 @@
 #include "dsp_fir_taps.hpp"
 #include "dsp_iir.hpp"
 #include "fifo.hpp"
+#include "iq_format.hpp"
 
 #include "utility.hpp"
 
@@ -111,6 +112,15 @@ public:
 		AudioLevelReport = 51,
 		CodedSquelch = 52,
 		AudioSpectrum = 53,
+		BasebandProfile = 54,
+		ChannelStatsConfig = 55,
+		SweepConfig = 56,
+		SweepRetune = 57,
+		SweepTuned = 58,
+		SweepSpectrum = 59,
+		SpectrumConfig = 60,
+		ADSBStatistics = 61,
+		POCSAGStatistics = 62,
 		MAX
 	};
 
@@ -142,6 +152,34 @@ public:
 	RSSIStatistics statistics;
 };
 
+struct CycleStatistics {
+	uint32_t count { 0 };
+	uint32_t cycles_min { 0 };
+	uint32_t cycles_max { 0 };
+	uint32_t cycles_avg { 0 };
+};
+
+struct BasebandProfile {
+	CycleStatistics execute { };
+	CycleStatistics spectrum { };
+	CycleStatistics events { };
+	uint32_t cycles_budget { 0 };
+	uint32_t overruns { 0 };
+	uint32_t buffers_skipped { 0 };
+};
+
+class BasebandProfileMessage : public Message {
+public:
+	constexpr BasebandProfileMessage(
+		const BasebandProfile& profile
+	) : Message { ID::BasebandProfile },
+		profile { profile }
+	{
+	}
+
+	BasebandProfile profile;
+};
+
 struct BasebandStatistics {
 	uint32_t idle_ticks { 0 };
 	uint32_t main_ticks { 0 };
@@ -175,6 +213,21 @@ struct ChannelStatistics {
 	}
 };
 
+/* Sets how often ChannelStatistics are reported, 0 for the default. Faster
+ * updates let a scanner decide sooner whether a channel is busy.
+ */
+class ChannelStatsConfigMessage : public Message {
+public:
+	constexpr ChannelStatsConfigMessage(
+		const uint32_t update_interval_ms
+	) : Message { ID::ChannelStatsConfig },
+		update_interval_ms { update_interval_ms }
+	{
+	}
+
+	const uint32_t update_interval_ms;
+};
+
 class ChannelStatisticsMessage : public Message {
 public:
 	constexpr ChannelStatisticsMessage(
@@ -263,6 +316,37 @@ public:
 	Mode mode { Mode::Stopped };
 };
 
+struct SpectrumConfig {
+	enum class Window : uint8_t {
+		None = 0,
+		Hann = 1,
+		BlackmanHarris = 2,
+	};
+
+	enum class Trace : uint8_t {
+		Average = 0,
+		MaxHold = 1,
+		MinHold = 2,
+	};
+
+	Window window { Window::Hann };
+	Trace trace { Trace::Average };
+	bool overlap { true };		// 50% overlap between FFT frames
+	uint8_t averages { 2 };		// Frames averaged (linear power) per spectrum
+};
+
+class SpectrumConfigMessage : public Message {
+public:
+	constexpr SpectrumConfigMessage(
+		const SpectrumConfig& config
+	) : Message { ID::SpectrumConfig },
+		config { config }
+	{
+	}
+
+	SpectrumConfig config;
+};
+
 class WidebandSpectrumConfigMessage : public Message {
 public:
 	constexpr WidebandSpectrumConfigMessage (
@@ -278,6 +362,77 @@ public:
 	size_t trigger { 0 };
 };
 
+/* Wideband sweep: the baseband asks for each span in turn with a
+ * SweepRetuneMessage, the application retunes and answers with a
+ * SweepTunedMessage. Once all spans are done, a SweepSpectrumMessage points
+ * to the stitched power array (one byte per bin, lowest frequency first).
+ */
+class SweepConfigMessage : public Message {
+public:
+	static constexpr size_t spans_max = 64;
+	static constexpr size_t bins_max = 4096;
+
+	constexpr SweepConfigMessage(
+		const size_t spans,
+		const size_t sampling_rate,
+		const size_t settle_buffers,
+		const size_t averages
+	) : Message { ID::SweepConfig },
+		spans { spans },
+		sampling_rate { sampling_rate },
+		settle_buffers { settle_buffers },
+		averages { averages }
+	{
+	}
+
+	size_t spans { 0 };			// 0 stops the sweep
+	size_t sampling_rate { 0 };
+	size_t settle_buffers { 0 };	// Discarded after each retune
+	size_t averages { 0 };		// FFTs averaged per span
+};
+
+class SweepRetuneMessage : public Message {
+public:
+	constexpr SweepRetuneMessage(
+		const size_t span
+	) : Message { ID::SweepRetune },
+		span { span }
+	{
+	}
+
+	size_t span { 0 };
+};
+
+class SweepTunedMessage : public Message {
+public:
+	constexpr SweepTunedMessage(
+		const size_t span
+	) : Message { ID::SweepTuned },
+		span { span }
+	{
+	}
+
+	size_t span { 0 };
+};
+
+class SweepSpectrumMessage : public Message {
+public:
+	constexpr SweepSpectrumMessage(
+		const uint8_t* const db,
+		const size_t spans,
+		const size_t bins_per_span
+	) : Message { ID::SweepSpectrum },
+		db { db },
+		spans { spans },
+		bins_per_span { bins_per_span }
+	{
+	}
+
+	const uint8_t* db { nullptr };
+	size_t spans { 0 };
+	size_t bins_per_span { 0 };
+};
+
 struct AudioSpectrum {
 	std::array<uint8_t, 128> db { { 0 } };
 	//uint32_t sampling_rate { 0 };
@@ -300,6 +455,8 @@ struct ChannelSpectrum {
 	uint32_t sampling_rate { 0 };
 	uint32_t channel_filter_pass_frequency { 0 };
 	uint32_t channel_filter_stop_frequency { 0 };
+	SpectrumConfig config { };
+	uint8_t noise_floor { 0 };	// Median of the averaged bins, same scale as db
 };
 
 using ChannelSpectrumFIFO = FIFO<ChannelSpectrum>;
@@ -381,6 +538,33 @@ public:
 	adsb::ADSBFrame frame;
 };
 
+class ADSBStatisticsMessage : public Message {
+public:
+	constexpr ADSBStatisticsMessage(
+		const uint32_t preambles,
+		const uint32_t frames
+	) : Message { ID::ADSBStatistics },
+		preambles { preambles },
+		frames { frames }
+	{
+	}
+	
+	uint32_t preambles;		// Per second
+	uint32_t frames;
+};
+
+class POCSAGStatisticsMessage : public Message {
+public:
+	constexpr POCSAGStatisticsMessage(
+		const pocsag::POCSAGStatistics& statistics
+	) : Message { ID::POCSAGStatistics },
+		statistics { statistics }
+	{
+	}
+
+	pocsag::POCSAGStatistics statistics;
+};
+
 class AFSKDataMessage : public Message {
 public:
 	constexpr AFSKDataMessage(
@@ -626,16 +810,21 @@ struct CaptureConfig {
 	const size_t buffer_count;
 	uint64_t baseband_bytes_received;
 	uint64_t baseband_bytes_dropped;
+	size_t buffers_queued_max;
+	const IQFormat format;
 	FIFO<StreamBuffer*>* fifo_buffers_empty;
 	FIFO<StreamBuffer*>* fifo_buffers_full;
 
 	constexpr CaptureConfig(
 		const size_t write_size,
-		const size_t buffer_count
+		const size_t buffer_count,
+		const IQFormat format = IQFormat::C16
 	) : write_size { write_size },
 		buffer_count { buffer_count },
 		baseband_bytes_received { 0 },
 		baseband_bytes_dropped { 0 },
+		buffers_queued_max { 0 },
+		format { format },
 		fifo_buffers_empty { nullptr },
 		fifo_buffers_full { nullptr }
 	{
@@ -646,7 +835,7 @@ struct CaptureConfig {
 			return 0;
 		} else {
 			const size_t percent = baseband_bytes_dropped * 100U / baseband_bytes_received;
-			return std::max(1U, percent);
+			return std::max<size_t>(1, percent);
 		}
 	}
 };
@@ -667,15 +856,18 @@ struct ReplayConfig {
 	const size_t read_size;
 	const size_t buffer_count;
 	uint64_t baseband_bytes_received;
+	const IQFormat format;
 	FIFO<StreamBuffer*>* fifo_buffers_empty;
 	FIFO<StreamBuffer*>* fifo_buffers_full;
 
 	constexpr ReplayConfig(
 		const size_t read_size,
-		const size_t buffer_count
+		const size_t buffer_count,
+		const IQFormat format = IQFormat::C16
 	) : read_size { read_size },
 		buffer_count { buffer_count },
 		baseband_bytes_received { 0 },
+		format { format },
 		fifo_buffers_empty { nullptr },
 		fifo_buffers_full { nullptr }
 	{
@@ -702,7 +894,9 @@ public:
 	}
 	
 	uint32_t progress = 0;
+	uint32_t underruns = 0;
 	bool done = false;
+	bool error = false;		// Configuration rejected, nothing will be sent
 };
 
 class AFSKRxConfigureMessage : public Message {
@@ -833,13 +1027,17 @@ public:
 class SamplerateConfigMessage : public Message {
 public:
 	constexpr SamplerateConfigMessage(
-		const uint32_t sample_rate
+		const uint32_t sample_rate,
+		const uint32_t source_sample_rate = 0
 	) : Message { ID::SamplerateConfig },
-		sample_rate(sample_rate)
+		sample_rate(sample_rate),
+		source_sample_rate(source_sample_rate)
 	{
 	}
 	
 	const uint32_t sample_rate = 0;
+	// Rate of the data fed to the baseband, if it differs (0 if not)
+	const uint32_t source_sample_rate = 0;
 };
 
 class AudioLevelReportMessage : public Message {
@@ -859,13 +1057,17 @@ public:
 		const float deviation_hz,
 		const float audio_gain,
 		const uint32_t tone_key_delta,
-		const float tone_key_mix_weight
+		const float tone_key_mix_weight,
+		const uint32_t bits_per_sample = 8,
+		const uint32_t pre_emphasis_us = 0
 	) : Message { ID::AudioTXConfig },
 		divider(divider),
 		deviation_hz(deviation_hz),
 		audio_gain(audio_gain),
 		tone_key_delta(tone_key_delta),
-		tone_key_mix_weight(tone_key_mix_weight)
+		tone_key_mix_weight(tone_key_mix_weight),
+		bits_per_sample(bits_per_sample),
+		pre_emphasis_us(pre_emphasis_us)
 	{
 	}
 
@@ -874,6 +1076,10 @@ public:
 	const float audio_gain;
 	const uint32_t tone_key_delta;
 	const float tone_key_mix_weight;
+	// Format of streamed audio: 8-bit unsigned or 16-bit signed
+	const uint32_t bits_per_sample;
+	// Pre-emphasis time constant, 0 for none
+	const uint32_t pre_emphasis_us;
 };
 
 class SigGenConfigMessage : public Message {
@@ -993,15 +1199,12 @@ public:
 class POCSAGConfigureMessage : public Message {
 public:
 	constexpr POCSAGConfigureMessage(
-		const pocsag::BitRate bitrate,
 		const bool phase
 	) : Message { ID::POCSAGConfigure },
-		bitrate(bitrate),
 		phase(phase)
 	{
 	}
 
-	const pocsag::BitRate bitrate;
 	const bool phase;
 };
 
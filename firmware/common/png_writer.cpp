@@ -21,6 +21,9 @@
 
 #include "png_writer.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 static constexpr std::array<uint8_t, 8> png_file_header { {
 	0x89, 0x50, 0x4e, 0x47,
 	0x0d, 0x0a, 0x1a, 0x0a,
@@ -49,6 +52,83 @@ static constexpr std::array<uint8_t, 12> png_iend { {
 	0xae, 0x42, 0x60, 0x82,		// CRC
 } };
 
+namespace {
+
+/* DEFLATE fixed Huffman code (RFC 1951, 3.2.6). Codes are sent most
+ * significant bit first, so they are stored here already reversed.
+ */
+constexpr uint32_t reverse_bits(uint32_t v, const size_t count) {
+	uint32_t result = 0;
+	for(size_t i=0; i<count; i++) {
+		result = (result << 1) | (v & 1);
+		v >>= 1;
+	}
+	return result;
+}
+
+constexpr size_t fixed_literal_code_length(const uint32_t symbol) {
+	return (symbol < 144) ? 8 : (symbol < 256) ? 9 : (symbol < 280) ? 7 : 8;
+}
+
+constexpr std::array<uint16_t, 288> make_fixed_literal_codes() {
+	std::array<uint16_t, 288> codes { };
+	for(uint32_t symbol=0; symbol<codes.size(); symbol++) {
+		const uint32_t code =
+			(symbol < 144) ? (0x030 + symbol) :
+			(symbol < 256) ? (0x190 + symbol - 144) :
+			(symbol < 280) ? (0x000 + symbol - 256) :
+			                 (0x0c0 + symbol - 280);
+		codes[symbol] = reverse_bits(code, fixed_literal_code_length(symbol));
+	}
+	return codes;
+}
+
+constexpr auto fixed_literal_codes = make_fixed_literal_codes();
+
+constexpr std::array<uint16_t, 29> length_base { {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+} };
+
+constexpr std::array<uint8_t, 29> length_extra_bits { {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+} };
+
+constexpr std::array<uint16_t, 30> distance_base { {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+} };
+
+constexpr std::array<uint8_t, 30> distance_extra_bits { {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+} };
+
+/* Length code index for each match length 3...258 */
+constexpr std::array<uint8_t, 256> make_length_codes() {
+	std::array<uint8_t, 256> codes { };
+	size_t code = 0;
+	for(size_t length=3; length<=258; length++) {
+		while( (code + 1 < length_base.size()) && (length_base[code + 1] <= length) ) {
+			code++;
+		}
+		codes[length - 3] = code;
+	}
+	return codes;
+}
+
+constexpr auto length_codes = make_length_codes();
+
+void put_uint32_be(uint8_t* const p, const uint32_t v) {
+	p[0] = (v >> 24) & 0xff;
+	p[1] = (v >> 16) & 0xff;
+	p[2] = (v >>  8) & 0xff;
+	p[3] = (v >>  0) & 0xff;
+}
+
+} /* namespace */
+
 Optional<File::Error> PNGWriter::create(
 	const std::filesystem::path& filename
 ) {
@@ -59,74 +139,137 @@ Optional<File::Error> PNGWriter::create(
 
 	file.write(png_file_header);
 	file.write(png_ihdr_screen_capture);
-	
-	write_chunk_header(
-		2 + height * (5 + 1 + width * 3) + 4,
-		png_idat_chunk_type
-	);
 
-	constexpr std::array<uint8_t, 2> zlib_header { 0x78, 0x01 };	// Zlib CM, CINFO, FLG.
-	write_chunk_content(zlib_header);
+	write_byte(0x78);	// Zlib CM=8, CINFO=7 (32K window)
+	write_byte(0x5e);	// Zlib FLEVEL=1 (fast), FCHECK
+	write_bits(0b011, 3);	// DEFLATE BFINAL=1, BTYPE=01 (fixed Huffman)
 
 	return { };
 }
 
 PNGWriter::~PNGWriter() {
-	write_chunk_content(adler_32.bytes());
-	write_chunk_crc();
+	write_literal(256);		// End of block
+	flush_bits();
+
+	for(const auto byte : adler_32.bytes()) {
+		write_byte(byte);
+	}
+	flush_idat();
 
 	file.write(png_iend);
 }
 
 void PNGWriter::write_scanline(const std::array<ui::ColorRGB888, 240>& scanline) {
 	constexpr uint8_t scanline_filter_type = 0;
-	constexpr uint32_t deflate_block_length = 1 + sizeof(scanline);
-
-	const std::array<uint8_t, 6> deflate_and_scanline_header {
-		static_cast<uint8_t>((scanline_count == (height - 1)) ? 0x01 : 0x00),	// DEFLATE header bits, bfinal=0, btype=00
-		static_cast<uint8_t>((deflate_block_length >> 0) & 0xff),			// Length LSB
-		static_cast<uint8_t>((deflate_block_length >> 8) & 0xff),			// Length MSB
-		static_cast<uint8_t>((deflate_block_length >> 0) & 0xff) ^ 0xff,	// ~Length LSB
-		static_cast<uint8_t>((deflate_block_length >> 8) & 0xff) ^ 0xff,	// ~Length MSB
-		scanline_filter_type,
-	};
-	write_chunk_content(deflate_and_scanline_header);
-
-	adler_32.feed(scanline_filter_type);
-	adler_32.feed(scanline);
-
-	// Small writes to avoid some sort of large-transfer plus block
-	// boundary FatFs or SDC driver bug?
-	write_chunk_content(&scanline[  0], 80 * sizeof(ui::ColorRGB888));
-	write_chunk_content(&scanline[ 80], 80 * sizeof(ui::ColorRGB888));
-	write_chunk_content(&scanline[160], 80 * sizeof(ui::ColorRGB888));
 
+	uint8_t* const current = &rows[row_length];
+	current[0] = scanline_filter_type;
+	std::memcpy(&current[1], scanline.data(), sizeof(scanline));
+	adler_32.feed(current, row_length);
+
+	compress_row();
+
+	std::memcpy(&rows[0], current, row_length);
 	scanline_count++;
 }
 
-void PNGWriter::write_chunk_header(
-	const size_t length,
-	const std::array<uint8_t, 4>& type
-) {
-	write_uint32_be(length);
-	crc.reset();
-	write_chunk_content(type);
+void PNGWriter::compress_row() {
+	/* Previous byte (runs within a color channel), previous pixel (runs of
+	 * a color) and the pixel above (repeated rows).
+	 */
+	constexpr std::array<size_t, 3> distances { { 1, sizeof(ui::ColorRGB888), row_length } };
+	constexpr size_t match_length_min = 3;
+	constexpr size_t match_length_max = 258;
+
+	const uint8_t* const data = rows.data();
+	const size_t history_start = (scanline_count > 0) ? 0 : row_length;
+	const size_t end = row_length * 2;
+
+	size_t p = row_length;
+	while( p < end ) {
+		const size_t length_limit = std::min(end - p, match_length_max);
+		size_t best_length = 0;
+		size_t best_distance = 0;
+
+		for(const auto distance : distances) {
+			if( (p - distance) < history_start ) {
+				continue;
+			}
+			size_t length = 0;
+			while( (length < length_limit) && (data[p - distance + length] == data[p + length]) ) {
+				length++;
+			}
+			if( length > best_length ) {
+				best_length = length;
+				best_distance = distance;
+			}
+		}
+
+		if( best_length >= match_length_min ) {
+			write_match(best_length, best_distance);
+			p += best_length;
+		} else {
+			write_literal(data[p]);
+			p++;
+		}
+	}
+}
+
+void PNGWriter::write_literal(const uint32_t symbol) {
+	write_bits(fixed_literal_codes[symbol], fixed_literal_code_length(symbol));
 }
 
-void PNGWriter::write_chunk_content(const void* const p, const size_t count) {
-	file.write(p, count);
-	crc.process_bytes(p, count);
+void PNGWriter::write_match(const size_t length, const size_t distance) {
+	const size_t length_code = length_codes[length - 3];
+	write_literal(257 + length_code);
+	write_bits(length - length_base[length_code], length_extra_bits[length_code]);
+
+	size_t distance_code = distance_base.size() - 1;
+	while( distance_base[distance_code] > distance ) {
+		distance_code--;
+	}
+	write_bits(reverse_bits(distance_code, 5), 5);
+	write_bits(distance - distance_base[distance_code], distance_extra_bits[distance_code]);
 }
 
-void PNGWriter::write_chunk_crc() {
-	write_uint32_be(crc.checksum());
+void PNGWriter::write_bits(const uint32_t bits, const size_t count) {
+	bit_buffer |= bits << bit_count;
+	bit_count += count;
+	while( bit_count >= 8 ) {
+		write_byte(bit_buffer & 0xff);
+		bit_buffer >>= 8;
+		bit_count -= 8;
+	}
 }
 
-void PNGWriter::write_uint32_be(const uint32_t v) {
-	file.write(std::array<uint8_t, 4> { {
-		static_cast<uint8_t>((v >> 24) & 0xff),
-		static_cast<uint8_t>((v >> 16) & 0xff),
-		static_cast<uint8_t>((v >>  8) & 0xff),
-		static_cast<uint8_t>((v >>  0) & 0xff),
-	} });
+void PNGWriter::flush_bits() {
+	if( bit_count > 0 ) {
+		write_byte(bit_buffer & 0xff);
+	}
+	bit_buffer = 0;
+	bit_count = 0;
+}
+
+void PNGWriter::write_byte(const uint8_t byte) {
+	idat[8 + idat_length++] = byte;
+	if( idat_length == idat_data_max ) {
+		flush_idat();
+	}
+}
+
+void PNGWriter::flush_idat() {
+	if( idat_length == 0 ) {
+		return;
+	}
+
+	/* Length, type, data and CRC go out as a single write. */
+	put_uint32_be(&idat[0], idat_length);
+	std::copy(png_idat_chunk_type.begin(), png_idat_chunk_type.end(), &idat[4]);
+
+	CRC32 crc;
+	crc.process_bytes(&idat[4], png_idat_chunk_type.size() + idat_length);
+	put_uint32_be(&idat[8 + idat_length], crc.checksum());
+
+	file.write(idat.data(), 8 + idat_length + 4);
+	idat_length = 0;
 }
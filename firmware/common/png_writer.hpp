@@ -26,11 +26,18 @@
 #include <cstddef>
 #include <string>
 #include <array>
+#include <vector>
 
 #include "ui.hpp"
 #include "file.hpp"
 #include "crc.hpp"
 
+/* Writes 240x320 RGB screen captures as a single fixed-Huffman DEFLATE
+ * stream. Scanlines are stored unfiltered and matched against the previous
+ * byte, the previous pixel and the pixel above, which is what flat UI
+ * graphics compress well with. Output is collected into IDAT chunks of up
+ * to idat_data_max bytes, each written to the file in one go.
+ */
 class PNGWriter {
 public:
 	~PNGWriter();
@@ -44,21 +51,33 @@ private:
 	static constexpr int width { 240 };
 	static constexpr int height { 320 };
 
+	static constexpr size_t row_length { 1 + width * sizeof(ui::ColorRGB888) };
+	static constexpr size_t idat_data_max { 4096 };
+
 	File file { };
 	int scanline_count { 0 };
-	CRC<32, true, true> crc { 0x04c11db7, 0xffffffff, 0xffffffff };
 	Adler32 adler_32 { };
 
-	void write_chunk_header(const size_t length, const std::array<uint8_t, 4>& type);
-	void write_chunk_content(const void* const p, const size_t count);
+	/* Previous and current scanline as they appear in the zlib stream
+	 * (filter type byte first), back to back so the previous row is the
+	 * match history for the current one. Heap-allocated, along with the
+	 * IDAT buffer, to keep this object small on the caller's stack.
+	 */
+	std::vector<uint8_t> rows = std::vector<uint8_t>(row_length * 2);
+	std::vector<uint8_t> idat = std::vector<uint8_t>(8 + idat_data_max + 4);
+	size_t idat_length { 0 };
+
+	uint32_t bit_buffer { 0 };
+	size_t bit_count { 0 };
 
-	template<size_t N>
-	void write_chunk_content(const std::array<uint8_t, N>& data) {
-		write_chunk_content(data.data(), sizeof(data));
-	}
+	void compress_row();
 
-	void write_chunk_crc();
-	void write_uint32_be(const uint32_t v);
+	void write_literal(const uint32_t symbol);
+	void write_match(const size_t length, const size_t distance);
+	void write_bits(const uint32_t bits, const size_t count);
+	void write_byte(const uint8_t byte);
+	void flush_bits();
+	void flush_idat();
 };
 
 #endif/*__PNG_WRITER_H__*/
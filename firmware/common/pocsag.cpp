@@ -40,6 +40,15 @@ std::string bitrate_str(BitRate bitrate) {
 	}
 }
 
+// Position in pocsag_bitrates, and in POCSAGStatistics
+size_t bitrate_index(BitRate bitrate) {
+	switch (bitrate) {
+		case BitRate::FSK512:	return 0;
+		case BitRate::FSK2400:	return 2;
+		default:				return 1;
+	}
+}
+
 std::string flag_str(PacketFlag packetflag) {
 	switch (packetflag) {
 		case PacketFlag::NORMAL:	return "OK";
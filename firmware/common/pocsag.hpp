@@ -72,6 +72,7 @@ const pocsag::BitRate pocsag_bitrates[3] = {
 };
 
 std::string bitrate_str(BitRate bitrate);
+size_t bitrate_index(BitRate bitrate);
 std::string flag_str(PacketFlag packetflag);
 
 void insert_BCH(BCHCode& BCH_code, uint32_t * codeword);
@@ -43,6 +43,13 @@ enum PacketFlag : uint32_t {
 	TOO_LONG
 };
 
+// Codewords with bit errors since the processor started, per bit rate
+// (512, 1200 and 2400bps)
+struct POCSAGStatistics {
+	uint32_t corrected[3] { 0, 0, 0 };
+	uint32_t uncorrectable[3] { 0, 0, 0 };
+};
+
 class POCSAGPacket {
 public:
 	void set_timestamp(const Timestamp& value) {
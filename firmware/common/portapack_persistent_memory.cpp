@@ -91,6 +91,8 @@ struct data_t {
 	uint32_t pocsag_ignore_address;
 	
 	int32_t tone_mix;
+	
+	uint32_t spectrum_config;
 };
 
 static_assert(sizeof(data_t) <= backup_ram.size(), "Persistent memory structure too large for VBAT-maintained region");
@@ -312,5 +314,50 @@ void set_pocsag_ignore_address(uint32_t address) {
 	data->pocsag_ignore_address = address;
 }
 
+/* Window, trace, overlap, averages and the waterfall leveling flag, packed
+ * with a magic byte so uninitialized backup RAM reads as the defaults.
+ */
+static constexpr uint32_t spectrum_config_magic = 0x5c000000;
+static constexpr uint32_t spectrum_config_level_to_floor = 1 << 16;
+
+static uint32_t spectrum_config_value() {
+	const auto v = data->spectrum_config;
+	if( ((v & 0xff000000) != spectrum_config_magic) ||
+		((v & 3) > 2) || (((v >> 2) & 3) > 2) || (((v >> 8) & 31) == 0) ) {
+		const SpectrumConfig defaults { };
+		data->spectrum_config = spectrum_config_magic;
+		set_spectrum_config(defaults);
+	}
+	return data->spectrum_config;
+}
+
+SpectrumConfig spectrum_config() {
+	const auto v = spectrum_config_value();
+	SpectrumConfig config;
+	config.window = static_cast<SpectrumConfig::Window>(v & 3);
+	config.trace = static_cast<SpectrumConfig::Trace>((v >> 2) & 3);
+	config.overlap = (v >> 4) & 1;
+	config.averages = (v >> 8) & 31;
+	return config;
+}
+
+void set_spectrum_config(const SpectrumConfig& new_value) {
+	const uint32_t averages = std::min<uint32_t>(std::max<uint32_t>(new_value.averages, 1), 31);
+	data->spectrum_config = spectrum_config_magic |
+		(data->spectrum_config & spectrum_config_level_to_floor) |
+		(toUType(new_value.window) & 3) |
+		((toUType(new_value.trace) & 3) << 2) |
+		((new_value.overlap ? 1 : 0) << 4) |
+		(averages << 8);
+}
+
+bool spectrum_level_to_floor() {
+	return (spectrum_config_value() & spectrum_config_level_to_floor) ? true : false;
+}
+
+void set_spectrum_level_to_floor(const bool v) {
+	data->spectrum_config = (spectrum_config_value() & ~spectrum_config_level_to_floor) | (v ? spectrum_config_level_to_floor : 0);
+}
+
 } /* namespace persistent_memory */
 } /* namespace portapack */
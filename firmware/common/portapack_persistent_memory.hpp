@@ -29,6 +29,7 @@
 #include "touch.hpp"
 #include "modems.hpp"
 #include "serializer.hpp"
+#include "message.hpp"
 
 using namespace modems;
 using namespace serializer;
@@ -103,6 +104,12 @@ void set_pocsag_last_address(uint32_t address);
 uint32_t pocsag_ignore_address();
 void set_pocsag_ignore_address(uint32_t address);
 
+SpectrumConfig spectrum_config();
+void set_spectrum_config(const SpectrumConfig& new_value);
+
+bool spectrum_level_to_floor();								// Waterfall colors follow the noise floor
+void set_spectrum_level_to_floor(const bool v);
+
 } /* namespace persistent_memory */
 } /* namespace portapack */
 
@@ -23,10 +23,13 @@
 #define __SIMD_H__
 
 #if defined(LPC43XX_M4)
-
 #include <hal.h>
+#else
+#include "simd_host.hpp"
+#endif
 
 #include <cstdint>
+#include <cstddef>
 
 struct vec4_s8 {
 	union {
@@ -109,6 +112,4 @@ static inline int32_t smlad(const vec2_s16 v1, const vec2_s16 v2, const int32_t
 	return __SMLAD(v1.w, v2.w, accum);
 }
 
-#endif /* defined(LPC43XX_M4) */
-
 #endif/*__SIMD_H__*/
@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SIMD_HOST_H__
+#define __SIMD_HOST_H__
+
+/* Portable C++ equivalents of the Cortex-M4 DSP intrinsics (CMSIS
+ * core_cm4_simd.h plus the overloads in lpc43xx_m4.h) used by the baseband
+ * DSP code. Only included when not building for LPC43XX_M4, so that
+ * dsp_decimate.cpp and friends can be compiled and checked for bit-exact
+ * output on a development host.
+ *
+ * Each function mirrors the ARM ARM pseudocode for the instruction of the
+ * same name, including the wrap-around (non-saturating) behavior of the
+ * dual-multiply-accumulate instructions.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#define __SIMD32_TYPE int32_t
+#define __SIMD32(addr)  (simd_host::simd32_pointer((addr)))
+#define _SIMD32_OFFSET(addr) (simd_host::Word32 { (addr) })
+
+namespace simd_host {
+
+/* CMSIS defines __SIMD32() as a cast of the pointer to an int32_t pointer,
+ * which violates strict aliasing when the buffer holds complex16_t or
+ * int16_t. On the host, reads and writes go through memcpy instead, while
+ * keeping the `*__SIMD32(p)++` syntax used by the DSP code. The word is
+ * loaded when the proxy is created, so `const auto x = *__SIMD32(p)++;`
+ * holds the value, not a reference to the buffer.
+ */
+class Word32 {
+public:
+	explicit Word32(
+		const void* const address
+	) : address { const_cast<void*>(address) }
+	{
+		std::memcpy(&value, address, sizeof(value));
+	}
+
+	Word32(const Word32&) = default;
+
+	operator uint32_t() const {
+		return static_cast<uint32_t>(value);
+	}
+
+	Word32& operator=(const int32_t new_value) {
+		value = new_value;
+		std::memcpy(address, &value, sizeof(value));
+		return *this;
+	}
+
+	Word32& operator=(const Word32& other) {
+		return *this = other.value;
+	}
+
+private:
+	void* address;
+	int32_t value { 0 };
+};
+
+/* What `__SIMD32(p)++` yields: the address before the increment. */
+struct Address32 {
+	const void* address;
+
+	Word32 operator*() const {
+		return Word32 { address };
+	}
+};
+
+template<typename T>
+class Pointer32 {
+public:
+	explicit constexpr Pointer32(
+		T*& p
+	) : p { p }
+	{
+	}
+
+	Word32 operator*() const {
+		return Word32 { p };
+	}
+
+	Address32 operator++(int) {
+		const Address32 prior { p };
+		p = reinterpret_cast<T*>(reinterpret_cast<uintptr_t>(p) + sizeof(int32_t));
+		return prior;
+	}
+
+private:
+	T*& p;
+};
+
+template<typename T>
+static inline Pointer32<T> simd32_pointer(T*& p) {
+	return Pointer32<T> { p };
+}
+
+static inline uint32_t ror(const uint32_t v, const uint32_t n) {
+	return (n & 31) ? ((v >> (n & 31)) | (v << (32 - (n & 31)))) : v;
+}
+
+static inline int32_t lo(const uint32_t v) {
+	return static_cast<int16_t>(v & 0xffff);
+}
+
+static inline int32_t hi(const uint32_t v) {
+	return static_cast<int16_t>(v >> 16);
+}
+
+static inline int32_t saturate(const int64_t v, const uint32_t bits) {
+	const int64_t max = (int64_t(1) << (bits - 1)) - 1;
+	const int64_t min = -(int64_t(1) << (bits - 1));
+	return (v > max) ? max : ((v < min) ? min : v);
+}
+
+static inline uint32_t pack(const int32_t lo, const int32_t hi) {
+	return (static_cast<uint32_t>(lo) & 0xffff) | (static_cast<uint32_t>(hi) << 16);
+}
+
+} /* namespace simd_host */
+
+static inline void __SEV() { }
+static inline void __DMB() { }
+
+static inline uint32_t __REV16(const uint32_t value) {
+	return ((value & 0xff00ff00) >> 8) | ((value & 0x00ff00ff) << 8);
+}
+
+static inline uint32_t __RBIT(uint32_t value) {
+	uint32_t result = 0;
+	for(size_t i=0; i<32; i++) {
+		result = (result << 1) | (value & 1);
+		value >>= 1;
+	}
+	return result;
+}
+
+static inline int32_t __SSAT(const int32_t value, const uint32_t bits) {
+	return simd_host::saturate(value, bits);
+}
+
+static inline int32_t __QADD(const int32_t op1, const int32_t op2) {
+	return simd_host::saturate(int64_t(op1) + op2, 32);
+}
+
+static inline int32_t __QSUB(const int32_t op1, const int32_t op2) {
+	return simd_host::saturate(int64_t(op1) - op2, 32);
+}
+
+static inline uint32_t __QADD16(const uint32_t op1, const uint32_t op2) {
+	using namespace simd_host;
+	return pack(saturate(lo(op1) + lo(op2), 16), saturate(hi(op1) + hi(op2), 16));
+}
+
+static inline uint32_t __QSUB16(const uint32_t op1, const uint32_t op2) {
+	using namespace simd_host;
+	return pack(saturate(lo(op1) - lo(op2), 16), saturate(hi(op1) - hi(op2), 16));
+}
+
+static inline uint32_t __PKHBT(const uint32_t op1, const uint32_t op2, const uint32_t sh) {
+	return (op1 & 0x0000ffff) | ((op2 << sh) & 0xffff0000);
+}
+
+static inline uint32_t __PKHTB(const uint32_t op1, const uint32_t op2, const uint32_t sh) {
+	/* Arithmetic shift; a shift of 0 is encoded as ASR #32 in hardware, but
+	 * CMSIS (and this code base) treats 0 as "no shift".
+	 */
+	return (op1 & 0xffff0000) | ((static_cast<uint32_t>(static_cast<int32_t>(op2) >> sh)) & 0x0000ffff);
+}
+
+static inline int32_t __SXTB16(const uint32_t rm, const uint32_t ror = 0) {
+	const uint32_t v = simd_host::ror(rm, ror);
+	return simd_host::pack(static_cast<int8_t>(v & 0xff), static_cast<int8_t>((v >> 16) & 0xff));
+}
+
+static inline int32_t __SXTH(const uint32_t rm, const uint32_t ror) {
+	return simd_host::lo(simd_host::ror(rm, ror));
+}
+
+static inline int32_t __SXTAH(const uint32_t rn, const uint32_t rm, const uint32_t ror) {
+	return rn + simd_host::lo(simd_host::ror(rm, ror));
+}
+
+static inline uint32_t __BFI(const uint32_t rd, const uint32_t rn, const uint32_t lsb, const uint32_t width) {
+	const uint32_t mask = ((width >= 32) ? 0xffffffff : ((1U << width) - 1)) << lsb;
+	return (rd & ~mask) | ((rn << lsb) & mask);
+}
+
+static inline int32_t __SMULBB(const uint32_t op1, const uint32_t op2) {
+	return simd_host::lo(op1) * simd_host::lo(op2);
+}
+
+static inline int32_t __SMULBT(const uint32_t op1, const uint32_t op2) {
+	return simd_host::lo(op1) * simd_host::hi(op2);
+}
+
+static inline int32_t __SMULTB(const uint32_t op1, const uint32_t op2) {
+	return simd_host::hi(op1) * simd_host::lo(op2);
+}
+
+static inline int32_t __SMULTT(const uint32_t op1, const uint32_t op2) {
+	return simd_host::hi(op1) * simd_host::hi(op2);
+}
+
+static inline int32_t __SMLABB(const uint32_t rm, const uint32_t rs, const uint32_t rn) {
+	return static_cast<uint32_t>(__SMULBB(rm, rs)) + rn;
+}
+
+static inline int32_t __SMLATB(const uint32_t rm, const uint32_t rs, const uint32_t rn) {
+	return static_cast<uint32_t>(__SMULTB(rm, rs)) + rn;
+}
+
+static inline int32_t __SMMULR(const int32_t op1, const int32_t op2) {
+	return static_cast<int32_t>((int64_t(op1) * op2 + 0x80000000LL) >> 32);
+}
+
+/* Dual 16-bit multiplies. Products are summed in 32 bits with wrap-around,
+ * as the hardware does (it only sets the Q flag on overflow).
+ */
+
+static inline uint32_t __SMUAD(const uint32_t op1, const uint32_t op2) {
+	using namespace simd_host;
+	return static_cast<uint32_t>(lo(op1) * lo(op2)) + static_cast<uint32_t>(hi(op1) * hi(op2));
+}
+
+static inline uint32_t __SMUADX(const uint32_t op1, const uint32_t op2) {
+	using namespace simd_host;
+	return static_cast<uint32_t>(lo(op1) * hi(op2)) + static_cast<uint32_t>(hi(op1) * lo(op2));
+}
+
+static inline uint32_t __SMUSD(const uint32_t op1, const uint32_t op2) {
+	using namespace simd_host;
+	return static_cast<uint32_t>(lo(op1) * lo(op2)) - static_cast<uint32_t>(hi(op1) * hi(op2));
+}
+
+static inline uint32_t __SMUSDX(const uint32_t op1, const uint32_t op2) {
+	using namespace simd_host;
+	return static_cast<uint32_t>(lo(op1) * hi(op2)) - static_cast<uint32_t>(hi(op1) * lo(op2));
+}
+
+static inline uint32_t __SMLAD(const uint32_t op1, const uint32_t op2, const uint32_t op3) {
+	return __SMUAD(op1, op2) + op3;
+}
+
+static inline uint32_t __SMLADX(const uint32_t op1, const uint32_t op2, const uint32_t op3) {
+	return __SMUADX(op1, op2) + op3;
+}
+
+static inline uint32_t __SMLSD(const uint32_t op1, const uint32_t op2, const uint32_t op3) {
+	return __SMUSD(op1, op2) + op3;
+}
+
+static inline uint32_t __SMLSDX(const uint32_t op1, const uint32_t op2, const uint32_t op3) {
+	return __SMUSDX(op1, op2) + op3;
+}
+
+static inline int64_t __SMLALD(const uint32_t op1, const uint32_t op2, const int64_t acc) {
+	using namespace simd_host;
+	return acc + int64_t(lo(op1) * lo(op2)) + int64_t(hi(op1) * hi(op2));
+}
+
+static inline int64_t __SMLALDX(const uint32_t op1, const uint32_t op2, const int64_t acc) {
+	using namespace simd_host;
+	return acc + int64_t(lo(op1) * hi(op2)) + int64_t(hi(op1) * lo(op2));
+}
+
+static inline int64_t __SMLSLD(const uint32_t op1, const uint32_t op2, const int64_t acc) {
+	using namespace simd_host;
+	return acc + int64_t(lo(op1) * lo(op2)) - int64_t(hi(op1) * hi(op2));
+}
+
+static inline int64_t __SMLSLDX(const uint32_t op1, const uint32_t op2, const int64_t acc) {
+	using namespace simd_host;
+	return acc + int64_t(lo(op1) * hi(op2)) - int64_t(hi(op1) * lo(op2));
+}
+
+#endif/*__SIMD_HOST_H__*/
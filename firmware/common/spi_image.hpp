@@ -101,13 +101,31 @@ constexpr image_tag_t image_tag_noop				{ 'P', 'N', 'O', 'P' };
 
 constexpr image_tag_t image_tag_hackrf				{ 'H', 'R', 'F', '1' };
 
+/* A chunk whose length has compressed_flag set holds a compressed_header_t
+ * followed by an LZ4 block, zero-padded to a multiple of four bytes.
+ */
 struct chunk_t {
+	static constexpr uint32_t compressed_flag = 0x80000000;
+
+	struct compressed_header_t {
+		uint32_t original_length;
+		uint32_t compressed_length;
+	};
+
 	const image_tag_t tag;
 	const uint32_t length;
 	const uint8_t data[];
 
+	bool compressed() const {
+		return (length & compressed_flag) != 0;
+	}
+
+	size_t stored_length() const {
+		return length & ~compressed_flag;
+	}
+
 	const chunk_t* next() const {
-		return reinterpret_cast<const chunk_t*>(&data[length]);
+		return reinterpret_cast<const chunk_t*>(&data[stored_length()]);
 	}
 };
 
@@ -36,6 +36,71 @@ Style Style::invert() const {
 	};
 }
 
+static uint32_t area(const Rect& r) {
+	return r.width() * r.height();
+}
+
+void DamageRegion::add(Rect r) {
+	if( r.is_empty() ) {
+		return;
+	}
+
+	while( true ) {
+		size_t merge = count_;
+		for(size_t i=0; i<count_; i++) {
+			auto u = rects_[i];
+			u += r;
+			if( area(u) <= area(rects_[i]) + area(r) ) {
+				merge = i;
+				break;
+			}
+		}
+
+		if( merge == count_ ) {
+			if( count_ < rects_.size() ) {
+				rects_[count_++] = r;
+				return;
+			}
+
+			uint32_t best_growth = UINT32_MAX;
+			for(size_t i=0; i<count_; i++) {
+				auto u = rects_[i];
+				u += r;
+				const auto growth = area(u) - area(rects_[i]);
+				if( growth < best_growth ) {
+					best_growth = growth;
+					merge = i;
+				}
+			}
+		}
+
+		// The merged rectangle may now swallow others, so add it again.
+		r += rects_[merge];
+		rects_[merge] = rects_[--count_];
+	}
+}
+
+bool DamageRegion::intersects(const Rect& r) const {
+	for(const auto& d : *this) {
+		if( !d.intersect(r).is_empty() ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void DamageRegion::remove_within(const Rect& r) {
+	for(size_t i=0; i<count_; ) {
+		const auto& d = rects_[i];
+		if( (d.left() >= r.left()) && (d.right() <= r.right()) &&
+		    (d.top() >= r.top()) && (d.bottom() <= r.bottom()) ) {
+			rects_[i] = rects_[--count_];
+		} else {
+			i++;
+		}
+	}
+}
+
 int Painter::draw_char(const Point p, const Style& style, const char c) {
 	const auto glyph = style.font.glyph(c);
 	display.draw_glyph(p, glyph, style.foreground, style.background);
@@ -45,28 +110,27 @@ int Painter::draw_char(const Point p, const Style& style, const char c) {
 int Painter::draw_string(Point p, const Font& font, const Color foreground,
 	const Color background, const std::string text) {
 	
-	bool escape = false;
 	size_t width = 0;
 	Color pen = foreground;
 	
-	for(const auto c : text) {
-		if (escape) {
+	// Runs of characters between color escapes are drawn in one go
+	size_t run_start = 0;
+	for(size_t i = 0; i <= text.size(); i++) {
+		if ((i < text.size()) && (text[i] != '\x1B'))
+			continue;
+		
+		const auto run_width = display.draw_glyph_run(p, font, &text[run_start], i - run_start, pen, background);
+		p += { run_width, 0 };
+		width += run_width;
+		
+		if (i + 1 < text.size()) {
+			const auto c = text[++i];
 			if (c <= 15)
 				pen = term_colors[c & 15];
 			else
 				pen = foreground;
-			escape = false;
-		} else {
-			if (c == '\x1B') {
-				escape = true;
-			} else {
-				const auto glyph = font.glyph(c);
-				display.draw_glyph(p, glyph, pen, background);
-				const auto advance = glyph.advance();
-				p += advance;
-				width += advance.x();
-			}
 		}
+		run_start = i + 1;
 	}
 	return width;
 }
@@ -80,11 +144,11 @@ void Painter::draw_bitmap(const Point p, const Bitmap& bitmap, const Color foreg
 }
 
 void Painter::draw_hline(Point p, int width, const Color c) {
-	display.fill_rectangle({ p, { width, 1 } }, c);
+	fill_rectangle({ p, { width, 1 } }, c);
 }
 
 void Painter::draw_vline(Point p, int height, const Color c) {
-	display.fill_rectangle({ p, { 1, height } }, c);
+	fill_rectangle({ p, { 1, height } }, c);
 }
 
 void Painter::draw_rectangle(const Rect r, const Color c) {
@@ -95,17 +159,58 @@ void Painter::draw_rectangle(const Rect r, const Color c) {
 }
 
 void Painter::fill_rectangle(const Rect r, const Color c) {
-	display.fill_rectangle(r, c);
+	if( clip ) {
+		for(const auto& d : *clip) {
+			const auto r_clipped = r.intersect(d);
+			if( !r_clipped.is_empty() ) {
+				display.fill_rectangle(r_clipped, c);
+			}
+		}
+	} else {
+		display.fill_rectangle(r, c);
+	}
 }
 
 void Painter::fill_rectangle_unrolled8(const Rect r, const Color c) {
-	display.fill_rectangle_unrolled8(r, c);
+	if( clip ) {
+		for(const auto& d : *clip) {
+			const auto r_clipped = r.intersect(d);
+			if( !r_clipped.is_empty() ) {
+				display.fill_rectangle_unrolled8(r_clipped, c);
+			}
+		}
+	} else {
+		display.fill_rectangle_unrolled8(r, c);
+	}
 }
 
 void Painter::paint_widget_tree(Widget* const w) {
 	if( ui::is_dirty() ) {
+		const auto pixels_start = display.pixels_written();
+
+		damage = ui::take_exposed();
+		cull_covered(w);
 		paint_widget(w);
+		damage.clear();
 		ui::dirty_clear();
+
+		frame_pixels_ = display.pixels_written() - pixels_start;
+	}
+}
+
+void Painter::cull_covered(Widget* const w) {
+	// Areas uncovered by hidden or removed widgets need no repaint from
+	// underneath if a dirty widget is about to paint over them anyway.
+	if( damage.empty() || w->hidden() ) {
+		return;
+	}
+
+	if( w->dirty() ) {
+		damage.remove_within(w->screen_rect());
+	} else {
+		for(const auto child : w->children()) {
+			cull_covered(child);
+		}
 	}
 }
 
@@ -117,19 +222,29 @@ void Painter::paint_widget(Widget* const w) {
 		// Mark this widget as visible and recurse.
 		w->visible(true);
 
+		const auto r = w->screen_rect();
 		if( w->dirty() ) {
+			display.reset_write_extent();
 			w->paint(*this);
-			// Force-paint all children.
-			for(const auto child : w->children()) {
-				child->set_dirty();
-				paint_widget(child);
-			}
 			w->set_clean();
-		} else {
-			// Selectively paint all children.
-			for(const auto child : w->children()) {
-				paint_widget(child);
-			}
+
+			// Everything painted later that overlaps this widget sits on
+			// top of it, children included, and has to be redrawn.
+			damage.add(r);
+			damage.add(display.write_extent());
+		} else if( damage.intersects(r) ) {
+			// Something underneath was repainted. Fills are clipped to the
+			// damaged area; whatever else gets drawn extends the damage.
+			display.reset_write_extent();
+			clip = &damage;
+			w->paint(*this);
+			clip = nullptr;
+
+			damage.add(display.write_extent());
+		}
+
+		for(const auto child : w->children()) {
+			paint_widget(child);
 		}
 	}
 }
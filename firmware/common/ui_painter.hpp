@@ -25,6 +25,7 @@
 #include "ui.hpp"
 #include "ui_text.hpp"
 
+#include <array>
 #include <string>
 
 namespace ui {
@@ -39,12 +40,34 @@ struct Style {
 
 class Widget;
 
+/* Screen areas to repaint in the current frame. Rectangles are merged as they
+ * are added whenever the merge covers no more pixels than the two apart; once
+ * all slots are used, a new rectangle joins the one it grows least.
+ */
+class DamageRegion {
+public:
+	void add(Rect r);
+	void clear() { count_ = 0; }
+	bool empty() const { return count_ == 0; }
+	bool intersects(const Rect& r) const;
+	/* Drops rectangles lying entirely inside r. */
+	void remove_within(const Rect& r);
+
+	const Rect* begin() const { return rects_.begin(); }
+	const Rect* end() const { return rects_.begin() + count_; }
+
+private:
+	std::array<Rect, 8> rects_ { };
+	size_t count_ { 0 };
+};
+
 class Painter {
 public:
 	Painter() { };
 
 	Painter(const Painter&) = delete;
 	Painter(Painter&&) = delete;
+	Painter& operator=(const Painter&) = delete;
 
 	int draw_char(const Point p, const Style& style, const char c);
 
@@ -59,11 +82,19 @@ public:
 	void fill_rectangle_unrolled8(const Rect r, const Color c);
 
 	void paint_widget_tree(Widget* const w);
-	
+
+	/* Pixels sent to the display by the last paint_widget_tree() pass. */
+	uint32_t frame_pixels() const { return frame_pixels_; }
+
 	void draw_hline(Point p, int width, const Color c);
 	void draw_vline(Point p, int height, const Color c);
 	
 private:
+	DamageRegion damage { };
+	const DamageRegion* clip { nullptr };
+	uint32_t frame_pixels_ { 0 };
+
+	void cull_covered(Widget* const w);
 	void paint_widget(Widget* const w);
 };
 
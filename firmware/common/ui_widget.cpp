@@ -35,6 +35,7 @@ using namespace portapack;
 namespace ui {
 
 static bool ui_dirty = true;
+static DamageRegion ui_exposed { };
 
 void dirty_set() {
 	ui_dirty = true;
@@ -48,6 +49,17 @@ bool is_dirty() {
 	return ui_dirty;
 }
 
+void expose(const Rect& r) {
+	ui_exposed.add(r);
+	dirty_set();
+}
+
+DamageRegion take_exposed() {
+	const auto result = ui_exposed;
+	ui_exposed.clear();
+	return result;
+}
+
 /* Widget ****************************************************************/
 
 const std::vector<Widget*> Widget::no_children { };
@@ -69,6 +81,9 @@ Rect Widget::parent_rect() const {
 }
 
 void Widget::set_parent_rect(const Rect new_parent_rect) {
+	if( parent_ && flags.visible ) {
+		expose(screen_rect());
+	}
 	_parent_rect = new_parent_rect;
 	set_dirty();
 }
@@ -84,6 +99,9 @@ void Widget::set_parent(Widget* const widget) {
 
 	if( parent_ && !widget ) {
 		// We have a parent, but are losing it. Update visible status.
+		if( flags.visible ) {
+			expose(screen_rect());
+		}
 		dirty_overlapping_children_in_rect(screen_rect());
 		visible(false);
 	}
@@ -112,11 +130,11 @@ void Widget::hidden(bool hide) {
 
 		// If parent is hidden, either of these is a no-op.
 		if( hide ) {
-			// TODO: Instead of dirtying parent entirely, dirty only children
-			// that overlap with this widget.
-			
-			//parent()->dirty_overlapping_children_in_rect(parent_rect());
-			
+			// Whatever lies beneath repaints just the area this widget used.
+			if( parent_ && flags.visible ) {
+				expose(screen_rect());
+			}
+
 			/* TODO: Notify self and all non-hidden children that they're
 			 * now effectively hidden?
 			 */
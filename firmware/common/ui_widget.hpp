@@ -45,6 +45,12 @@ void dirty_set();
 void dirty_clear();
 bool is_dirty();
 
+/* Screen area left uncovered by a widget that was hidden, moved or removed,
+ * to be repainted by whatever lies beneath it on the next frame.
+ */
+void expose(const Rect& r);
+DamageRegion take_exposed();
+
 class Context {
 public:
 	FocusManager& focus_manager() {
@@ -22,9 +22,13 @@
 #ifndef __UTILITY_M4_H__
 #define __UTILITY_M4_H__
 
-#if defined(LPC43XX_M4)
+#if !defined(LPC43XX_M0)
 
+#if defined(LPC43XX_M4)
 #include <hal.h>
+#else
+#include "simd_host.hpp"
+#endif
 
 static inline complex32_t multiply_conjugate_s16_s32(const complex16_t::rep_type a, const complex16_t::rep_type b) {
 	// conjugate: conj(a + bj) = a - bj
@@ -42,6 +46,6 @@ static inline complex32_t multiply_conjugate_s16_s32(const complex16_t::rep_type
 	const int32_t i = __QSUB(ir, ri);
 	return { r, i };
 }
-#endif /* defined(LPC43XX_M4) */
+#endif /* !defined(LPC43XX_M0) */
 
 #endif/*__UTILITY_M4_H__*/
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Checks the table-driven Mode S CRC and the syndrome-table error repair
+ * against a bit-at-a-time reference, then times them.
+ *
+ * Every single bit error outside the DF field (107 of them) and every pair
+ * of such errors (5671) is injected into a valid DF17 frame; each must be
+ * repaired back to the original. Errors in the DF field must be left alone.
+ *
+ * Usage: adsb_crc_test [iterations]
+ */
+
+#include "adsb_crc.hpp"
+
+#include "host_test.hpp"
+
+#include <array>
+#include <cstring>
+#include <set>
+
+namespace {
+
+using frame_t = std::array<uint8_t, adsb::frame_long_bytes>;
+
+constexpr size_t frame_bits = adsb::frame_long_bytes * 8;
+constexpr size_t df_bits = 5;
+
+/* Straight from the Mode S spec: shift the generator 0x1FFF409 along. */
+uint32_t crc24_reference(const uint8_t* const data, const size_t length) {
+	uint32_t c = 0;
+	for(size_t i=0; i<length * 8; i++) {
+		const uint32_t bit = (data[i >> 3] >> (7 - (i & 7))) & 1;
+		const uint32_t msb = (c >> 23) & 1;
+		c = (c << 1) & 0xFFFFFF;
+		if( msb ^ bit ) {
+			c ^= adsb::crc24_polynomial;
+		}
+	}
+	return c;
+}
+
+void flip(frame_t& frame, const size_t bit) {
+	frame[bit >> 3] ^= 0x80 >> (bit & 7);
+}
+
+frame_t make_frame(host_test::Xorshift32& rng) {
+	frame_t frame;
+	for(auto& b : frame) {
+		b = rng();
+	}
+	frame[0] = (17 << 3) | (frame[0] & 7);
+	const auto parity = crc24_reference(frame.data(), frame.size() - 3);
+	frame[11] = parity >> 16;
+	frame[12] = parity >> 8;
+	frame[13] = parity;
+	return frame;
+}
+
+uint32_t reference_syndrome(const frame_t& frame) {
+	const uint32_t parity = (frame[11] << 16) | (frame[12] << 8) | frame[13];
+	return crc24_reference(frame.data(), frame.size() - 3) ^ parity;
+}
+
+void check_crc(host_test::Xorshift32& rng) {
+	std::array<uint8_t, 32> data;
+	for(size_t length=0; length<=data.size(); length++) {
+		for(auto& b : data) {
+			b = rng();
+		}
+		HOST_CHECK(adsb::crc24(data.data(), length) == crc24_reference(data.data(), length));
+	}
+
+	const auto frame = make_frame(rng);
+	HOST_CHECK(adsb::crc24_syndrome(frame.data(), frame.size()) == 0);
+	HOST_CHECK(reference_syndrome(frame) == 0);
+}
+
+void check_syndromes() {
+	/* The repair table relies on every correctable pattern having its own
+	 * syndrome: 107 single bits and all pairs of them, none zero.
+	 */
+	std::array<uint32_t, frame_bits> single { };
+	std::set<uint32_t> singles;
+	for(size_t bit=df_bits; bit<frame_bits; bit++) {
+		frame_t frame { };
+		flip(frame, bit);
+		single[bit] = reference_syndrome(frame);
+		HOST_CHECK(adsb::crc24_syndrome(frame.data(), frame.size()) == single[bit]);
+		singles.insert(single[bit]);
+	}
+	HOST_CHECK(singles.size() == frame_bits - df_bits);
+	HOST_CHECK(singles.count(0) == 0);
+
+	std::set<uint32_t> pairs;
+	for(size_t i=df_bits; i<frame_bits; i++) {
+		for(size_t j=i+1; j<frame_bits; j++) {
+			const auto s = single[i] ^ single[j];
+			HOST_CHECK(singles.count(s) == 0);
+			pairs.insert(s);
+		}
+	}
+	HOST_CHECK(pairs.size() == (frame_bits - df_bits) * (frame_bits - df_bits - 1) / 2);
+	HOST_CHECK(pairs.count(0) == 0);
+}
+
+void check_repair(host_test::Xorshift32& rng) {
+	const auto original = make_frame(rng);
+
+	{
+		auto frame = original;
+		HOST_CHECK(adsb::crc24_repair(frame.data(), 2) == 0);
+		HOST_CHECK(frame == original);
+	}
+
+	for(size_t bit=df_bits; bit<frame_bits; bit++) {
+		auto frame = original;
+		flip(frame, bit);
+		HOST_CHECK(adsb::crc24_repair(frame.data(), 1) == 1);
+		HOST_CHECK(frame == original);
+	}
+
+	size_t repaired = 0;
+	for(size_t i=df_bits; i<frame_bits; i++) {
+		for(size_t j=i+1; j<frame_bits; j++) {
+			auto frame = original;
+			flip(frame, i);
+			flip(frame, j);
+
+			auto single_only = frame;
+			HOST_CHECK(adsb::crc24_repair(single_only.data(), 1) == -1);
+
+			if( (adsb::crc24_repair(frame.data(), 2) == 2) && (frame == original) ) {
+				repaired++;
+			}
+		}
+	}
+	HOST_CHECK(repaired == (frame_bits - df_bits) * (frame_bits - df_bits - 1) / 2);
+
+	for(size_t bit=0; bit<df_bits; bit++) {
+		auto frame = original;
+		flip(frame, bit);
+		auto corrupted = frame;
+		HOST_CHECK(adsb::crc24_repair(frame.data(), 2) == -1);
+		HOST_CHECK(frame == corrupted);
+	}
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+	const auto n = host_test::iterations(argc, argv, 100000);
+
+	host_test::Xorshift32 rng;
+	check_crc(rng);
+	check_syndromes();
+	check_repair(rng);
+
+	const auto frame = make_frame(rng);
+	volatile uint32_t sink = 0;
+
+	host_test::benchmark("crc24 reference (11 bytes)", n, 1, [&]() {
+		sink = sink + crc24_reference(frame.data(), 11);
+	});
+	host_test::benchmark("crc24 table (11 bytes)", n, 1, [&]() {
+		sink = sink + adsb::crc24(frame.data(), 11);
+	});
+
+	auto one_bit = frame;
+	flip(one_bit, 60);
+	host_test::benchmark("crc24_repair 1 bit", n, 1, [&]() {
+		auto f = one_bit;
+		sink = sink + adsb::crc24_repair(f.data(), 1);
+	});
+
+	auto two_bits = frame;
+	flip(two_bits, 100);
+	flip(two_bits, 110);
+	host_test::benchmark("crc24_repair 2 bits", n / 10, 1, [&]() {
+		auto f = two_bits;
+		sink = sink + adsb::crc24_repair(f.data(), 2);
+	});
+
+	return host_test::result();
+}
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Streams an IQ capture through a baseband processor on the host, in the
+ * 2048-sample blocks the baseband DMA delivers, and reports what came out
+ * and how long each execute() took.
+ *
+ * Usage: baseband_replay <mode> <capture.C8|capture.C16|@noise> [--audio out.wav]
+ *
+ * Modes: nfm pocsag ais adsbrx ert
+ *
+ * .C16 captures are scaled down to C8, as the M4 only ever sees C8. "@noise"
+ * replays a fixed pseudo-random capture, for smoke tests. Block times are
+ * host times: compare them across modes and changes, not with the M4 clock.
+ */
+
+#include "proc_nfm_audio.hpp"
+#include "proc_pocsag.hpp"
+#include "proc_ais.hpp"
+#include "proc_adsbrx.hpp"
+#include "proc_ert.hpp"
+
+#include "dsp_fir_taps.hpp"
+#include "dsp_iir_config.hpp"
+#include "portapack_shared_memory.hpp"
+#include "crc.hpp"
+
+#include "host_baseband.hpp"
+#include "host_test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t block_samples = 2048;
+
+/* 2048 samples at the highest baseband rate (20 MS/s). Slower modes have
+ * proportionally longer block periods, reported alongside.
+ */
+constexpr double budget_us = 102.4;
+
+struct Mode {
+	const char* const name;
+	const uint32_t sampling_rate;
+	std::unique_ptr<BasebandProcessor> (*const make)();
+};
+
+const Mode modes[] = {
+	{ "nfm", 3072000, []() -> std::unique_ptr<BasebandProcessor> {
+		auto p = std::make_unique<NarrowbandFMAudio>();
+		const NBFMConfigureMessage message {
+			taps_16k0_decim_0,
+			taps_16k0_decim_1,
+			taps_16k0_channel,
+			2,
+			5000,
+			audio_24k_hpf_300hz_config,
+			audio_24k_deemph_300_6_config,
+			0
+		};
+		p->on_message(&message);
+		return p;
+	} },
+	{ "pocsag", 3072000, []() -> std::unique_ptr<BasebandProcessor> {
+		auto p = std::make_unique<POCSAGProcessor>();
+		const POCSAGConfigureMessage message { false };
+		p->on_message(&message);
+		return p;
+	} },
+	{ "ais", 2457600, []() -> std::unique_ptr<BasebandProcessor> {
+		return std::make_unique<AISProcessor>();
+	} },
+	{ "adsbrx", 2000000, []() -> std::unique_ptr<BasebandProcessor> {
+		auto p = std::make_unique<ADSBRXProcessor>();
+		const ADSBConfigureMessage message { 1 };
+		p->on_message(&message);
+		return p;
+	} },
+	{ "ert", 4194304, []() -> std::unique_ptr<BasebandProcessor> {
+		return std::make_unique<ERTProcessor>();
+	} },
+};
+
+bool ends_with(const std::string& s, const std::string& suffix) {
+	if( s.size() < suffix.size() ) {
+		return false;
+	}
+	std::string tail = s.substr(s.size() - suffix.size());
+	std::transform(tail.begin(), tail.end(), tail.begin(), ::toupper);
+	return tail == suffix;
+}
+
+bool load_capture(const std::string& path, std::vector<complex8_t>& iq) {
+	if( path == "@noise" ) {
+		host_test::Xorshift32 rng { 0x5eed5eed };
+		iq.resize(block_samples * 256);
+		for(auto& s : iq) {
+			const auto r = rng();
+			s = { static_cast<int8_t>(r >> 3), static_cast<int8_t>(r >> 11) };
+		}
+		return true;
+	}
+
+	std::ifstream file { path, std::ios::binary };
+	if( !file ) {
+		return false;
+	}
+	const std::vector<char> bytes { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+	if( ends_with(path, ".C16") ) {
+		iq.resize(bytes.size() / sizeof(complex16_t));
+		for(size_t i=0; i<iq.size(); i++) {
+			complex16_t s;
+			std::memcpy(&s, &bytes[i * sizeof(s)], sizeof(s));
+			iq[i] = { static_cast<int8_t>(s.real() >> 8), static_cast<int8_t>(s.imag() >> 8) };
+		}
+	} else {
+		iq.resize(bytes.size() / sizeof(complex8_t));
+		std::memcpy(iq.data(), bytes.data(), iq.size() * sizeof(complex8_t));
+	}
+	return true;
+}
+
+void write_u32(std::ofstream& f, const uint32_t v) {
+	f.write(reinterpret_cast<const char*>(&v), 4);
+}
+
+void write_u16(std::ofstream& f, const uint16_t v) {
+	f.write(reinterpret_cast<const char*>(&v), 2);
+}
+
+/* Stereo 16-bit WAV at the processor's audio rate. */
+bool write_wav(const std::string& path, const std::vector<audio::sample_t>& samples, const uint32_t sample_rate) {
+	std::ofstream f { path, std::ios::binary };
+	if( !f ) {
+		return false;
+	}
+	const uint32_t data_size = samples.size() * sizeof(audio::sample_t);
+	f.write("RIFF", 4);
+	write_u32(f, 36 + data_size);
+	f.write("WAVEfmt ", 8);
+	write_u32(f, 16);
+	write_u16(f, 1);
+	write_u16(f, 2);
+	write_u32(f, sample_rate);
+	write_u32(f, sample_rate * sizeof(audio::sample_t));
+	write_u16(f, sizeof(audio::sample_t));
+	write_u16(f, 16);
+	f.write("data", 4);
+	write_u32(f, data_size);
+	f.write(reinterpret_cast<const char*>(samples.data()), data_size);
+	return static_cast<bool>(f);
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+	if( argc < 3 ) {
+		std::fprintf(stderr, "usage: %s <mode> <capture.C8|capture.C16|@noise> [--audio out.wav]\n", argv[0]);
+		return 2;
+	}
+
+	const Mode* mode = nullptr;
+	for(const auto& m : modes) {
+		if( std::strcmp(m.name, argv[1]) == 0 ) {
+			mode = &m;
+		}
+	}
+	if( !mode ) {
+		std::fprintf(stderr, "unknown mode: %s\n", argv[1]);
+		return 2;
+	}
+
+	std::string audio_path;
+	for(int i=3; i<argc; i++) {
+		if( (std::strcmp(argv[i], "--audio") == 0) && (i + 1 < argc) ) {
+			audio_path = argv[++i];
+		}
+	}
+
+	std::vector<complex8_t> iq;
+	if( !load_capture(argv[2], iq) ) {
+		std::fprintf(stderr, "can't read %s\n", argv[2]);
+		return 1;
+	}
+	const size_t blocks = iq.size() / block_samples;
+	if( blocks == 0 ) {
+		std::fprintf(stderr, "capture shorter than one block\n");
+		return 1;
+	}
+
+	auto processor = mode->make();
+
+	/* Drop anything configuration pushed, so counts are per-capture. */
+	shared_memory.application_queue.handle([](const Message* const) { });
+
+	std::map<int, size_t> message_counts;
+	std::vector<double> block_us(blocks);
+	const double period_us = block_samples * 1e6 / mode->sampling_rate;
+
+	for(size_t n=0; n<blocks; n++) {
+		const buffer_c8_t buffer { &iq[n * block_samples], block_samples, mode->sampling_rate };
+
+		const auto start = std::chrono::steady_clock::now();
+		processor->execute(buffer);
+		const auto end = std::chrono::steady_clock::now();
+		block_us[n] = std::chrono::duration<double, std::micro>(end - start).count();
+
+		shared_memory.application_queue.handle([&message_counts](const Message* const message) {
+			message_counts[static_cast<int>(message->id)]++;
+		});
+	}
+
+	double total_us = 0;
+	for(const auto t : block_us) {
+		total_us += t;
+	}
+	const double max_us = *std::max_element(block_us.begin(), block_us.end());
+	const auto over_budget = std::count_if(block_us.begin(), block_us.end(), [](const double t) { return t > budget_us; });
+	const auto over_period = std::count_if(block_us.begin(), block_us.end(), [period_us](const double t) { return t > period_us; });
+
+	std::printf("%s: %zu blocks of %zu samples at %u Hz\n", mode->name, blocks, block_samples, mode->sampling_rate);
+	std::printf("  execute: avg %.2f us, max %.2f us\n", total_us / blocks, max_us);
+	std::printf("  budget %.1f us: %ld blocks over\n", budget_us, static_cast<long>(over_budget));
+	std::printf("  period %.1f us: %ld blocks over, %.1f%% load\n",
+		period_us, static_cast<long>(over_period), 100.0 * total_us / (blocks * period_us));
+
+	for(const auto& count : message_counts) {
+		std::printf("  message id %d: %zu\n", count.first, count.second);
+	}
+
+	const auto& audio = host_baseband::audio();
+	if( !audio.empty() ) {
+		CRC32 crc;
+		crc.process_bytes(audio.data(), audio.size() * sizeof(audio::sample_t));
+		std::printf("  audio: %zu samples, crc32 %08x\n", audio.size(), crc.checksum());
+
+		if( !audio_path.empty() && !write_wav(audio_path, audio, 24000) ) {
+			std::fprintf(stderr, "can't write %s\n", audio_path.c_str());
+			return 1;
+		}
+	}
+
+	return 0;
+}
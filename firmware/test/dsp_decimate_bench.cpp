@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Bit-exact checks and throughput for the baseband decimators, built on the
+ * host against simd_host.hpp. Each decimator runs over a fixed pseudo-random
+ * input split into blocks (so filter state carries across blocks) and its
+ * output is compared with golden_decimate.hpp.
+ *
+ * Usage: dsp_decimate_bench [iterations]
+ *        dsp_decimate_bench --generate > golden_decimate.hpp
+ *
+ * Only regenerate the golden vectors for an intended change in output.
+ */
+
+#include "dsp_decimate.hpp"
+#include "dsp_fir_taps.hpp"
+#include "crc.hpp"
+
+#include "host_test.hpp"
+
+#include "golden_decimate.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace dsp::decimate;
+
+namespace {
+
+constexpr size_t blocks = 8;
+constexpr size_t block_c8 = 2048;		// Baseband DMA transfer at 2.4576 MS/s
+constexpr size_t block_c16 = 256;		// Multiple of FIRAndDecimateComplex taps
+constexpr uint32_t sampling_rate = 2457600;
+
+struct Output {
+	std::vector<complex16_t> samples { };
+
+	void append(const buffer_c16_t& buffer) {
+		samples.insert(samples.end(), buffer.p, buffer.p + buffer.count);
+	}
+
+	uint32_t crc() const {
+		CRC32 crc;
+		crc.process_bytes(samples.data(), samples.size() * sizeof(complex16_t));
+		return crc.checksum();
+	}
+};
+
+std::vector<complex8_t> make_input_c8(const size_t count) {
+	host_test::Xorshift32 rng { 0xc8c8c8c8 };
+	std::vector<complex8_t> input(count);
+	for(auto& s : input) {
+		const auto r = rng();
+		s = { static_cast<int8_t>(r), static_cast<int8_t>(r >> 8) };
+	}
+	return input;
+}
+
+std::vector<complex16_t> make_input_c16(const size_t count) {
+	host_test::Xorshift32 rng { 0x16161616 };
+	std::vector<complex16_t> input(count);
+	for(auto& s : input) {
+		const auto r = rng();
+		s = { static_cast<int16_t>(r), static_cast<int16_t>(r >> 16) };
+	}
+	return input;
+}
+
+/* Each decimator under test: how to configure it, its input and block size. */
+
+struct Decim0 {
+	static constexpr const char* name = "FIRC8xR16x24FS4Decim8";
+	static constexpr size_t block = block_c8;
+	FIRC8xR16x24FS4Decim8 decim { };
+	std::vector<complex8_t> input = make_input_c8(block * blocks);
+	Decim0() { decim.configure(taps_16k0_decim_0.taps, 33554432); }
+	buffer_c16_t run(const size_t n, const buffer_c16_t& dst) {
+		return decim.execute({ &input[n * block], block, sampling_rate }, dst);
+	}
+};
+
+struct Decim1 {
+	static constexpr const char* name = "FIRC16xR16x32Decim8";
+	static constexpr size_t block = block_c16;
+	FIRC16xR16x32Decim8 decim { };
+	std::vector<complex16_t> input = make_input_c16(block * blocks);
+	Decim1() { decim.configure(taps_16k0_decim_1.taps, 131072); }
+	buffer_c16_t run(const size_t n, const buffer_c16_t& dst) {
+		return decim.execute({ &input[n * block], block, sampling_rate / 8 }, dst);
+	}
+};
+
+struct Channel {
+	static constexpr const char* name = "FIRAndDecimateComplex";
+	static constexpr size_t block = block_c16;
+	FIRAndDecimateComplex decim { };
+	std::vector<complex16_t> input = make_input_c16(block * blocks);
+	Channel() { decim.configure(taps_16k0_channel.taps, 2); }
+	buffer_c16_t run(const size_t n, const buffer_c16_t& dst) {
+		return decim.execute({ &input[n * block], block, sampling_rate / 64 }, dst);
+	}
+};
+
+struct CIC3 {
+	static constexpr const char* name = "DecimateBy2CIC3";
+	static constexpr size_t block = block_c16;
+	DecimateBy2CIC3 decim { };
+	std::vector<complex16_t> input = make_input_c16(block * blocks);
+	buffer_c16_t run(const size_t n, const buffer_c16_t& dst) {
+		return decim.execute({ &input[n * block], block, sampling_rate }, dst);
+	}
+};
+
+std::array<complex16_t, block_c8> dst_storage;
+const buffer_c16_t dst { dst_storage.data(), dst_storage.size() };
+
+template<typename T>
+Output run_golden() {
+	T t;
+	Output output;
+	for(size_t n=0; n<blocks; n++) {
+		output.append(t.run(n, dst));
+	}
+	return output;
+}
+
+template<typename T>
+void generate() {
+	const auto output = run_golden<T>();
+	std::printf("\t{ \"%s\", %zu, 0x%08x, { {", T::name, output.samples.size(), output.crc());
+	for(size_t i=0; i<golden::head_length; i++) {
+		std::printf("%s%s{ %d, %d }", i ? "," : "", (i % 4) ? " " : "\n\t\t", output.samples[i].real(), output.samples[i].imag());
+	}
+	std::printf("\n\t} } },\n");
+}
+
+template<typename T>
+void check(const size_t iterations) {
+	const auto output = run_golden<T>();
+	const golden::Vector* expected = nullptr;
+	for(const auto& v : golden::vectors) {
+		if( std::string(v.name) == T::name ) {
+			expected = &v;
+		}
+	}
+
+	HOST_CHECK(expected != nullptr);
+	if( expected ) {
+		HOST_CHECK(output.samples.size() == expected->count);
+		HOST_CHECK(output.crc() == expected->crc);
+		for(size_t i=0; (i<golden::head_length) && (i<output.samples.size()); i++) {
+			HOST_CHECK(output.samples[i] == expected->head[i]);
+		}
+	}
+
+	T t;
+	host_test::benchmark(T::name, iterations, T::block, [&t]() { t.run(0, dst); });
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+	if( (argc > 1) && (std::strcmp(argv[1], "--generate") == 0) ) {
+		std::printf("/* Generated by dsp_decimate_bench --generate. */\n\n");
+		std::printf("#ifndef __GOLDEN_DECIMATE_H__\n#define __GOLDEN_DECIMATE_H__\n\n");
+		std::printf("#include \"complex.hpp\"\n\n#include <array>\n#include <cstddef>\n#include <cstdint>\n\n");
+		std::printf("namespace golden {\n\nconstexpr size_t head_length = %zu;\n\n", golden::head_length);
+		std::printf("struct Vector {\n\tconst char* name;\n\tsize_t count;\n\tuint32_t crc;\n\tstd::array<complex16_t, head_length> head;\n};\n\n");
+		std::printf("const Vector vectors[] = {\n");
+		generate<Decim0>();
+		generate<Decim1>();
+		generate<Channel>();
+		generate<CIC3>();
+		std::printf("};\n\n} /* namespace golden */\n\n#endif/*__GOLDEN_DECIMATE_H__*/\n");
+		return 0;
+	}
+
+	const auto n = host_test::iterations(argc, argv, 20000);
+	std::printf("%zu iterations per decimator; items are input samples\n", n);
+	std::printf("M4 budget at 204 MHz for the 2.4576 MS/s front end: %.1f cycles/sample\n", 204e6 / sampling_rate);
+	check<Decim0>(n);
+	check<Decim1>(n);
+	check<Channel>(n);
+	check<CIC3>(n);
+	return host_test::result();
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Checks the radix-4 FFT engines in dsp_fft.hpp against a direct DFT in
+ * double precision:
+ *
+ * - float fft_c_preswapped_radix4() and the radix-2 fft_c_preswapped() it
+ *   replaced, for random input;
+ * - Q15 and Q31 fft_c_preswapped_radix4_fixed(), which return DFT/N, for
+ *   random input and for full-scale tones;
+ * - Q15 input out in the corners of the square, where twiddle rotations
+ *   push a result past full scale: stores must saturate, not wrap.
+ *
+ * Then times each engine at 256 points, the largest fft_c_preswapped()
+ * supports.
+ *
+ * Usage: dsp_fft_test [iterations]
+ */
+
+#include "dsp_fft.hpp"
+
+#include "host_test.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <type_traits>
+
+namespace {
+
+using complexd = std::complex<double>;
+
+template<size_t N>
+std::array<complexd, N> dft(const std::array<complexd, N>& x) {
+	std::array<complexd, N> result;
+	for(size_t k=0; k<N; k++) {
+		complexd sum { 0.0, 0.0 };
+		for(size_t n=0; n<N; n++) {
+			sum += x[n] * std::polar(1.0, -2.0 * M_PI * double((k * n) % N) / N);
+		}
+		result[k] = sum;
+	}
+	return result;
+}
+
+/* Random samples with magnitude below 1. */
+template<size_t N>
+std::array<complexd, N> random_input(host_test::Xorshift32& rng) {
+	std::array<complexd, N> x;
+	for(auto& v : x) {
+		const double magnitude = rng() / 4294967296.0;
+		const double angle = rng() * (2.0 * M_PI / 4294967296.0);
+		v = std::polar(magnitude, angle);
+	}
+	return x;
+}
+
+template<size_t N>
+std::array<complexd, N> tone(const size_t bin) {
+	std::array<complexd, N> x;
+	for(size_t n=0; n<N; n++) {
+		x[n] = std::polar(1.0, 2.0 * M_PI * double((bin * n) % N) / N);
+	}
+	return x;
+}
+
+/* Bit-reverses x into the engine's sample type, scaled by `scale`. */
+template<typename T, size_t N>
+std::array<T, N> preswapped(const std::array<complexd, N>& x, const double scale) {
+	std::array<complexd, N> swapped;
+	fft_swap(x, swapped);
+	using V = typename T::value_type;
+	const auto convert = [scale](const double v) {
+		return std::is_integral<V>::value ? static_cast<V>(std::round(v * scale)) : static_cast<V>(v * scale);
+	};
+	std::array<T, N> result;
+	for(size_t n=0; n<N; n++) {
+		result[n] = { convert(swapped[n].real()), convert(swapped[n].imag()) };
+	}
+	return result;
+}
+
+/* Largest component error against `expected`, in units of `scale`. */
+template<typename T, size_t N>
+double max_error(const std::array<T, N>& actual, const std::array<complexd, N>& expected, const double scale) {
+	double error = 0;
+	for(size_t k=0; k<N; k++) {
+		error = std::max(error, std::abs(double(actual[k].real()) - expected[k].real() * scale));
+		error = std::max(error, std::abs(double(actual[k].imag()) - expected[k].imag() * scale));
+	}
+	return error;
+}
+
+template<size_t N>
+void check_size(host_test::Xorshift32& rng) {
+	constexpr size_t K = log_2(N);
+	const auto x = random_input<N>(rng);
+	const auto expected = dft(x);
+
+	auto f = preswapped<std::complex<float>>(x, 1.0);
+	fft_c_preswapped_radix4(f);
+	const double error_f = max_error(f, expected, 1.0) / N;
+	HOST_CHECK(error_f < 1e-6);
+
+	/* fft_c_preswapped() has no twiddle factors past 256 points. */
+	double error_f_radix2 = 0;
+	if constexpr( K <= 8 ) {
+		auto f2 = preswapped<std::complex<float>>(x, 1.0);
+		fft_c_preswapped(f2, 0, K);
+		error_f_radix2 = max_error(f2, expected, 1.0) / N;
+		HOST_CHECK(error_f_radix2 < 1e-6);
+	}
+
+	/* Output is DFT/N. Rounding costs up to about half an LSB per pass, on
+	 * top of the twiddle quantization.
+	 */
+	auto q15 = preswapped<complex16_t>(x, 32767.0);
+	fft_c_preswapped_radix4_fixed(q15);
+	const double error_q15 = max_error(q15, expected, 32767.0 / N);
+	HOST_CHECK(error_q15 <= 2.0);
+
+	auto q31 = preswapped<complex32_t>(x, 2147483647.0);
+	fft_c_preswapped_radix4_fixed(q31);
+	const double error_q31 = max_error(q31, expected, 2147483647.0 / N);
+	HOST_CHECK(error_q31 <= 2.0);
+
+	/* A full-scale tone comes out at full scale in its bin, and nowhere
+	 * else.
+	 */
+	const size_t bin = (N / 3) | 1;
+	const auto x_tone = tone<N>(bin);
+	const auto expected_tone = dft(x_tone);
+	auto q15_tone = preswapped<complex16_t>(x_tone, 32767.0);
+	fft_c_preswapped_radix4_fixed(q15_tone);
+	const double error_q15_tone = max_error(q15_tone, expected_tone, 32767.0 / N);
+	HOST_CHECK(error_q15_tone <= 2.0);
+
+	std::printf("N=%4zu: float %.1e (radix-2 %.1e), Q15 %.2f LSB (tone %.2f), Q31 %.2f LSB\n",
+		N, error_f, error_f_radix2, error_q15, error_q15_tone, error_q31);
+}
+
+/* Input in the corners of the square can drive a result past full scale:
+ * here the second pass of a 16-point transform sums x0, a -90 degree
+ * rotation that keeps a 32767 component, and two 45 degree rotations of
+ * corners that each land at 46340. DFT/N for that bin is 39553, which must
+ * saturate to 32767; a wrapped store would come out near -26000.
+ */
+void check_corner() {
+	constexpr size_t N = 16;
+	constexpr int16_t A = 32767;
+	const std::array<complex16_t, 4> corners { {
+		{ A, A }, { A, A }, { A, A }, { -A, A }
+	} };
+
+	/* Each group of four, [P, P, -P, -P], leaves P at its third output
+	 * after the first pass.
+	 */
+	std::array<complex16_t, N> q15;
+	std::array<complexd, N> swapped;
+	for(size_t g=0; g<4; g++) {
+		const auto p = corners[g];
+		const complex16_t p_neg { static_cast<int16_t>(-p.real()), static_cast<int16_t>(-p.imag()) };
+		for(size_t i=0; i<4; i++) {
+			q15[g * 4 + i] = (i < 2) ? p : p_neg;
+			swapped[g * 4 + i] = { double(q15[g * 4 + i].real()), double(q15[g * 4 + i].imag()) };
+		}
+	}
+	std::array<complexd, N> x;
+	fft_swap(swapped, x);
+	const auto expected = dft(x);
+
+	fft_c_preswapped_radix4_fixed(q15);
+
+	HOST_CHECK(expected[2].real() / N > 39000.0);
+	HOST_CHECK(q15[2].real() == 32767);
+	const double error = max_error(q15, expected, 1.0 / N);
+	std::printf("corner input: bin 2 %d (DFT/N %.0f), max error %.0f LSB\n",
+		q15[2].real(), expected[2].real() / N, error);
+	HOST_CHECK(error < 8192.0);
+}
+
+template<typename T, typename F>
+void bench(const char* const name, const size_t iterations, const std::array<T, 256>& input, F fft) {
+	std::array<T, 256> data;
+	host_test::benchmark(name, iterations, 256, [&]() {
+		data = input;
+		fft(data);
+		asm volatile("" : : "r"(data.data()) : "memory");
+	});
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+	const auto n = host_test::iterations(argc, argv, 20000);
+
+	host_test::Xorshift32 rng;
+	check_size<4>(rng);
+	check_size<8>(rng);
+	check_size<16>(rng);
+	check_size<32>(rng);
+	check_size<64>(rng);
+	check_size<128>(rng);
+	check_size<256>(rng);
+	check_size<512>(rng);
+	check_size<1024>(rng);
+	check_corner();
+
+	/* Each pass includes copying the 256 input samples. */
+	const auto x = random_input<256>(rng);
+	bench("fft_c_preswapped float", n, preswapped<std::complex<float>>(x, 1.0), [](std::array<std::complex<float>, 256>& d) {
+		fft_c_preswapped(d, 0, 8);
+	});
+	bench("radix4 float", n, preswapped<std::complex<float>>(x, 1.0), [](std::array<std::complex<float>, 256>& d) {
+		fft_c_preswapped_radix4(d);
+	});
+	bench("radix4 Q15", n, preswapped<complex16_t>(x, 32767.0), [](std::array<complex16_t, 256>& d) {
+		fft_c_preswapped_radix4_fixed(d);
+	});
+	bench("radix4 Q31", n, preswapped<complex32_t>(x, 2147483647.0), [](std::array<complex32_t, 256>& d) {
+		fft_c_preswapped_radix4_fixed(d);
+	});
+
+	return host_test::result();
+}
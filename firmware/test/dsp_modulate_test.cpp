@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Checks the shared NCO and modulators in dsp_modulate:
+ *
+ * - sin_q15() and sin_cos_q15() against libm, to within 2 LSB;
+ * - the C8 carrier's worst spur, windowed FFT over several tones, against
+ *   the sine_table_i8 loop the TX processors used before;
+ * - FM lands on the frequency its input asks for, AM scales the carrier.
+ *
+ * Then times the old per-sample loop, NCO::next(), CW and FM.
+ *
+ * Usage: dsp_modulate_test [iterations]
+ */
+
+#include "dsp_modulate.hpp"
+#include "sine_table_int8.hpp"
+
+#include "host_test.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace {
+
+using namespace dsp::modulate;
+
+constexpr size_t fft_size = 8192;
+
+/* What each TX processor did before, cos being sin at +64. */
+class LegacyNCO {
+public:
+	complex8_t next(const uint32_t delta) {
+		phase += delta;
+		const uint32_t sphase = phase + (64 << 24);
+		return { sine_table_i8[sphase >> 24], sine_table_i8[phase >> 24] };
+	}
+
+private:
+	uint32_t phase { 0 };
+};
+
+void fft(std::vector<std::complex<double>>& x) {
+	const size_t n = x.size();
+	for(size_t i=1, j=0; i<n; i++) {
+		size_t bit = n >> 1;
+		for(; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+		j ^= bit;
+		if( i < j ) {
+			std::swap(x[i], x[j]);
+		}
+	}
+	for(size_t len=2; len<=n; len <<= 1) {
+		const auto w = std::polar(1.0, -2.0 * M_PI / len);
+		for(size_t i=0; i<n; i+=len) {
+			std::complex<double> wn { 1.0, 0.0 };
+			for(size_t k=0; k<len/2; k++) {
+				const auto u = x[i + k];
+				const auto v = x[i + k + len/2] * wn;
+				x[i + k] = u + v;
+				x[i + k + len/2] = u - v;
+				wn *= w;
+			}
+		}
+	}
+}
+
+/* Worst spur relative to the carrier, in dB. 4-term Blackman-Harris window
+ * (sidelobes at -92dB), with the carrier's main lobe, +/-4 bins, left out.
+ */
+double worst_spur_dbc(const std::vector<complex8_t>& samples) {
+	std::vector<std::complex<double>> x(fft_size);
+	for(size_t n=0; n<fft_size; n++) {
+		const double t = 2.0 * M_PI * n / fft_size;
+		const double w = 0.35875 - 0.48829 * std::cos(t) + 0.14128 * std::cos(2 * t) - 0.01168 * std::cos(3 * t);
+		x[n] = std::complex<double>(samples[n].real(), samples[n].imag()) * w;
+	}
+	fft(x);
+
+	size_t peak = 0;
+	for(size_t n=0; n<fft_size; n++) {
+		if( std::norm(x[n]) > std::norm(x[peak]) ) {
+			peak = n;
+		}
+	}
+
+	double spur = 0;
+	for(size_t n=0; n<fft_size; n++) {
+		const size_t distance = std::min((n - peak) % fft_size, (peak - n) % fft_size);
+		if( distance > 4 ) {
+			spur = std::max(spur, std::norm(x[n]));
+		}
+	}
+	return 10.0 * std::log10(spur / std::norm(x[peak]));
+}
+
+size_t peak_bin(const std::vector<complex8_t>& samples) {
+	std::vector<std::complex<double>> x(fft_size);
+	for(size_t n=0; n<fft_size; n++) {
+		x[n] = { double(samples[n].real()), double(samples[n].imag()) };
+	}
+	fft(x);
+	size_t peak = 0;
+	for(size_t n=0; n<fft_size; n++) {
+		if( std::norm(x[n]) > std::norm(x[peak]) ) {
+			peak = n;
+		}
+	}
+	return peak;
+}
+
+void check_sine(host_test::Xorshift32& rng) {
+	int32_t error_max = 0;
+	for(size_t n=0; n<200000; n++) {
+		const uint32_t phase = (n < (1U << 16)) ? (n << 16) : rng();
+		const double angle = phase * (2.0 * M_PI / 4294967296.0);
+		const int32_t s_ref = std::lround(32767.0 * std::sin(angle));
+		const int32_t c_ref = std::lround(32767.0 * std::cos(angle));
+
+		int32_t s, c;
+		sin_cos_q15(phase, s, c);
+		error_max = std::max(error_max, std::abs(s - s_ref));
+		error_max = std::max(error_max, std::abs(c - c_ref));
+		error_max = std::max(error_max, std::abs(sin_q15(phase) - s_ref));
+	}
+	std::printf("sin_q15/sin_cos_q15: max error %d LSB\n", error_max);
+	HOST_CHECK(error_max <= 2);
+}
+
+void check_carrier() {
+	// Arbitrary tones, none landing on a bin or a table step
+	const uint32_t deltas[] = { 0x0123f7a5, 0x05b6d1c3, 0x1d0a9e37, 0x3fe01455, 0x9a3c5e21, 0xf2a0c3b9 };
+
+	double worst = -200;
+	double worst_legacy = -200;
+	for(const auto delta : deltas) {
+		NCO nco;
+		LegacyNCO legacy;
+		std::vector<complex8_t> carrier(fft_size);
+		std::vector<complex8_t> carrier_legacy(fft_size);
+		for(size_t n=0; n<fft_size; n++) {
+			carrier[n] = nco.next(delta);
+			carrier_legacy[n] = legacy.next(delta);
+		}
+		worst = std::max(worst, worst_spur_dbc(carrier));
+		worst_legacy = std::max(worst_legacy, worst_spur_dbc(carrier_legacy));
+
+		// The buffer kernel is the same carrier, two samples per store
+		CW cw;
+		std::vector<complex8_t> block(fft_size + 1);
+		cw.execute({ &block[1], fft_size, 0 }, delta);
+		HOST_CHECK(std::equal(carrier.begin(), carrier.end(), block.begin() + 1, [](const complex8_t a, const complex8_t b) {
+			return (a.real() == b.real()) && (a.imag() == b.imag());
+		}));
+	}
+	std::printf("carrier worst spur: %.1f dBc (sine_table_i8 loop: %.1f dBc)\n", worst, worst_legacy);
+	HOST_CHECK(worst < -55.0);
+	HOST_CHECK(worst < worst_legacy - 10.0);
+}
+
+void check_fm_am() {
+	// 16 source samples, 512 output samples each: bin = k * s / 256 * N / 2^32
+	const uint32_t k = 0x10000;
+	const int16_t level = 3000;
+	std::vector<int16_t> audio(16, level);
+	std::vector<complex8_t> out(fft_size);
+
+	FM fm;
+	fm.configure(k);
+	fm.execute({ audio.data(), audio.size(), 0 }, { out.data(), out.size(), 0 });
+	const size_t expected_bin = std::lround((double(level) * k / 256.0) * fft_size / 4294967296.0);
+	HOST_CHECK(peak_bin(out) == expected_bin);
+
+	fm.execute({ audio.data(), audio.size(), 0 }, { out.data(), out.size(), 0 });
+	HOST_CHECK(worst_spur_dbc(out) < -55.0);
+
+	AM am;
+	am.configure(0x0b3a7c19);
+	for(const int16_t a : { int16_t(32767), int16_t(16384), int16_t(0) }) {
+		std::fill(audio.begin(), audio.end(), a);
+		am.execute({ audio.data(), audio.size(), 0 }, { out.data(), out.size(), 0 });
+		double power = 0;
+		for(const auto s : out) {
+			power += double(s.real()) * s.real() + double(s.imag()) * s.imag();
+		}
+		const double amplitude = std::sqrt(power / out.size());
+		HOST_CHECK(std::abs(amplitude - 127.0 * a / 32767.0) < 1.0);
+	}
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+	const auto n = host_test::iterations(argc, argv, 20000);
+
+	host_test::Xorshift32 rng;
+	check_sine(rng);
+	check_carrier();
+	check_fm_am();
+
+	constexpr size_t block = 2048;
+	std::vector<complex8_t> out(block);
+	std::vector<int16_t> audio(block / 8);
+	for(auto& s : audio) {
+		s = rng();
+	}
+	const uint32_t delta = 0x0123f7a5;
+
+	LegacyNCO legacy;
+	host_test::benchmark("sine_table_i8 loop", n, block, [&]() {
+		for(auto& s : out) {
+			s = legacy.next(delta);
+		}
+	});
+
+	NCO nco;
+	host_test::benchmark("NCO::next", n, block, [&]() {
+		for(auto& s : out) {
+			s = nco.next(delta);
+		}
+	});
+
+	CW cw;
+	host_test::benchmark("CW::execute", n, block, [&]() {
+		cw.execute({ out.data(), out.size(), 0 }, delta);
+	});
+
+	FM fm;
+	fm.configure(0x10000);
+	host_test::benchmark("FM::execute (hold 8)", n, block, [&]() {
+		fm.execute({ audio.data(), audio.size(), 0 }, { out.data(), out.size(), 0 });
+	});
+
+	return host_test::result();
+}
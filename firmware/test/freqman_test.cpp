@@ -0,0 +1,408 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Checks the frequency manager's file parser and its cached index, in a
+ * scratch directory:
+ *
+ * - parse_freqman_line() on each kind of line it accepts or reports, line
+ *   endings, over-long lines and the per-file entry limit;
+ * - a generated 10k-line file, loaded entry for entry against the model
+ *   that wrote it, and indexed: the first FREQMAN_INDEX_MAX_ENTRIES valid
+ *   entries, sorted, each description stored once;
+ * - the cached .IDX round trip, reuse of a cache built with a higher limit
+ *   or a partial cache holding enough entries, and rebuilds when the file
+ *   changes, the cache is damaged or holds too few entries;
+ * - interning past its hash table's 3/4 fill, and past the 64KiB
+ *   description limit, where the index stops early.
+ *
+ * Then times load_freqman_file() and load_freqman_index(), built cold and
+ * from the cache, on the 10k-line file.
+ *
+ * Usage: freqman_test [iterations]
+ */
+
+#include "freqman.hpp"
+
+#include "host_test.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+using Key = std::tuple<rf::Frequency, rf::Frequency, std::string, int, int>;
+
+Key key(const freqman_entry& e) {
+	return { e.frequency_a, e.frequency_b, e.description, e.type, e.step };
+}
+
+Key key(const freqman_index& index, const freqman_index_entry& e) {
+	return { e.frequency_a(), e.frequency_b(), index.description(e), e.type, e.step };
+}
+
+void write_file(const std::string& stem, const std::string& contents) {
+	std::ofstream out { "FREQMAN/" + stem + ".TXT", std::ios::binary | std::ios::trunc };
+	out << contents;
+}
+
+/* Header fields of a cached index (see freqman_index_header). */
+struct CachedHeader {
+	uint32_t entry_count;
+	uint32_t complete;
+};
+
+CachedHeader cached_header(const std::string& stem) {
+	std::ifstream in { "FREQMAN/" + stem + ".IDX", std::ios::binary };
+	uint32_t words[8] { };
+	in.read(reinterpret_cast<char*>(words), sizeof(words));
+	return { words[4], words[6] };
+}
+
+void check_lines() {
+	const std::string long_description(FREQMAN_DESC_MAX_LEN, 'x');
+	const std::string overlong(400, 'y');
+
+	write_file("LINES",
+		"f=433920000,d=Remote\n"
+		"a=100000000,b=200000000,d=Band,s=3\r\n"
+		"a=200000000,b=100000000,d=Backwards\n"
+		"# comment\n"
+		"f=1000,d=Has // in it\n"
+		"\n"
+		"f=0\n"
+		"f=7500000001\n"
+		"a=1000\n"
+		"b=1000\n"
+		"x=1\n"
+		"af=1,f=2000\n"
+		"f=3000,d=\n"
+		"f=4000,d=" + long_description + "\n"
+		"a=1,b=2\n"
+		"a=1,b=2,d=R,s=99\n"
+		"f=5000,s=3,d=Single\n"
+		"f=6000,d=Ctrl\x01\n"
+		"f=7000,d=Short,x=" + overlong + "\n"
+		"f=7499999999,d=Last"
+	);
+
+	const std::vector<freqman_entry> expected {
+		{ 433920000, 0, "Remote", SINGLE, STEP_DEF },
+		{ 100000000, 200000000, "Band-3", RANGE, NFM_1 },
+		{ 0, 0, "[3]:Freq A: > B:", ERROR, STEP_DEF },
+		{ 0, 0, "# comment", COMMENT, STEP_DEF },
+		{ 0, 0, "f=1000,d=Has // in it", COMMENT, STEP_DEF },
+		{ 0, 0, "[6]:Empty Line", ERROR, STEP_DEF },
+		{ 0, 0, "[7]:F: out of limit", ERROR, STEP_DEF },
+		{ 0, 0, "[8]:F: out of limit", ERROR, STEP_DEF },
+		{ 1000, 0, "[9]:No B: but A:", ERROR, STEP_DEF },
+		{ 0, 1000, "[10]:No A: but B:", ERROR, STEP_DEF },
+		{ 0, 0, "[11]:No Useful Info", ERROR, STEP_DEF },
+		{ 2000, 0, "---", SINGLE, STEP_DEF },
+		{ 3000, 0, "[13]:R w/o Description", ERROR, STEP_DEF },
+		{ 4000, 0, "[14]:D too long", ERROR, STEP_DEF },
+		{ 1, 2, "[15]:R w/o Description", ERROR, STEP_DEF },
+		{ 1, 2, "[16]:Step Err", ERROR, ERROR_STEP },
+		{ 5000, 0, "Single", SINGLE, STEP_DEF },
+		{ 0, 0, "[18]:CAR:P:14<\x01><01>", ERROR, STEP_DEF },
+		{ 7000, 0, "Short", SINGLE, STEP_DEF },
+		{ 7499999999, 0, "Last", SINGLE, STEP_DEF },
+	};
+
+	std::string stem { "LINES" };
+	freqman_db db;
+	HOST_CHECK(load_freqman_file(stem, db, 100));
+	HOST_CHECK(db.size() == expected.size());
+	for(size_t i=0; (i<db.size()) && (i<expected.size()); i++) {
+		if( key(db[i]) != key(expected[i]) ) {
+			std::printf("line %zu: got \"%s\" type %d\n", i + 1, db[i].description.c_str(), db[i].type);
+			HOST_CHECK(key(db[i]) == key(expected[i]));
+		}
+	}
+
+	// At the limit, an error entry says where it stopped
+	HOST_CHECK(load_freqman_file(stem, db, 5));
+	HOST_CHECK(db.size() == 6);
+	HOST_CHECK((db.size() == 6) && (db[5].type == ERROR) && (db[5].description == "[5]:Lines >5"));
+
+	std::string missing { "MISSING" };
+	HOST_CHECK(!load_freqman_file(missing, db));
+	freqman_index index;
+	HOST_CHECK(!load_freqman_index(missing, index));
+
+	// The index only takes SINGLE and RANGE entries, and keeps the step
+	HOST_CHECK(load_freqman_index(stem, index));
+	HOST_CHECK(index.entries.size() == 6);
+	HOST_CHECK(std::is_sorted(index.entries.begin(), index.entries.end(), [](const freqman_index_entry& l, const freqman_index_entry& r) {
+		return l.frequency_a() < r.frequency_a();
+	}));
+	HOST_CHECK(key(index, index.entries.back()) == Key(7499999999, 0, "Last", SINGLE, STEP_DEF));
+	const auto band = std::find_if(index.entries.begin(), index.entries.end(), [](const freqman_index_entry& e) {
+		return e.type == RANGE;
+	});
+	HOST_CHECK((band != index.entries.end()) && (key(index, *band) == Key(100000000, 200000000, "Band", RANGE, NFM_1)));
+}
+
+/* Writes `lines` lines: mostly SINGLE with descriptions from a pool of
+ * `pool` names, some RANGE, comments, errors and lines without a
+ * description. Returns what load_freqman_file() should produce.
+ */
+std::vector<freqman_entry> generate(const std::string& stem, const size_t lines, const size_t pool, host_test::Xorshift32& rng) {
+	std::vector<freqman_entry> model;
+	std::string contents;
+	for(size_t n=1; n<=lines; n++) {
+		const rf::Frequency f = 1 + (((uint64_t)rng() << 1) | (rng() & 1)) % 7499999000ULL;
+		const std::string name = "Chan " + std::to_string((pool > 0) ? (rng() % pool) : n);
+		const uint32_t kind = rng() % 100;
+		std::string line;
+		if( kind < 80 ) {
+			line = "f=" + std::to_string(f) + ",d=" + name;
+			model.push_back({ f, 0, name, SINGLE, STEP_DEF });
+		} else if( kind < 88 ) {
+			const auto step = rng() % ERROR_STEP;
+			line = "a=" + std::to_string(f) + ",b=" + std::to_string(f + 25000) + ",d=" + name + ",s=" + std::to_string(step);
+			model.push_back({ f, f + 25000, step ? (name + "-" + std::to_string(step)) : name, RANGE, (freqman_entry_step)step });
+		} else if( kind < 92 ) {
+			line = "f=" + std::to_string(f);
+			model.push_back({ f, 0, "---", SINGLE, STEP_DEF });
+		} else if( kind < 96 ) {
+			line = "# " + name;
+			model.push_back({ 0, 0, line, COMMENT, STEP_DEF });
+		} else {
+			line = "a=" + std::to_string(f);
+			model.push_back({ f, 0, "[" + std::to_string(n) + "]:No B: but A:", ERROR, STEP_DEF });
+		}
+		contents += line + ((n & 1) ? "\n" : "\r\n");
+	}
+	write_file(stem, contents);
+	std::filesystem::remove("FREQMAN/" + stem + ".IDX");
+	return model;
+}
+
+/* What the index should hold: the first `limit` valid entries, with the
+ * step suffix load_freqman_file() adds taken back off.
+ */
+std::multiset<Key> expected_index(const std::vector<freqman_entry>& model, const size_t limit) {
+	std::multiset<Key> result;
+	for(const auto& e : model) {
+		if( result.size() >= limit ) {
+			break;
+		}
+		if( (e.type == SINGLE) || (e.type == RANGE) ) {
+			auto description = e.description;
+			if( (e.type == RANGE) && (e.step != STEP_DEF) ) {
+				description.erase(description.rfind('-'));
+			}
+			result.insert({ e.frequency_a, e.frequency_b, description, e.type, e.step });
+		}
+	}
+	return result;
+}
+
+bool index_matches(const freqman_index& index, const std::multiset<Key>& expected) {
+	std::multiset<Key> actual;
+	for(const auto& e : index.entries) {
+		actual.insert(key(index, e));
+	}
+	return (actual == expected) && std::is_sorted(index.entries.begin(), index.entries.end(), [](const freqman_index_entry& l, const freqman_index_entry& r) {
+		return l.frequency_a() < r.frequency_a();
+	});
+}
+
+/* Distinct strings in the description buffer. */
+size_t descriptions_stored(const freqman_index& index) {
+	return std::count(index.descriptions.begin(), index.descriptions.end(), 0);
+}
+
+size_t distinct_descriptions(const std::multiset<Key>& entries) {
+	std::set<std::string> names;
+	for(const auto& e : entries) {
+		names.insert(std::get<2>(e));
+	}
+	return names.size();
+}
+
+void check_large(const std::string& stem, const std::vector<freqman_entry>& model) {
+	std::string s { stem };
+	freqman_db db;
+	HOST_CHECK(load_freqman_file(s, db, model.size() + 1));
+	HOST_CHECK(db.size() == model.size());
+	size_t mismatches = 0;
+	for(size_t i=0; (i<db.size()) && (i<model.size()); i++) {
+		mismatches += (key(db[i]) != key(model[i])) ? 1 : 0;
+	}
+	HOST_CHECK(mismatches == 0);
+
+	// Cold: more valid entries than the index holds, so it stops early
+	const auto expected = expected_index(model, FREQMAN_INDEX_MAX_ENTRIES);
+	freqman_index index;
+	HOST_CHECK(load_freqman_index(s, index));
+	HOST_CHECK(index.entries.size() == FREQMAN_INDEX_MAX_ENTRIES);
+	HOST_CHECK(index_matches(index, expected));
+	HOST_CHECK(descriptions_stored(index) == distinct_descriptions(expected));
+	const auto header = cached_header(stem);
+	HOST_CHECK((header.entry_count == FREQMAN_INDEX_MAX_ENTRIES) && !header.complete);
+
+	// Cached: same index back
+	freqman_index cached;
+	HOST_CHECK(load_freqman_index(s, cached));
+	HOST_CHECK(index_matches(cached, expected));
+	HOST_CHECK(cached.descriptions == index.descriptions);
+
+	// A lower limit reuses the cache, reading only the descriptions it needs
+	freqman_index partial;
+	HOST_CHECK(load_freqman_index(s, partial, 1000));
+	HOST_CHECK(index_matches(partial, expected_index(model, 1000)));
+	HOST_CHECK(partial.descriptions.size() <= index.descriptions.size());
+	HOST_CHECK(cached_header(stem).entry_count == FREQMAN_INDEX_MAX_ENTRIES);
+
+	std::printf("%zu lines: %zu indexed, %zu descriptions in %zu bytes (%zu for the first 1000)\n",
+		model.size(), index.entries.size(), descriptions_stored(index), index.descriptions.size(), partial.descriptions.size());
+}
+
+void check_cache_reuse(host_test::Xorshift32& rng) {
+	std::string stem { "REUSE" };
+	auto model = generate(stem, 200, 20, rng);
+	const auto valid = expected_index(model, 10000).size();
+	freqman_index index;
+
+	// Built with a limit below the file's valid entries: incomplete
+	HOST_CHECK(load_freqman_index(stem, index, 50));
+	HOST_CHECK(index_matches(index, expected_index(model, 50)));
+	auto header = cached_header(stem);
+	HOST_CHECK((header.entry_count == 50) && !header.complete);
+
+	// Too few cached for a higher limit: rebuilt
+	HOST_CHECK(load_freqman_index(stem, index, 80));
+	HOST_CHECK(index_matches(index, expected_index(model, 80)));
+	HOST_CHECK(cached_header(stem).entry_count == 80);
+
+	// Enough for a lower one: reused as is
+	HOST_CHECK(load_freqman_index(stem, index, 20));
+	HOST_CHECK(index_matches(index, expected_index(model, 20)));
+	HOST_CHECK(cached_header(stem).entry_count == 80);
+
+	// Complete: reused for any limit
+	HOST_CHECK(load_freqman_index(stem, index));
+	header = cached_header(stem);
+	HOST_CHECK((header.entry_count == valid) && header.complete);
+	HOST_CHECK(load_freqman_index(stem, index, 1000));
+	HOST_CHECK(index_matches(index, expected_index(model, 10000)));
+
+	// The file changed: rebuilt
+	{
+		std::ofstream out { "FREQMAN/REUSE.TXT", std::ios::binary | std::ios::app };
+		out << "\nf=123456789,d=Added";
+	}
+	model.push_back({ 0, 0, "", ERROR, STEP_DEF });
+	model.push_back({ 123456789, 0, "Added", SINGLE, STEP_DEF });
+	HOST_CHECK(load_freqman_index(stem, index));
+	HOST_CHECK(index_matches(index, expected_index(model, 10000)));
+	HOST_CHECK(cached_header(stem).entry_count == valid + 1);
+
+	// Cut short: rebuilt
+	std::filesystem::resize_file("FREQMAN/REUSE.IDX", 40);
+	HOST_CHECK(load_freqman_index(stem, index));
+	HOST_CHECK(index_matches(index, expected_index(model, 10000)));
+	HOST_CHECK(std::filesystem::file_size("FREQMAN/REUSE.IDX") > 40);
+}
+
+void check_interning(host_test::Xorshift32& rng) {
+	// More distinct descriptions than the hash table takes: stored unshared
+	std::string stem { "DISTINCT" };
+	const auto model = generate(stem, 1000, 0, rng);
+	freqman_index index;
+	HOST_CHECK(load_freqman_index(stem, index));
+	const auto expected = expected_index(model, 10000);
+	HOST_CHECK(index_matches(index, expected));
+	HOST_CHECK(descriptions_stored(index) >= distinct_descriptions(expected));
+
+	// Past 64KiB of descriptions the index stops, and says so
+	std::string wide_stem { "WIDE" };
+	std::string contents;
+	for(size_t n=0; n<FREQMAN_INDEX_MAX_ENTRIES; n++) {
+		auto name = "Unique " + std::to_string(n);
+		name.resize(FREQMAN_DESC_MAX_LEN - 1, '.');
+		contents += "f=" + std::to_string(100000000 + n) + ",d=" + name + "\n";
+	}
+	write_file(wide_stem, contents);
+	HOST_CHECK(load_freqman_index(wide_stem, index));
+	HOST_CHECK(index.entries.size() == 0xffff / FREQMAN_DESC_MAX_LEN);
+	HOST_CHECK(index.descriptions.size() <= 0xffff);
+	HOST_CHECK(!cached_header(wide_stem).complete);
+	bool descriptions_ok = true;
+	for(const auto& e : index.entries) {
+		descriptions_ok &= (std::string(index.description(e)).compare(0, 7, "Unique ") == 0);
+	}
+	HOST_CHECK(descriptions_ok);
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+	const auto n = host_test::iterations(argc, argv, 20);
+
+	char scratch[] = "/tmp/freqman_test.XXXXXX";
+	if( !mkdtemp(scratch) || (chdir(scratch) != 0) ) {
+		std::printf("can't make a scratch directory\n");
+		return 1;
+	}
+	std::filesystem::create_directory("FREQMAN");
+
+	host_test::Xorshift32 rng;
+	check_lines();
+
+	const std::string large { "LARGE" };
+	const auto model = generate(large, 10000, 300, rng);
+	check_large(large, model);
+	check_cache_reuse(rng);
+	check_interning(rng);
+
+	const auto files = get_freqman_files();
+	HOST_CHECK(std::find(files.begin(), files.end(), large) != files.end());
+
+	std::string stem { large };
+	freqman_db db;
+	freqman_index index;
+	host_test::benchmark("load_freqman_file", n, model.size(), [&]() {
+		load_freqman_file(stem, db, model.size() + 1);
+	});
+	host_test::benchmark("load_freqman_index cold", n, model.size(), [&]() {
+		std::filesystem::remove("FREQMAN/LARGE.IDX");
+		load_freqman_index(stem, index);
+	});
+	host_test::benchmark("load_freqman_index cached", n, model.size(), [&]() {
+		load_freqman_index(stem, index);
+	});
+
+	std::filesystem::current_path("/");
+	std::filesystem::remove_all(scratch);
+
+	return host_test::result();
+}
@@ -0,0 +1,52 @@
+/* Generated by dsp_decimate_bench --generate. */
+
+#ifndef __GOLDEN_DECIMATE_H__
+#define __GOLDEN_DECIMATE_H__
+
+#include "complex.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace golden {
+
+constexpr size_t head_length = 16;
+
+struct Vector {
+	const char* name;
+	size_t count;
+	uint32_t crc;
+	std::array<complex16_t, head_length> head;
+};
+
+const Vector vectors[] = {
+	{ "FIRC8xR16x24FS4Decim8", 2048, 0xabb52cac, { {
+		{ 1327, -1 }, { 3597, 3239 }, { 1673, -2024 }, { -4228, -1795 },
+		{ -2084, -4090 }, { 7129, -3219 }, { 3792, 1803 }, { 9752, -2373 },
+		{ -2984, 628 }, { -6389, 770 }, { 5170, 1902 }, { 8207, -570 },
+		{ 5753, -1615 }, { 4694, 972 }, { -3212, 6578 }, { -5695, -391 }
+	} } },
+	{ "FIRC16xR16x32Decim8", 256, 0xb6a16aba, { {
+		{ -340, 32 }, { 5185, 2655 }, { 6130, -4181 }, { 5445, 2974 },
+		{ -6459, -1751 }, { -1460, -1452 }, { -4526, 2509 }, { -12322, -2926 },
+		{ 1676, -9511 }, { 4774, -654 }, { -1511, -2689 }, { 4450, -9387 },
+		{ 5141, 5893 }, { 8621, 2879 }, { -2570, 7239 }, { 4259, 3457 }
+	} } },
+	{ "FIRAndDecimateComplex", 1024, 0x6bd41c08, { {
+		{ -85, -101 }, { -200, -16 }, { 375, 270 }, { -369, -561 },
+		{ -440, 878 }, { 1708, -668 }, { -3350, -596 }, { 9066, 10035 },
+		{ 20151, 3422 }, { -8905, -3861 }, { 4458, -867 }, { 23643, -7806 },
+		{ -10523, 1042 }, { -2250, -6918 }, { 28092, -15619 }, { 7501, 20421 }
+	} } },
+	{ "DecimateBy2CIC3", 1024, 0x2a1f7b6b, { {
+		{ 7922, 9038 }, { 16125, 2530 }, { -4056, -2193 }, { 4390, -3107 },
+		{ 19772, -4208 }, { -10009, -1517 }, { 5566, -7511 }, { 17506, -11549 },
+		{ 12318, 19003 }, { -6978, 11809 }, { 5553, -6911 }, { -16173, -1747 },
+		{ -9249, 3576 }, { 5137, -3011 }, { -18716, -6990 }, { 12761, -12128 }
+	} } },
+};
+
+} /* namespace golden */
+
+#endif/*__GOLDEN_DECIMATE_H__*/
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Host stand-ins for the parts of the M4 runtime that baseband processors
+ * touch: shared memory, the baseband and RSSI threads, the event loop and
+ * the audio DMA. Nothing here runs a thread; the replay harness calls
+ * BasebandProcessor::execute() itself and collects what the processor
+ * pushes to the application queue and to the audio "DMA" buffers.
+ */
+
+#include "host_baseband.hpp"
+
+#include "event_m4.hpp"
+#include "baseband_profiler.hpp"
+#include "audio_dma.hpp"
+#include "stream_input.hpp"
+#include "portapack_shared_memory.hpp"
+
+static SharedMemory host_shared_memory;
+SharedMemory& shared_memory = host_shared_memory;
+
+void MessageQueue::signal() {
+}
+
+/* Cycle counts are all zero on the host; the harness keeps its own time. */
+BasebandProfiler baseband_profiler;
+
+Thread* BasebandThread::thread = nullptr;
+
+BasebandThread::BasebandThread(
+	uint32_t sampling_rate,
+	BasebandProcessor* const baseband_processor,
+	const tprio_t,
+	baseband::Direction direction
+) : baseband_processor { baseband_processor },
+	_direction { direction },
+	sampling_rate { sampling_rate }
+{
+}
+
+BasebandThread::~BasebandThread() {
+}
+
+void BasebandThread::set_sampling_rate(uint32_t new_sampling_rate) {
+	sampling_rate = new_sampling_rate;
+}
+
+void BasebandThread::run() {
+}
+
+Thread* RSSIThread::thread = nullptr;
+
+RSSIThread::RSSIThread(const tprio_t) {
+}
+
+RSSIThread::~RSSIThread() {
+}
+
+void RSSIThread::run() {
+}
+
+Thread* EventDispatcher::thread_event_loop = nullptr;
+
+/* Each proc_*.cpp main() is renamed and never called, but still links. */
+EventDispatcher::EventDispatcher(
+	std::unique_ptr<BasebandProcessor> baseband_processor
+) : baseband_processor { std::move(baseband_processor) }
+{
+}
+
+void EventDispatcher::run() {
+}
+
+/* Capture streams go nowhere; the M0 side that would drain them isn't here. */
+StreamInput::StreamInput(
+	CaptureConfig* const config
+) : fifo_buffers_empty { buffers_empty.data(), buffer_count_max_log2 },
+	fifo_buffers_full { buffers_full.data(), buffer_count_max_log2 },
+	config { config }
+{
+}
+
+size_t StreamInput::write(const void* const, const size_t length) {
+	return length;
+}
+
+namespace host_baseband {
+
+/* Audio DMA: every buffer the processor asks for is appended to the
+ * recording, so the output is the exact sample stream it produced.
+ */
+static constexpr size_t audio_dma_buffer_samples = 32;
+static std::vector<audio::sample_t> audio_samples;
+
+const std::vector<audio::sample_t>& audio() {
+	return audio_samples;
+}
+
+} /* namespace host_baseband */
+
+namespace audio {
+namespace dma {
+
+audio::buffer_t tx_empty_buffer() {
+	auto& samples = host_baseband::audio_samples;
+	samples.resize(samples.size() + host_baseband::audio_dma_buffer_samples);
+	return { &samples[samples.size() - host_baseband::audio_dma_buffer_samples], host_baseband::audio_dma_buffer_samples };
+}
+
+audio::buffer_t rx_empty_buffer() {
+	static std::array<audio::sample_t, host_baseband::audio_dma_buffer_samples> silence { };
+	return { silence.data(), silence.size() };
+}
+
+} /* namespace dma */
+} /* namespace audio */
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Force-included ahead of freqman.cpp so it can be built on the host.
+ * freqman.hpp pulls in the receiver UI, the log file and string_format.hpp,
+ * which drag in the LPC43xx registers; this defines their include guards
+ * and supplies the little freqman.cpp uses from them instead. File comes
+ * from stub/file.hpp, on stdio.
+ */
+
+#ifndef __HOST_FREQMAN_H__
+#define __HOST_FREQMAN_H__
+
+#include "file.hpp"
+#include "rf_path.hpp"
+
+#include <cstdint>
+#include <string>
+
+#define __UI_RECEIVER_H__
+#define __LOG_FILE_H__
+#define __STRING_FORMAT_H__
+
+namespace ui { }
+
+inline std::string to_string_dec_uint(const uint32_t n, const int32_t l = 0, const char fill = ' ') {
+	auto s = std::to_string(n);
+	if( (int32_t)s.size() < l ) {
+		s.insert(0, l - s.size(), fill ? fill : ' ');
+	}
+	return s;
+}
+
+inline std::string to_string_short_freq(const uint64_t f) {
+	return std::to_string(f / 1000000) + "." + to_string_dec_uint((f / 100) % 10000, 4, '0');
+}
+
+#endif/*__HOST_FREQMAN_H__*/
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Stands in for portapack_io.hpp (same include guard) so lcd_ili9341.cpp can
+ * be built on the host: a model of the ILI9341 RAM interface instead of the
+ * parallel bus. Column/page address set and memory write behave as on the
+ * panel; writes outside the screen are dropped. Force-included ahead of
+ * lcd_ili9341.cpp, which would otherwise find the real header next to it.
+ */
+
+#ifndef __PORTAPACK_IO_H__
+#define __PORTAPACK_IO_H__
+
+#include "ui.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <initializer_list>
+
+namespace portapack {
+
+class IO {
+public:
+	static constexpr size_t width = 240;
+	static constexpr size_t height = 320;
+
+	std::array<uint16_t, width * height> framebuffer { };
+	size_t ram_writes { 0 };		// Memory write commands (0x2c) received
+
+	void lcd_reset_state(const bool) { }
+
+	void lcd_data_write_command_and_data(
+		const uint_fast8_t command,
+		const uint8_t* data,
+		const size_t data_count
+	) {
+		switch(command) {
+		case 0x2a:
+			column_start = (data[0] << 8) | data[1];
+			column_end = (data[2] << 8) | data[3];
+			break;
+
+		case 0x2b:
+			page_start = (data[0] << 8) | data[1];
+			page_end = (data[2] << 8) | data[3];
+			break;
+
+		case 0x2c:
+			column = column_start;
+			page = page_start;
+			ram_writes++;
+			break;
+
+		default:
+			break;
+		}
+		(void)data_count;
+	}
+
+	void lcd_data_write_command_and_data(
+		const uint_fast8_t command,
+		const std::initializer_list<uint8_t>& data
+	) {
+		lcd_data_write_command_and_data(command, data.begin(), data.size());
+	}
+
+	void lcd_write_pixel(const ui::Color pixel) {
+		write(pixel.v);
+	}
+
+	void lcd_write_pixels(const ui::Color pixel, size_t n) {
+		while(n--) {
+			write(pixel.v);
+		}
+	}
+
+	void lcd_write_pixels_unrolled8(const ui::Color pixel, size_t n) {
+		lcd_write_pixels(pixel, n * 8);
+	}
+
+	void lcd_write_pixels(const ui::Color* const pixels, size_t n) {
+		for(size_t i=0; i<n; i++) {
+			write(pixels[i].v);
+		}
+	}
+
+	uint32_t lcd_read_word() {
+		return 0;
+	}
+
+	void lcd_read_bytes(uint8_t* byte, size_t byte_count) {
+		std::memset(byte, 0, byte_count);
+	}
+
+private:
+	uint32_t column_start { 0 };
+	uint32_t column_end { width - 1 };
+	uint32_t page_start { 0 };
+	uint32_t page_end { height - 1 };
+	uint32_t column { 0 };
+	uint32_t page { 0 };
+
+	void write(const uint16_t v) {
+		if( (column < width) && (page < height) ) {
+			framebuffer[page * width + column] = v;
+		}
+		if( ++column > column_end ) {
+			column = column_start;
+			if( ++page > page_end ) {
+				page = page_start;
+			}
+		}
+	}
+};
+
+extern IO io;
+
+} /* namespace portapack */
+
+#endif/*__PORTAPACK_IO_H__*/
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __HOST_TEST_H__
+#define __HOST_TEST_H__
+
+/* Small helpers shared by the host checks and benchmarks: a deterministic
+ * input generator, a failure counter and a timer that reports throughput
+ * and, on x86, cycles per item from the time-stamp counter.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace host_test {
+
+inline int& failures() {
+	static int count = 0;
+	return count;
+}
+
+#define HOST_CHECK(cond) \
+	do { \
+		if( !(cond) ) { \
+			std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+			host_test::failures()++; \
+		} \
+	} while(0)
+
+inline int result() {
+	if( failures() ) {
+		std::printf("%d check(s) failed\n", failures());
+		return 1;
+	}
+	std::printf("all checks passed\n");
+	return 0;
+}
+
+/* Iteration count from argv[1], so ctest can run a short pass. */
+inline size_t iterations(int argc, char** argv, const size_t default_count) {
+	return (argc > 1) ? std::strtoul(argv[1], nullptr, 0) : default_count;
+}
+
+class Xorshift32 {
+public:
+	explicit Xorshift32(const uint32_t seed = 0x12345678) : state { seed } { }
+
+	uint32_t operator()() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+private:
+	uint32_t state;
+};
+
+inline uint64_t cycle_counter() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/* Runs fn() `iterations` times, each processing `items` items, and prints
+ * items/s, ns/item and (where available) host cycles/item.
+ */
+template<typename F>
+double benchmark(const char* const name, const size_t iterations, const size_t items, F fn) {
+	const auto t0 = std::chrono::steady_clock::now();
+	const auto c0 = cycle_counter();
+	for(size_t i=0; i<iterations; i++) {
+		fn();
+	}
+	const auto c1 = cycle_counter();
+	const auto t1 = std::chrono::steady_clock::now();
+
+	const double seconds = std::chrono::duration<double>(t1 - t0).count();
+	const double total = double(iterations) * items;
+	const double rate = (seconds > 0) ? (total / seconds) : 0;
+	std::printf("%-32s %12.0f items/s %8.2f ns/item", name, rate, (total > 0) ? (seconds * 1e9 / total) : 0);
+	if( c1 != c0 ) {
+		std::printf(" %8.2f cycles/item", double(c1 - c0) / total);
+	}
+	std::printf("\n");
+	return rate;
+}
+
+} /* namespace host_test */
+
+#endif/*__HOST_TEST_H__*/
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Checks ILI9341::draw_glyph_run pixel for pixel against the glyphs drawn one
+ * bit at a time: the 8x16 font (whole-byte expansion), made-up fonts whose
+ * rows don't end on a byte (bit-pair expansion), an odd width (glyph by glyph)
+ * and runs that are longer than the line buffer or run off the right edge;
+ * also the pixels_written() count behind Painter::frame_pixels(). Then times
+ * a line of text against drawing it glyph by glyph.
+ *
+ * Usage: lcd_glyph_test [iterations]
+ */
+
+#include "lcd_ili9341.hpp"
+#include "ui_font_fixed_8x16.hpp"
+
+#include "host_lcd.hpp"
+#include "host_test.hpp"
+
+#include <string>
+#include <vector>
+
+namespace portapack {
+
+IO io { };
+
+} /* namespace portapack */
+
+namespace {
+
+using portapack::io;
+using Framebuffer = decltype(io.framebuffer);
+
+constexpr ui::Color foreground { 0xf81f };
+constexpr ui::Color background { 0x07e0 };
+constexpr uint16_t untouched = 0x1234;
+
+lcd::ILI9341 display;
+
+/* A font of random glyphs, for the widths the firmware doesn't have. */
+class RandomFont {
+public:
+	RandomFont(
+		const ui::Dim w,
+		const ui::Dim h,
+		host_test::Xorshift32& rng
+	) : data((((w * h) + 7) / 8) * glyph_count),
+		font { w, h, data.data(), ' ', glyph_count }
+	{
+		for(auto& b : data) {
+			b = rng();
+		}
+	}
+
+	const ui::Font& operator*() const {
+		return font;
+	}
+
+private:
+	static constexpr size_t glyph_count = 95;
+
+	std::vector<uint8_t> data;
+	const ui::Font font;
+};
+
+/* Glyphs one pixel at a time: pixel n of a glyph is bit (n & 7) of byte n / 8. */
+int reference_draw(Framebuffer& fb, const ui::Point p, const ui::Font& font, const std::string& text) {
+	int x = p.x();
+	for(const auto c : text) {
+		const auto glyph = font.glyph(c);
+		for(int y=0; y<glyph.h(); y++) {
+			for(int gx=0; gx<glyph.w(); gx++) {
+				const size_t n = (y * glyph.w()) + gx;
+				const bool set = glyph.pixels()[n >> 3] & (1U << (n & 7));
+				const size_t px = x + gx;
+				const size_t py = p.y() + y;
+				if( (px < io.width) && (py < io.height) ) {
+					fb[py * io.width + px] = set ? foreground.v : background.v;
+				}
+			}
+		}
+		x += glyph.advance().x();
+	}
+	return x - p.x();
+}
+
+std::string random_text(host_test::Xorshift32& rng, const size_t length) {
+	std::string text;
+	for(size_t i=0; i<length; i++) {
+		text += static_cast<char>(' ' + (rng() % 95));
+	}
+	return text;
+}
+
+void check_font(const ui::Font& font, host_test::Xorshift32& rng) {
+	const auto w = font.glyph(' ').w();
+	const bool single_window = (w >= 4) && !(w & 1);
+
+	const std::vector<ui::Point> positions {
+		{ 0, 0 }, { 13, 37 }, { 1, 320 - 16 }, { 240 - (w * 7) / 2, 100 }, { 239, 200 }
+	};
+
+	size_t mismatches = 0;
+	size_t width_errors = 0;
+	size_t window_errors = 0;
+	for(const auto p : positions) {
+		for(const size_t length : { 1, 2, 7, 29, 61, 80 }) {
+			const auto text = random_text(rng, length);
+
+			Framebuffer expected;
+			expected.fill(untouched);
+			const auto expected_width = reference_draw(expected, p, font, text);
+
+			io.framebuffer.fill(untouched);
+			io.ram_writes = 0;
+			const auto width = display.draw_glyph_run(p, font, text.data(), text.size(), foreground, background);
+
+			if( io.framebuffer != expected ) {
+				mismatches++;
+			}
+			if( width != expected_width ) {
+				width_errors++;
+			}
+			// A run that fits on screen goes out through one RAM window
+			const bool fits = (p.x() + (w * length) <= io.width) && (length <= 60);
+			if( single_window && fits && (io.ram_writes != 1) ) {
+				window_errors++;
+			}
+		}
+	}
+	HOST_CHECK(mismatches == 0);
+	HOST_CHECK(width_errors == 0);
+	HOST_CHECK(window_errors == 0);
+
+	io.ram_writes = 0;
+	HOST_CHECK(display.draw_glyph_run({ 0, 0 }, font, "", 0, foreground, background) == 0);
+	HOST_CHECK(io.ram_writes == 0);
+
+	// Every pixel of an on-screen run is counted once, however it's windowed
+	const auto pixels_start = display.pixels_written();
+	const auto width = display.draw_glyph_run({ 8, 8 }, font, "Counted", 7, foreground, background);
+	HOST_CHECK((display.pixels_written() - pixels_start) == uint32_t(width * font.line_height()));
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+	const auto n = host_test::iterations(argc, argv, 20000);
+
+	host_test::Xorshift32 rng;
+	check_font(ui::font::fixed_8x16, rng);
+	for(const auto size : { ui::Size { 4, 7 }, ui::Size { 6, 10 }, ui::Size { 10, 12 }, ui::Size { 5, 8 } }) {
+		const RandomFont font { size.width(), size.height(), rng };
+		check_font(*font, rng);
+	}
+
+	const std::string line = "ICAO 3C6586  FL350  452kt";
+	const auto& font = ui::font::fixed_8x16;
+
+	host_test::benchmark("draw_glyph x25 (8x16)", n, line.size(), [&]() {
+		ui::Point p { 0, 0 };
+		for(const auto c : line) {
+			const auto glyph = font.glyph(c);
+			display.draw_glyph(p, glyph, foreground, background);
+			p += glyph.advance();
+		}
+	});
+	host_test::benchmark("draw_glyph_run x25 (8x16)", n, line.size(), [&]() {
+		display.draw_glyph_run({ 0, 0 }, font, line.data(), line.size(), foreground, background);
+	});
+
+	return host_test::result();
+}
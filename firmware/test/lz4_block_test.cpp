@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Round-trips images through the Python encoder and the firmware decoder:
+ * each input is written out, packed by tools/make_image_chunk.py --compress
+ * as the build does, and the chunk decoded with lz4::decompress_block as
+ * core_control.cpp does. Inputs cover runs (overlapping matches, long
+ * lengths), far matches, incompressible data, tiny images and real code.
+ * Truncated and corrupted blocks must be rejected without going out of
+ * bounds. Then times decompression of the code image, in output bytes.
+ *
+ * Usage: lz4_block_test <iterations> <python> <make_image_chunk.py>
+ */
+
+#include "lz4_block.hpp"
+
+#include "host_test.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using bytes_t = std::vector<uint8_t>;
+
+constexpr uint32_t chunk_compressed_flag = 0x80000000;
+
+struct Chunk {
+	bool compressed { false };
+	uint32_t original_length { 0 };
+	bytes_t data { };
+};
+
+uint32_t read_u32(const uint8_t* const p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+}
+
+bool write_file(const std::string& path, const bytes_t& data) {
+	std::ofstream f { path, std::ios::binary };
+	f.write(reinterpret_cast<const char*>(data.data()), data.size());
+	return static_cast<bool>(f);
+}
+
+bytes_t read_file(const std::string& path) {
+	std::ifstream f { path, std::ios::binary };
+	return { std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>() };
+}
+
+/* Packs the image as "TEST", the way the firmware build packs baseband images. */
+bool make_chunk(const std::string& python, const std::string& script, const bytes_t& image, Chunk& chunk) {
+	if( !write_file("lz4_input.bin", image) ) {
+		return false;
+	}
+	const auto command = python + " " + script + " lz4_input.bin TEST lz4_chunk.bin " +
+		std::to_string(image.size()) + " --compress > /dev/null";
+	if( std::system(command.c_str()) != 0 ) {
+		return false;
+	}
+
+	const auto file = read_file("lz4_chunk.bin");
+	if( (file.size() < 8) || (std::memcmp(file.data(), "TEST", 4) != 0) ) {
+		return false;
+	}
+	const auto length = read_u32(&file[4]);
+	chunk.compressed = length & chunk_compressed_flag;
+	const size_t stored_length = length & ~chunk_compressed_flag;
+	if( file.size() != 8 + stored_length ) {
+		return false;
+	}
+
+	if( chunk.compressed ) {
+		chunk.original_length = read_u32(&file[8]);
+		const auto compressed_length = read_u32(&file[12]);
+		if( compressed_length > stored_length - 8 ) {
+			return false;
+		}
+		chunk.data.assign(&file[16], &file[16 + compressed_length]);
+	} else {
+		chunk.original_length = stored_length;
+		chunk.data.assign(&file[8], &file[8 + stored_length]);
+	}
+	return true;
+}
+
+size_t decode(const bytes_t& block, bytes_t& out) {
+	return lz4::decompress_block(block.data(), block.size(), out.data(), out.size());
+}
+
+bytes_t self_image(const char* const path, const size_t max_size) {
+	auto image = read_file(path);
+	image.resize(std::min(image.size(), max_size) & ~size_t(3));
+	return image;
+}
+
+struct Case {
+	std::string name;
+	bytes_t image;
+	bool compressible;
+};
+
+std::vector<Case> make_cases(const char* const exe, host_test::Xorshift32& rng) {
+	std::vector<Case> cases;
+
+	cases.push_back({ "zeros", bytes_t(20000, 0), true });
+
+	bytes_t random(8192);
+	for(auto& b : random) {
+		b = rng();
+	}
+	cases.push_back({ "random", random, false });
+
+	// Short repeats at every distance up to 64KB, and one right at the limit
+	bytes_t far(65536 + 4096);
+	for(auto& b : far) {
+		b = rng();
+	}
+	std::memcpy(&far[65535], &far[0], 1024);
+	for(size_t n=1024; n+64<far.size(); n+=997) {
+		std::memcpy(&far[n + 32], &far[(n * 7919) % (n - 16)], 16);
+	}
+	cases.push_back({ "far matches", far, true });
+
+	// Literal runs over 15 and over 255 between matches
+	bytes_t mixed;
+	for(size_t n=0; n<200; n++) {
+		const size_t literals = (n * 37) % 600;
+		for(size_t i=0; i<literals; i++) {
+			mixed.push_back(rng());
+		}
+		const size_t run = 4 + (n * 13) % 300;
+		mixed.insert(mixed.end(), run, uint8_t(n));
+	}
+	mixed.resize(mixed.size() & ~size_t(3));
+	cases.push_back({ "mixed", mixed, true });
+
+	// Too short for any match, or for the header to pay off
+	for(const size_t size : { 4, 8, 12, 16, 20, 32 }) {
+		cases.push_back({ "tiny " + std::to_string(size), bytes_t(size, 0x55), size >= 32 });
+	}
+
+	cases.push_back({ "host code", self_image(exe, 65536), true });
+	return cases;
+}
+
+void check_malformed(const bytes_t& block, const size_t original_length, host_test::Xorshift32& rng) {
+	bytes_t out(original_length);
+
+	// Cut short anywhere but at a sequence boundary, or into a smaller buffer
+	size_t accepted = 0;
+	for(size_t n=0; n<block.size(); n++) {
+		const bytes_t truncated { block.begin(), block.begin() + n };
+		if( decode(truncated, out) == original_length ) {
+			accepted++;
+		}
+	}
+	HOST_CHECK(accepted == 0);
+
+	bytes_t small(original_length - 1);
+	HOST_CHECK(lz4::decompress_block(block.data(), block.size(), small.data(), small.size()) == 0);
+
+	// Random corruption must never write past the buffer, guarded by a canary
+	for(size_t n=0; n<2000; n++) {
+		auto corrupted = block;
+		for(size_t i=0; i<4; i++) {
+			corrupted[rng() % corrupted.size()] = rng();
+		}
+		bytes_t guarded(original_length + 64, 0xa5);
+		const auto length = lz4::decompress_block(corrupted.data(), corrupted.size(), guarded.data(), original_length);
+		HOST_CHECK(length <= original_length);
+		HOST_CHECK(std::all_of(guarded.begin() + original_length, guarded.end(), [](const uint8_t b) { return b == 0xa5; }));
+	}
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+	if( argc < 4 ) {
+		std::fprintf(stderr, "usage: %s <iterations> <python> <make_image_chunk.py>\n", argv[0]);
+		return 2;
+	}
+	const auto n = host_test::iterations(argc, argv, 1000);
+	const std::string python = argv[2];
+	const std::string script = argv[3];
+
+	host_test::Xorshift32 rng;
+	Chunk code_chunk;
+	size_t code_length = 0;
+
+	for(const auto& c : make_cases(argv[0], rng)) {
+		Chunk chunk;
+		const bool packed = make_chunk(python, script, c.image, chunk);
+		HOST_CHECK(packed);
+		if( !packed ) {
+			continue;
+		}
+		std::printf("%-12s %6zu -> %6zu bytes%s\n", c.name.c_str(), c.image.size(), chunk.data.size(),
+			chunk.compressed ? "" : " (stored)");
+
+		HOST_CHECK(chunk.compressed == c.compressible);
+		HOST_CHECK(chunk.original_length == c.image.size());
+		if( !chunk.compressed ) {
+			HOST_CHECK(chunk.data == c.image);
+			continue;
+		}
+
+		bytes_t out(chunk.original_length);
+		HOST_CHECK(decode(chunk.data, out) == c.image.size());
+		HOST_CHECK(out == c.image);
+		check_malformed(chunk.data, chunk.original_length, rng);
+
+		if( c.name == "host code" ) {
+			code_chunk = chunk;
+			code_length = c.image.size();
+		}
+	}
+
+	if( code_length ) {
+		bytes_t out(code_length);
+		volatile size_t sink = 0;
+		host_test::benchmark("decompress_block (host code)", n, code_length, [&]() {
+			sink = sink + decode(code_chunk.data, out);
+		});
+	}
+
+	return host_test::result();
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Compares MatchedFilterQ15 with the float MatchedFilter it replaced, on
+ * synthetic continuous-phase 2-FSK at the AIS (38.4k, 4 taps, /2) and TPMS
+ * (307.2k, 16 taps, /8) settings, from clean to noisy and up to full scale:
+ * outputs must track the float filter and the bit error rate from slicing
+ * them must not get worse. Then times execute_once() for both.
+ *
+ * Usage: matched_filter_test [iterations]
+ */
+
+#include "matched_filter.hpp"
+#include "ais_baseband.hpp"
+
+#include "host_test.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+using namespace dsp::matched_filter;
+
+struct Setting {
+	const char* const name;
+	const std::complex<float>* const taps;
+	const size_t taps_count;
+	const size_t decimation;
+	const float sampling_rate;
+	const float deviation;
+	const size_t samples_per_symbol;
+};
+
+struct Signal {
+	std::vector<uint8_t> bits;
+	std::vector<complex16_t> samples;
+};
+
+float gaussian(host_test::Xorshift32& rng) {
+	const float u1 = (rng() + 1.0f) / 4294967296.0f;
+	const float u2 = rng() / 4294967296.0f;
+	return std::sqrt(-2.0f * std::log(u1)) * std::cos(2.0f * float(M_PI) * u2);
+}
+
+int16_t saturate(const float v) {
+	return static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, std::round(v))));
+}
+
+/* Random bits, one tone per bit, with noise of the given SNR (per sample). */
+Signal make_signal(const Setting& s, const float amplitude, const float snr_db, const size_t bit_count, host_test::Xorshift32& rng) {
+	Signal signal;
+	const float sigma = amplitude / std::sqrt(2.0f * std::pow(10.0f, snr_db / 10.0f));
+	float phase = 0;
+	for(size_t n=0; n<bit_count; n++) {
+		const uint8_t bit = rng() & 1;
+		signal.bits.push_back(bit);
+		const float step = 2.0f * float(M_PI) * (bit ? s.deviation : -s.deviation) / s.sampling_rate;
+		for(size_t i=0; i<s.samples_per_symbol; i++) {
+			phase = std::fmod(phase + step, 2.0f * float(M_PI));
+			signal.samples.push_back({
+				saturate(amplitude * std::cos(phase) + sigma * gaussian(rng)),
+				saturate(amplitude * std::sin(phase) + sigma * gaussian(rng))
+			});
+		}
+	}
+	return signal;
+}
+
+struct Outputs {
+	std::vector<float> reference;
+	std::vector<float> q15;
+};
+
+Outputs run(const Setting& s, const Signal& signal) {
+	std::vector<std::complex<float>> taps { s.taps, s.taps + s.taps_count };
+	MatchedFilter reference { taps, s.decimation };
+	MatchedFilterQ15 q15 { taps, s.decimation };
+
+	Outputs out;
+	for(const auto sample : signal.samples) {
+		const bool ready_reference = reference.execute_once({ float(sample.real()), float(sample.imag()) });
+		const bool ready_q15 = q15.execute_once(sample);
+		HOST_CHECK(ready_reference == ready_q15);
+		if( ready_reference ) {
+			out.reference.push_back(reference.get_output());
+			out.q15.push_back(q15.get_output());
+		}
+	}
+	return out;
+}
+
+/* Slices one output per symbol. The phase is whichever gives the float
+ * filter its fewest errors, the Q15 filter is sliced at the same one.
+ */
+struct Slicer {
+	size_t step;
+	size_t phase { 0 };
+	bool inverted { false };
+
+	size_t errors(const std::vector<float>& outputs, const std::vector<uint8_t>& bits) const {
+		size_t count = 0;
+		for(size_t n=1; n<bits.size(); n++) {
+			const auto i = (n * step) + phase;
+			if( i >= outputs.size() ) {
+				break;
+			}
+			if( ((outputs[i] > 0) != inverted) != bool(bits[n]) ) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+	void train(const std::vector<float>& outputs, const std::vector<uint8_t>& bits) {
+		size_t best = bits.size();
+		for(size_t p=0; p<step * 2; p++) {
+			for(const bool inv : { false, true }) {
+				const Slicer candidate { step, p, inv };
+				const auto e = candidate.errors(outputs, bits);
+				if( e < best ) {
+					best = e;
+					*this = candidate;
+				}
+			}
+		}
+	}
+};
+
+void compare(const Setting& s, host_test::Xorshift32& rng) {
+	constexpr size_t bit_count = 20000;
+	const size_t outputs_per_symbol = s.samples_per_symbol / s.decimation;
+
+	std::printf("%s: SNR dB, amplitude, float BER, Q15 BER, max |error| / peak output\n", s.name);
+	for(const float amplitude : { 2000.0f, 30000.0f }) {
+		for(const float snr_db : { 20.0f, 6.0f, 0.0f, -3.0f }) {
+			const auto signal = make_signal(s, amplitude, snr_db, bit_count, rng);
+			const auto out = run(s, signal);
+
+			float error_max = 0;
+			float reference_max = 0;
+			for(size_t i=0; i<out.reference.size(); i++) {
+				error_max = std::max(error_max, std::abs(out.q15[i] - out.reference[i]));
+				reference_max = std::max(reference_max, std::abs(out.reference[i]));
+			}
+			const float relative_error = error_max / reference_max;
+
+			Slicer slicer { outputs_per_symbol };
+			slicer.train(out.reference, signal.bits);
+			const auto ber_reference = double(slicer.errors(out.reference, signal.bits)) / bit_count;
+			const auto ber_q15 = double(slicer.errors(out.q15, signal.bits)) / bit_count;
+
+			std::printf("  %5.1f %6.0f  %.5f  %.5f  %.2e\n", snr_db, amplitude, ber_reference, ber_q15, relative_error);
+
+			// Quantization noise is far below the channel noise: a handful
+			// of decisions near zero may flip, the error rate stays put.
+			HOST_CHECK(relative_error < 1e-3f);
+			HOST_CHECK(ber_q15 <= ber_reference * 1.02 + 0.0005);
+			if( snr_db >= 20.0f ) {
+				HOST_CHECK(ber_reference == 0);
+				HOST_CHECK(ber_q15 == 0);
+			}
+		}
+	}
+}
+
+void bench(const Setting& s, const size_t iterations, host_test::Xorshift32& rng) {
+	const auto signal = make_signal(s, 8000.0f, 10.0f, 256, rng);
+	std::vector<std::complex<float>> samples_float;
+	for(const auto sample : signal.samples) {
+		samples_float.push_back({ float(sample.real()), float(sample.imag()) });
+	}
+	std::vector<std::complex<float>> taps { s.taps, s.taps + s.taps_count };
+
+	MatchedFilter reference { taps, s.decimation };
+	MatchedFilterQ15 q15 { taps, s.decimation };
+	volatile float sink = 0;
+
+	char name[48];
+	std::snprintf(name, sizeof(name), "MatchedFilter %s", s.name);
+	host_test::benchmark(name, iterations, samples_float.size(), [&]() {
+		for(const auto sample : samples_float) {
+			if( reference.execute_once(sample) ) {
+				sink = reference.get_output();
+			}
+		}
+	});
+
+	std::snprintf(name, sizeof(name), "MatchedFilterQ15 %s", s.name);
+	host_test::benchmark(name, iterations, signal.samples.size(), [&]() {
+		for(const auto sample : signal.samples) {
+			if( q15.execute_once(sample) ) {
+				sink = q15.get_output();
+			}
+		}
+	});
+}
+
+/* rect_taps_307k2_38k4_1t_19k2_p from proc_tpms.hpp, which doesn't build on
+ * the host: one symbol of the +38.4 kHz tone, gain 1.
+ */
+std::array<std::complex<float>, 16> tpms_taps() {
+	std::array<std::complex<float>, 16> taps;
+	for(size_t k=0; k<taps.size(); k++) {
+		taps[k] = std::polar(1.0f / taps.size(), 2.0f * float(M_PI) * 38400.0f * k / 307200.0f);
+	}
+	return taps;
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+	const auto n = host_test::iterations(argc, argv, 2000);
+	const auto tpms = tpms_taps();
+
+	const Setting settings[] = {
+		{ "AIS", baseband::ais::square_taps_38k4_1t_p.data(), baseband::ais::square_taps_38k4_1t_p.size(), 2, 38400, 2400, 4 },
+		{ "TPMS", tpms.data(), tpms.size(), 8, 307200, 38400, 16 },
+	};
+
+	host_test::Xorshift32 rng;
+	for(const auto& s : settings) {
+		compare(s, rng);
+	}
+	for(const auto& s : settings) {
+		bench(s, n, rng);
+	}
+
+	return host_test::result();
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Writes screen captures with PNGWriter and reads them back with zlib:
+ * chunk layout and CRCs, IHDR, IDAT sizes, the zlib stream (inflate checks
+ * the Adler-32), filter bytes and every pixel. Captures are flat fills,
+ * text-like glyph rows, a gradient, noise (nothing to match) and, when
+ * given, a real screenshot. Then times a capture.
+ *
+ * Usage: png_writer_test [iterations] [240x320 RGB screenshot.png]
+ */
+
+#include "png_writer.hpp"
+
+#include "host_test.hpp"
+
+#include <zlib.h>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t width = 240;
+constexpr size_t height = 320;
+constexpr size_t row_bytes = width * 3;
+
+using Screen = std::vector<std::array<ui::ColorRGB888, width>>;
+using bytes_t = std::vector<uint8_t>;
+
+uint32_t read_u32be(const uint8_t* const p) {
+	return (uint32_t(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+bytes_t read_file(const std::string& path) {
+	std::ifstream f { path, std::ios::binary };
+	return { std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>() };
+}
+
+struct Chunk {
+	std::string type;
+	bytes_t data;
+};
+
+/* Splits a PNG into chunks, checking the signature and every CRC. */
+bool read_chunks(const bytes_t& png, std::vector<Chunk>& chunks) {
+	static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	if( (png.size() < 8) || std::memcmp(png.data(), signature, 8) ) {
+		return false;
+	}
+	size_t p = 8;
+	while( p + 12 <= png.size() ) {
+		const auto length = read_u32be(&png[p]);
+		if( p + 12 + length > png.size() ) {
+			return false;
+		}
+		const auto crc = crc32(crc32(0, nullptr, 0), &png[p + 4], 4 + length);
+		if( crc != read_u32be(&png[p + 8 + length]) ) {
+			return false;
+		}
+		chunks.push_back({ std::string(reinterpret_cast<const char*>(&png[p + 4]), 4), bytes_t(&png[p + 8], &png[p + 8 + length]) });
+		p += 12 + length;
+	}
+	return p == png.size();
+}
+
+bool inflate_all(const bytes_t& in, bytes_t& out) {
+	z_stream z { };
+	if( inflateInit(&z) != Z_OK ) {
+		return false;
+	}
+	z.next_in = const_cast<Bytef*>(in.data());
+	z.avail_in = in.size();
+	z.next_out = out.data();
+	z.avail_out = out.size();
+	const auto result = inflate(&z, Z_FINISH);
+	const bool complete = (result == Z_STREAM_END) && (z.avail_out == 0) && (z.avail_in == 0);
+	inflateEnd(&z);
+	return complete;
+}
+
+uint8_t paeth(const int a, const int b, const int c) {
+	const int p = a + b - c;
+	const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+	return ((pa <= pb) && (pa <= pc)) ? a : ((pb <= pc) ? b : c);
+}
+
+/* Any 240x320 8-bit RGB PNG, all five filter types, to a screen. */
+bool decode(const bytes_t& png, Screen& screen, size_t* const idat_count = nullptr, size_t* const idat_max = nullptr) {
+	std::vector<Chunk> chunks;
+	if( !read_chunks(png, chunks) || chunks.empty() ) {
+		return false;
+	}
+
+	const auto& ihdr = chunks.front();
+	if( (ihdr.type != "IHDR") || (ihdr.data.size() != 13) ) {
+		return false;
+	}
+	const uint8_t rgb8[5] = { 8, 2, 0, 0, 0 };
+	if( (read_u32be(&ihdr.data[0]) != width) || (read_u32be(&ihdr.data[4]) != height) || std::memcmp(&ihdr.data[8], rgb8, 5) ) {
+		return false;
+	}
+	if( chunks.back().type != "IEND" ) {
+		return false;
+	}
+
+	bytes_t stream;
+	size_t count = 0, largest = 0;
+	for(const auto& chunk : chunks) {
+		if( chunk.type == "IDAT" ) {
+			stream.insert(stream.end(), chunk.data.begin(), chunk.data.end());
+			count++;
+			largest = std::max(largest, chunk.data.size());
+		}
+	}
+	if( idat_count ) *idat_count = count;
+	if( idat_max ) *idat_max = largest;
+
+	bytes_t raw(height * (1 + row_bytes));
+	if( !inflate_all(stream, raw) ) {
+		return false;
+	}
+
+	bytes_t previous(row_bytes, 0);
+	screen.resize(height);
+	for(size_t y=0; y<height; y++) {
+		const uint8_t filter = raw[y * (1 + row_bytes)];
+		uint8_t* const row = &raw[y * (1 + row_bytes) + 1];
+		for(size_t i=0; i<row_bytes; i++) {
+			const int a = (i >= 3) ? row[i - 3] : 0;
+			const int b = previous[i];
+			const int c = (i >= 3) ? previous[i - 3] : 0;
+			switch(filter) {
+			case 0:	break;
+			case 1: row[i] += a; break;
+			case 2: row[i] += b; break;
+			case 3: row[i] += (a + b) / 2; break;
+			case 4: row[i] += paeth(a, b, c); break;
+			default: return false;
+			}
+		}
+		std::memcpy(screen[y].data(), row, row_bytes);
+		std::memcpy(previous.data(), row, row_bytes);
+	}
+	return true;
+}
+
+bytes_t encode(const Screen& screen) {
+	const std::string path = "png_writer_test.png";
+	{
+		PNGWriter png;
+		if( png.create(path).is_valid() ) {
+			return { };
+		}
+		for(const auto& row : screen) {
+			png.write_scanline(row);
+		}
+	}
+	return read_file(path);
+}
+
+bool same(const Screen& a, const Screen& b) {
+	for(size_t y=0; y<height; y++) {
+		if( std::memcmp(a[y].data(), b[y].data(), row_bytes) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+Screen flat_screen() {
+	Screen screen(height);
+	for(size_t y=0; y<height; y++) {
+		for(size_t x=0; x<width; x++) {
+			screen[y][x] = (y < 16) ? ui::ColorRGB888 { 0x20, 0x20, 0x20 } : ui::ColorRGB888 { 0, 0, 0 };
+		}
+	}
+	return screen;
+}
+
+/* Rows of 8x16 "glyphs" of random bits over a background, like menus. */
+Screen text_screen(host_test::Xorshift32& rng) {
+	Screen screen(height);
+	std::array<uint8_t, 16 * 95> glyphs;
+	for(auto& g : glyphs) {
+		g = rng();
+	}
+	for(size_t line=0; line<height/16; line++) {
+		std::array<uint8_t, width / 8> text;
+		for(auto& c : text) {
+			c = ((rng() % 4) == 0) ? 0 : (rng() % 95);
+		}
+		const ui::ColorRGB888 fg = (line & 1) ? ui::ColorRGB888 { 255, 255, 255 } : ui::ColorRGB888 { 0, 255, 0 };
+		for(size_t gy=0; gy<16; gy++) {
+			auto& row = screen[line * 16 + gy];
+			for(size_t x=0; x<width; x++) {
+				const bool set = text[x / 8] && ((glyphs[text[x / 8] * 16 + gy] >> (x & 7)) & 1);
+				row[x] = set ? fg : ui::ColorRGB888 { 0, 0, 0x40 };
+			}
+		}
+	}
+	return screen;
+}
+
+Screen gradient_screen() {
+	Screen screen(height);
+	for(size_t y=0; y<height; y++) {
+		for(size_t x=0; x<width; x++) {
+			screen[y][x] = { uint8_t(x), uint8_t(y), uint8_t(x + y) };
+		}
+	}
+	return screen;
+}
+
+Screen noise_screen(host_test::Xorshift32& rng) {
+	Screen screen(height);
+	for(auto& row : screen) {
+		for(auto& p : row) {
+			const auto r = rng();
+			p = { uint8_t(r), uint8_t(r >> 8), uint8_t(r >> 16) };
+		}
+	}
+	return screen;
+}
+
+void check(const char* const name, const Screen& screen) {
+	const auto png = encode(screen);
+	HOST_CHECK(!png.empty());
+
+	Screen decoded;
+	size_t idat_count = 0, idat_max = 0;
+	const bool valid = decode(png, decoded, &idat_count, &idat_max);
+	HOST_CHECK(valid);
+	HOST_CHECK(valid && same(screen, decoded));
+	HOST_CHECK(idat_max <= 4096);
+
+	// What zlib's default level makes of the same rows, for comparison
+	bytes_t raw;
+	for(const auto& row : screen) {
+		raw.push_back(0);
+		raw.insert(raw.end(), reinterpret_cast<const uint8_t*>(row.data()), reinterpret_cast<const uint8_t*>(row.data()) + row_bytes);
+	}
+	uLongf zlib_size = compressBound(raw.size());
+	bytes_t zlib_out(zlib_size);
+	compress2(zlib_out.data(), &zlib_size, raw.data(), raw.size(), Z_DEFAULT_COMPRESSION);
+
+	std::printf("%-12s %7zu bytes in %2zu IDAT chunks (zlib -6: %7lu)\n", name, png.size(), idat_count, zlib_size);
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+	const auto n = host_test::iterations(argc, argv, 20);
+
+	host_test::Xorshift32 rng;
+	check("flat", flat_screen());
+	check("text", text_screen(rng));
+	check("gradient", gradient_screen());
+	check("noise", noise_screen(rng));
+
+	if( argc > 2 ) {
+		Screen screenshot;
+		const bool loaded = decode(read_file(argv[2]), screenshot);
+		HOST_CHECK(loaded);
+		if( loaded ) {
+			check("screenshot", screenshot);
+		}
+	}
+
+	const auto screen = text_screen(rng);
+	host_test::benchmark("PNGWriter text capture, rows", n, height, [&]() {
+		encode(screen);
+	});
+
+	return host_test::result();
+}
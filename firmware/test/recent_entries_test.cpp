@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Checks RecentEntries against a std::list model of the same LRU policy:
+ * insert, move to front, evict the oldest when full, and the index's
+ * backward-shift delete (with keys forced to collide and to wrap around the
+ * end of the index). Then times on_packet() against the std::list the apps
+ * used before, at 64, 256 and 1024 entries.
+ *
+ * Usage: recent_entries_test [iterations]
+ */
+
+#include "recent_entries_lru.hpp"
+
+#include "host_test.hpp"
+
+#include <algorithm>
+#include <list>
+#include <vector>
+
+namespace {
+
+struct TestEntry {
+	using Key = uint32_t;
+
+	static int live;
+
+	Key k;
+	uint32_t hits { 0 };
+
+	TestEntry(const Key key) : k { key } { live++; }
+	~TestEntry() { live--; }
+
+	Key key() const { return k; }
+};
+
+int TestEntry::live = 0;
+
+/* Keys whose home slot is one of the last two of an index of 2^bits slots,
+ * so their probe runs collide and wrap around to slot 0.
+ */
+std::vector<uint32_t> colliding_keys(const size_t bits, const size_t count) {
+	std::vector<uint32_t> keys;
+	const uint32_t last = (1U << bits) - 1;
+	for(uint32_t k=1; keys.size()<count; k++) {
+		const auto home = recent_entries_hash(k) >> (32 - bits);
+		if( home >= last - 1 ) {
+			keys.push_back(k);
+		}
+	}
+	return keys;
+}
+
+template<size_t Capacity>
+class Model {
+public:
+	void on_packet(const uint32_t key) {
+		auto it = std::find(keys.begin(), keys.end(), key);
+		if( it != keys.end() ) {
+			keys.erase(it);
+		} else if( keys.size() == Capacity ) {
+			keys.pop_back();
+		}
+		keys.push_front(key);
+	}
+
+	bool contains(const uint32_t key) const {
+		return std::find(keys.begin(), keys.end(), key) != keys.end();
+	}
+
+	std::list<uint32_t> keys { };
+};
+
+template<size_t Capacity>
+bool same(const RecentEntries<TestEntry, Capacity>& entries, const Model<Capacity>& model) {
+	if( entries.size() != model.keys.size() ) {
+		return false;
+	}
+	if( TestEntry::live != static_cast<int>(model.keys.size()) ) {
+		return false;
+	}
+
+	auto m = model.keys.begin();
+	for(const auto& e : entries) {
+		if( e.key() != *m++ ) {
+			return false;
+		}
+	}
+
+	// Backward too, to check the prev links
+	auto r = model.keys.rbegin();
+	for(auto it = entries.end(); it != entries.begin(); ) {
+		--it;
+		if( it->key() != *r++ ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template<size_t Capacity, size_t IndexBits>
+void check(host_test::Xorshift32& rng) {
+	RecentEntries<TestEntry, Capacity> entries;
+	Model<Capacity> model;
+
+	HOST_CHECK(entries.empty());
+	HOST_CHECK(entries.find(1U) == entries.end());
+
+	// Half the keys pile up at the end of the index, half are spread out
+	auto keys = colliding_keys(IndexBits, Capacity);
+	for(size_t i=0; i<Capacity; i++) {
+		keys.push_back(rng());
+	}
+
+	size_t mismatches = 0;
+	for(size_t n=0; n<Capacity * 50; n++) {
+		const auto key = keys[rng() % keys.size()];
+		auto& e = entries.on_packet(key);
+		e.hits++;
+		model.on_packet(key);
+
+		if( (&entries.front() != &e) || !same(entries, model) ) {
+			mismatches++;
+		}
+	}
+	HOST_CHECK(mismatches == 0);
+
+	// Every key the model holds is found, every evicted one isn't
+	size_t lookup_errors = 0;
+	for(const auto key : keys) {
+		const auto it = entries.find(key);
+		if( (it != entries.end()) != model.contains(key) ) {
+			lookup_errors++;
+		}
+		if( (it != entries.end()) && (it->key() != key) ) {
+			lookup_errors++;
+		}
+	}
+	HOST_CHECK(lookup_errors == 0);
+
+	entries.clear();
+	HOST_CHECK(entries.empty());
+	HOST_CHECK(TestEntry::live == 0);
+	HOST_CHECK(entries.find(keys[0]) == entries.end());
+
+	// Usable again after clear()
+	entries.on_packet(keys[0]);
+	HOST_CHECK(entries.size() == 1);
+	HOST_CHECK(entries.find(keys[0]) != entries.end());
+	entries.clear();
+}
+
+struct BenchEntry {
+	using Key = uint32_t;
+
+	Key k;
+	uint32_t hits { 0 };
+
+	BenchEntry(const Key key) : k { key } { }
+
+	Key key() const { return k; }
+};
+
+/* What the apps did before: linear search, move to front, trim the back. */
+template<size_t Capacity>
+BenchEntry& list_on_packet(std::list<BenchEntry>& entries, const uint32_t key) {
+	auto it = std::find_if(entries.begin(), entries.end(), [key](const BenchEntry& e) { return e.key() == key; });
+	if( it != entries.end() ) {
+		entries.splice(entries.begin(), entries, it);
+	} else {
+		entries.emplace_front(key);
+		if( entries.size() > Capacity ) {
+			entries.pop_back();
+		}
+	}
+	return entries.front();
+}
+
+/* A working set 1.5x the capacity, so about a third of packets evict. */
+template<size_t Capacity>
+void bench(const char* const name_list, const char* const name_lru, const size_t iterations) {
+	host_test::Xorshift32 rng { 0xbeef };
+	std::vector<uint32_t> stream(4096);
+	for(auto& key : stream) {
+		key = rng() % (Capacity * 3 / 2);
+	}
+
+	std::list<BenchEntry> list;
+	host_test::benchmark(name_list, iterations, stream.size(), [&]() {
+		for(const auto key : stream) {
+			list_on_packet<Capacity>(list, key).hits++;
+		}
+	});
+
+	static RecentEntries<BenchEntry, Capacity> lru;
+	host_test::benchmark(name_lru, iterations, stream.size(), [&]() {
+		for(const auto key : stream) {
+			lru.on_packet(key).hits++;
+		}
+	});
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+	const auto n = host_test::iterations(argc, argv, 100);
+
+	host_test::Xorshift32 rng;
+	check<1, 7>(rng);
+	check<64, 7>(rng);
+	check<256, 9>(rng);
+	check<1024, 11>(rng);
+
+	bench<64>("std::list 64", "RecentEntries 64", n);
+	bench<256>("std::list 256", "RecentEntries 256", n);
+	bench<1024>("std::list 1024", "RecentEntries 1024", n / 4 + 1);
+
+	return host_test::result();
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Just enough of the ChibiOS/RT API for baseband code to compile and run
+ * single-threaded on the host. Events, locks and the system timer do
+ * nothing; the heap is malloc().
+ */
+
+#ifndef _CH_H_
+#define _CH_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+
+typedef uint32_t eventmask_t;
+typedef uint32_t systime_t;
+typedef int32_t msg_t;
+typedef int32_t tprio_t;
+
+struct Thread { };
+struct Mutex { };
+struct MemoryHeap { };
+
+#define EVENT_MASK(eid) ((eventmask_t)(1 << (eid)))
+#define NORMALPRIO 64
+#define MS2ST(msec) (msec)
+#define S2ST(sec) ((sec) * 1000)
+#define TRUE 1
+#define FALSE 0
+
+inline void chEvtSignal(Thread*, eventmask_t) { }
+inline void chEvtSignalI(Thread*, eventmask_t) { }
+inline eventmask_t chEvtWaitAny(eventmask_t mask) { return mask; }
+inline eventmask_t chEvtWaitAnyTimeout(eventmask_t mask, systime_t) { return mask; }
+inline eventmask_t chEvtGetAndClearEvents(eventmask_t mask) { return mask; }
+
+inline systime_t chTimeNow() { return 0; }
+inline Thread* chThdSelf() { return nullptr; }
+inline void chThdSleepMilliseconds(uint32_t) { }
+
+inline void chSysLock() { }
+inline void chSysUnlock() { }
+inline void chSysLockFromIsr() { }
+inline void chSysUnlockFromIsr() { }
+inline void chDbgPanic(const char*) { std::abort(); }
+
+inline void chMtxInit(Mutex*) { }
+inline void chMtxLock(Mutex*) { }
+inline Mutex* chMtxUnlock() { return nullptr; }
+
+inline void* chHeapAlloc(MemoryHeap*, size_t size) { return std::malloc(size); }
+inline void chHeapFree(void* p) { std::free(p); }
+
+#endif /* _CH_H_ */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Host stand-in for application/file.hpp: the part of File that writers
+ * and the frequency manager use, on top of stdio, plus FAT timestamps and
+ * directory scans from the host filesystem.
+ */
+
+#ifndef __FILE_H__
+#define __FILE_H__
+
+#include "optional.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <array>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <ctime>
+
+#include <sys/stat.h>
+
+class File {
+public:
+	using Size = uint64_t;
+
+	struct Error {
+		uint32_t code;
+	};
+
+	template<typename T>
+	struct Result {
+		bool ok;
+		T value_;
+
+		bool is_ok() const { return ok; }
+		bool is_error() const { return !ok; }
+		const T& value() const { return value_; }
+	};
+
+	File() { };
+	~File() {
+		if( f ) {
+			std::fclose(f);
+		}
+	}
+
+	File(const File&) = delete;
+	File& operator=(const File&) = delete;
+
+	Optional<Error> open(const std::filesystem::path& filename) {
+		return open_mode(filename, "rb");
+	}
+
+	Optional<Error> create(const std::filesystem::path& filename) {
+		return open_mode(filename, "wb");
+	}
+
+	Result<Size> read(void* const data, const Size bytes_to_read) {
+		const auto read = f ? std::fread(data, 1, bytes_to_read, f) : 0;
+		return { (f != nullptr) && !std::ferror(f), read };
+	}
+
+	Result<Size> write(const void* const data, const Size bytes_to_write) {
+		const auto written = f ? std::fwrite(data, 1, bytes_to_write, f) : 0;
+		return { written == bytes_to_write, written };
+	}
+
+	/* Returns the old position, like the FatFs version. */
+	Result<Size> seek(const uint64_t new_position) {
+		const long old_position = f ? std::ftell(f) : 0;
+		const bool ok = f && (std::fseek(f, new_position, SEEK_SET) == 0);
+		return { ok, static_cast<Size>(old_position) };
+	}
+
+	Size size() {
+		if( !f ) {
+			return 0;
+		}
+		const long position = std::ftell(f);
+		std::fseek(f, 0, SEEK_END);
+		const long end = std::ftell(f);
+		std::fseek(f, position, SEEK_SET);
+		return end;
+	}
+
+	template<size_t N>
+	Result<Size> write(const std::array<uint8_t, N>& data) {
+		return write(data.data(), N);
+	}
+
+	Optional<Error> write_line(const std::string& s) {
+		if( write(s.c_str(), s.size()).is_error() || write("\r\n", 2).is_error() ) {
+			return { Error { 1 } };
+		}
+		return { };
+	}
+
+private:
+	std::FILE* f { nullptr };
+
+	Optional<Error> open_mode(const std::filesystem::path& filename, const char* const mode) {
+		if( f ) {
+			std::fclose(f);
+		}
+		f = std::fopen(filename.string().c_str(), mode);
+		if( !f ) {
+			return { Error { 1 } };
+		}
+		return { };
+	}
+};
+
+struct FATTimestamp {
+	uint16_t FAT_date;
+	uint16_t FAT_time;
+};
+
+/* From the host's modification time, as FatFs records it. */
+inline FATTimestamp file_created_date(const std::filesystem::path& file_path) {
+	struct stat st { };
+	if( stat(file_path.string().c_str(), &st) != 0 ) {
+		return { 0, 0 };
+	}
+	std::tm t { };
+	localtime_r(&st.st_mtime, &t);
+	return {
+		static_cast<uint16_t>(((t.tm_year - 80) << 9) | ((t.tm_mon + 1) << 5) | t.tm_mday),
+		static_cast<uint16_t>((t.tm_hour << 11) | (t.tm_min << 5) | (t.tm_sec / 2))
+	};
+}
+
+/* Regular files in directory whose name ends as "*<suffix>" says. */
+inline std::vector<std::filesystem::path> scan_root_files(const std::filesystem::path& directory, const std::filesystem::path& extension) {
+	const auto suffix = extension.string().substr(1);
+	std::vector<std::filesystem::path> file_list { };
+	std::error_code ec;
+	for(const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+		const auto name = entry.path().filename().string();
+		if( entry.is_regular_file() && (name.size() >= suffix.size()) &&
+			(name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) ) {
+			file_list.push_back(entry.path());
+		}
+	}
+	return file_list;
+}
+
+#endif/*__FILE_H__*/
@@ -18,24 +18,97 @@
 # Boston, MA 02110-1301, USA.
 #
 
+# Builds ADSB/airlines.db from ADSB/airlines.txt, and optionally ADSB/icao24.db
+# from an aircraft database CSV (OpenSky Network's aircraftDatabase.csv, with
+# icao24, registration, typecode and model columns):
+#
+#   generate_airlines.db.py [aircraftDatabase.csv]
+#
+# Both use the sorted fixed-stride format read by application/database.cpp:
+#
+# 0x0000  Header
+#         char[4]  magic "PPDB"
+#         u16      version (1)
+#         u16      record size, a power of two up to 128
+#         u16      key size
+#         u16      index count
+#         u32      record count
+#         u32      records per block
+#         u32      records offset
+#         u32[2]   reserved
+# 0x0020  Index: first key of each block of records
+# records offset (multiple of 512)
+#         Records sorted by key, key first
+#
+# All values are little-endian.
+
 import sys
+import csv
 import struct
 
-outfile = open("airlines.db", "w")
-
-lines = [line.rstrip('\n') for line in open('../../sdcard/ADSB/airlines.txt', 'r')]
-n = 0
-
-for line in lines:
-	if line:
-		nd = line.find('(')
-		if (nd == -1):
-			nd = None
-		else:
-			nd -= 1
-		nline = line[4:7] + '\0' + line[10:nd] + '\0'
-		print nline
-		b = bytearray(nline)
-		pad_len = 32 - len(b)
-		b += "\0" * pad_len
-		outfile.write(b)
\ No newline at end of file
+SECTOR_SIZE = 512
+INDEX_MAX = 256
+
+def field(s, size):
+	# Zero padded, always zero terminated
+	b = s.encode('ascii', 'replace')[:size - 1]
+	return b + b'\0' * (size - len(b))
+
+def write_db(filename, records, key_size, record_size):
+	records = sorted(records)
+	count = len(records)
+	index_count = min(INDEX_MAX, count)
+	per_block = (count + index_count - 1) // index_count if count else 0
+	index_count = (count + per_block - 1) // per_block if count else 0
+	
+	index = b''.join(records[n * per_block][:key_size] for n in range(index_count))
+	offset = 32 + len(index)
+	offset = (offset + SECTOR_SIZE - 1) // SECTOR_SIZE * SECTOR_SIZE
+	
+	header = struct.pack('<4sHHHHIII8x', b'PPDB', 1, record_size, key_size, index_count, count, per_block, offset)
+	assert all(len(r) == record_size for r in records)
+	
+	with open(filename, 'wb') as outfile:
+		outfile.write(header + index)
+		outfile.write(b'\0' * (offset - len(header) - len(index)))
+		outfile.write(b''.join(records))
+	print('%s: %d records' % (filename, count))
+
+# Airlines: 4-byte code, 40-byte name, 20-byte country
+airlines = { }
+for line in open('../../sdcard/ADSB/airlines.txt', 'r', encoding='utf-8-sig'):
+	line = line.strip()
+	if len(line) < 5:
+		continue
+	code = line[0:3]
+	if (line[3:5] != ', ') or not code.isalnum():
+		continue
+	nd = line.rfind('(')
+	if nd == -1:
+		name = line[5:]
+		country = ''
+	else:
+		name = line[5:nd]
+		country = line[nd + 1:line.rfind(')')]
+	name = name.strip().strip('"')
+	if code not in airlines:
+		airlines[code] = field(code, 4) + field(name, 40) + field(country, 20)
+
+write_db('../../sdcard/ADSB/airlines.db', airlines.values(), 4, 64)
+
+# Aircraft: 4-byte big-endian ICAO24 address, 12-byte registration, 16-byte type
+if len(sys.argv) > 1:
+	aircraft = { }
+	with open(sys.argv[1], 'r', encoding='utf-8', errors='replace') as infile:
+		for row in csv.DictReader(infile):
+			try:
+				address = int(row['icao24'], 16)
+			except ValueError:
+				continue
+			registration = row.get('registration', '').strip()
+			typecode = row.get('typecode', '').strip() or row.get('model', '').strip()
+			if (not registration and not typecode) or (address in aircraft):
+				continue
+			aircraft[address] = struct.pack('>I', address) + field(registration, 12) + field(typecode, 16)
+	
+	write_db('../../sdcard/ADSB/icao24.db', aircraft.values(), 4, 32)
@@ -18,33 +18,72 @@
 # Boston, MA 02110-1301, USA.
 #
 
+# Makes the tiled, multi-zoom ADSB/world_map.bin from ADSB/world_map.jpg.
+# See application/ui/ui_geomap.hpp for the format.
+
 from __future__ import print_function
 import sys
 import struct
 from PIL import Image
 
-outfile = open('../../sdcard/world_map.bin', 'wb')
+TILE_SIZE = 16
+LEVELS_MAX = 8
+SCREEN_WIDTH = 240
+SECTOR_SIZE = 512
+
+def sector_pad(data):
+	# Zero-fill up to the next sector, so that tiles never straddle sectors
+	return data + b'\0' * (-len(data) % SECTOR_SIZE)
+
+def rgb565(im):
+	# RRRRRGGGGGGBBBBB, little-endian
+	out = bytearray(im.size[0] * im.size[1] * 2)
+	i = 0
+	for r, g, b in im.getdata():
+		pixel_lcd = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+		out[i] = pixel_lcd & 0xFF
+		out[i + 1] = pixel_lcd >> 8
+		i += 2
+	return bytes(out)
+
+def tiles(im):
+	tiles_x = (im.size[0] + TILE_SIZE - 1) // TILE_SIZE
+	tiles_y = (im.size[1] + TILE_SIZE - 1) // TILE_SIZE
+	# Pad with black to whole tiles
+	padded = Image.new('RGB', (tiles_x * TILE_SIZE, tiles_y * TILE_SIZE))
+	padded.paste(im, (0, 0))
+	data = []
+	for ty in range(0, tiles_y):
+		for tx in range(0, tiles_x):
+			box = (tx * TILE_SIZE, ty * TILE_SIZE, (tx + 1) * TILE_SIZE, (ty + 1) * TILE_SIZE)
+			data.append(rgb565(padded.crop(box)))
+		print(str(ty) + '/' + str(tiles_y) + '\r', end="")
+	print()
+	return b''.join(data)
 
 # Allow for bigger images
 Image.MAX_IMAGE_PIXELS = None
-im = Image.open("../../sdcard/ADSB/world_map.jpg")
-pix = im.load()
-
-outfile.write(struct.pack('H', im.size[0]))
-outfile.write(struct.pack('H', im.size[1]))
-
-for y in range (0, im.size[1]):
-	line = ''
-	for x in range (0, im.size[0]):
-		# RRRRRGGGGGGBBBBB
-		pixel_lcd = (pix[x, y][0] >> 3) << 11
-		pixel_lcd |= (pix[x, y][1] >> 2) << 5
-		pixel_lcd |= (pix[x, y][2] >> 3)
-		#         RRRGGGBB to
-		# RRR00GGG000BB000
-		# pixel_lcd = (pix[x, y][0] >> 5) << 5
-		# pixel_lcd |= (pix[x, y][1] >> 5) << 2
-		# pixel_lcd |= (pix[x, y][2] >> 6)
-		line += struct.pack('H', pixel_lcd)
-	outfile.write(line)
-	print(str(y) + '/' + str(im.size[1]) + '\r', end="")
+im = Image.open("../../sdcard/ADSB/world_map.jpg").convert('RGB')
+
+# Halve until the whole world fits the screen width
+levels = [ im ]
+while (len(levels) < LEVELS_MAX) and (levels[-1].size[0] // 2 >= SCREEN_WIDTH):
+	prev = levels[-1]
+	levels.append(prev.resize((prev.size[0] // 2, prev.size[1] // 2), Image.LANCZOS))
+
+header = struct.pack('<4sHHB7x', b'PPMT', 1, TILE_SIZE, len(levels))
+offset = len(sector_pad(header + (b'\0' * 8 * len(levels))))
+
+table = b''
+data = []
+for level in levels:
+	print('Level ' + str(level.size[0]) + 'x' + str(level.size[1]))
+	table += struct.pack('<HHI', level.size[0], level.size[1], offset)
+	level_data = sector_pad(tiles(level))
+	data.append(level_data)
+	offset += len(level_data)
+
+with open('../../sdcard/ADSB/world_map.bin', 'wb') as outfile:
+	outfile.write(sector_pad(header + table))
+	for level_data in data:
+		outfile.write(level_data)
@@ -27,9 +27,14 @@ import struct
 usage_message = """
 PortaPack image chunk writer
 
-Usage: <command> <input_binary> <four-characer tag> <output_tagged_binary> [<chunk max size>]
+Usage: <command> <input_binary> <four-characer tag> <output_tagged_binary> [<chunk max size>] [--compress]
+
+With --compress, the image is stored as an LZ4 block, which the M0
+decompresses into M4 RAM when the image is loaded.
 """
 
+chunk_compressed_flag = 0x80000000
+
 def read_image(path):
 	f = open(path, 'rb')
 	data = f.read()
@@ -41,17 +46,100 @@ def write_image(data, path):
 	f.write(data)
 	f.close()
 
+def lz4_write_length(output, length):
+	while length >= 255:
+		output.append(255)
+		length -= 255
+	output.append(length)
+
+def lz4_write_sequence(output, literals, offset, match_length):
+	literal_token = min(len(literals), 15)
+	match_token = 0 if offset == 0 else min(match_length - 4, 15)
+	output.append((literal_token << 4) | match_token)
+	if literal_token == 15:
+		lz4_write_length(output, len(literals) - 15)
+	output += literals
+	if offset != 0:
+		output += struct.pack('<H', offset)
+		if match_token == 15:
+			lz4_write_length(output, match_length - 4 - 15)
+
+def lz4_compress(data):
+	""" Greedy LZ4 block compressor. Follows the format's end-of-block rules:
+	the last match starts at least 12 bytes and ends at least 5 bytes before
+	the end of the input, so the block always finishes with literals.
+	"""
+	data = bytearray(data)
+	output = bytearray()
+	match_start_limit = len(data) - 12
+	match_end_limit = len(data) - 5
+	table = {}
+	anchor = 0
+	i = 0
+	while i < match_start_limit:
+		key = data[i] | (data[i + 1] << 8) | (data[i + 2] << 16) | (data[i + 3] << 24)
+		candidate = table.get(key)
+		table[key] = i
+		if candidate is None or (i - candidate) > 65535:
+			i += 1
+			continue
+
+		match_length = 4
+		while i + match_length < match_end_limit and data[candidate + match_length] == data[i + match_length]:
+			match_length += 1
+
+		lz4_write_sequence(output, data[anchor:i], i - candidate, match_length)
+		i += match_length
+		anchor = i
+
+	lz4_write_sequence(output, data[anchor:], 0, 0)
+	return output
+
+def lz4_decompress(data):
+	data = bytearray(data)
+	output = bytearray()
+	i = 0
+	while i < len(data):
+		token = data[i]
+		i += 1
+		literal_length = token >> 4
+		if literal_length == 15:
+			while True:
+				literal_length += data[i]
+				i += 1
+				if data[i - 1] != 255:
+					break
+		output += data[i:i + literal_length]
+		i += literal_length
+		if i == len(data):
+			break
+		offset = data[i] | (data[i + 1] << 8)
+		i += 2
+		match_length = token & 15
+		if match_length == 15:
+			while True:
+				match_length += data[i]
+				i += 1
+				if data[i - 1] != 255:
+					break
+		for n in range(match_length + 4):
+			output.append(output[-offset])
+	return output
+
+args = [arg for arg in sys.argv[1:] if arg != '--compress']
+compress = len(args) != len(sys.argv) - 1
+
 input_image_max_length = 32768
-if len(sys.argv) in (4, 5):
-	input_image = read_image(sys.argv[1])
-	tag = tuple(map(ord, sys.argv[2]))
-	output_path = sys.argv[3]
-	if len(sys.argv) == 5:
-		input_image_max_length = int(sys.argv[4])
-elif len(sys.argv) == 2:
+if len(args) in (3, 4):
+	input_image = read_image(args[0])
+	tag = tuple(map(ord, args[1]))
+	output_path = args[2]
+	if len(args) == 4:
+		input_image_max_length = int(args[3])
+elif len(args) == 1 and not compress:
 	input_image = bytearray()
 	tag = (0, 0, 0, 0)
-	output_path = sys.argv[1]
+	output_path = args[0]
 else:
 	print(usage_message)
 	sys.exit(-1)
@@ -65,8 +153,21 @@ if len(input_image) > input_image_max_length:
 if (len(input_image) & 3) != 0:
 	raise RuntimeError('image size of %d is not multiple of four' % (len(input_image,)))
 
+chunk_data = bytearray(input_image)
+chunk_length = len(chunk_data)
+if compress:
+	compressed = lz4_compress(input_image)
+	if lz4_decompress(compressed) != bytearray(input_image):
+		raise RuntimeError('compressed image does not round-trip')
+	compressed_data = struct.pack('<II', len(input_image), len(compressed)) + compressed
+	compressed_data += bytearray((4 - len(compressed_data)) & 3)
+	# Incompressible images are stored as-is.
+	if len(compressed_data) < len(chunk_data):
+		chunk_data = compressed_data
+		chunk_length = len(chunk_data) | chunk_compressed_flag
+
 output_image = bytearray()
-output_image += struct.pack('<4BI', tag[0], tag[1], tag[2], tag[3], len(input_image))
-output_image += input_image
+output_image += struct.pack('<4BI', tag[0], tag[1], tag[2], tag[3], chunk_length)
+output_image += chunk_data
 
 write_image(output_image, output_path)